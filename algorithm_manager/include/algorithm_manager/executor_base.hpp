@@ -15,8 +15,14 @@
 #ifndef ALGORITHM_MANAGER__EXECUTOR_BASE_HPP_
 #define ALGORITHM_MANAGER__EXECUTOR_BASE_HPP_
 
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <vector>
 #include "rclcpp/rclcpp.hpp"
@@ -43,6 +49,7 @@
 #include "nav2_util/lifecycle_service_client.hpp"
 #include "behavior_manager/behavior_manager.hpp"
 #include "protocol/msg/bms_status.hpp"
+#include "algorithm_manager/task_graph.hpp"
 
 using namespace std::chrono_literals;   // NOLINT
 
@@ -128,6 +135,30 @@ public:
   {
     std::vector<std::string> nav2_lifecycle_indexs;
     std::vector<std::string> lifecycle_indexs;
+    // For each lifecycle node, the nodes that have to be active before it
+    std::unordered_map<std::string, std::vector<std::string>> lifecycle_deps;
+    // Keep the nodes configured (INACTIVE) instead of cleaning them up
+    bool warm_standby{false};
+  };
+
+  struct StandbyNode
+  {
+    int memory_mb;
+    std::chrono::steady_clock::time_point since;
+  };
+
+  // [standby] section of Task.toml
+  struct StandbyConfig
+  {
+    int budget_mb{0};
+    int default_node_mb{64};
+    std::map<std::string, int> node_mb;
+
+    int NodeMemoryMB(const std::string & name) const
+    {
+      auto memory = node_mb.find(name);
+      return memory != node_mb.end() ? memory->second : default_node_mb;
+    }
   };
 
   struct LifecycleNodeRef
@@ -171,6 +202,10 @@ public:
       FATAL("Toml format error");
       return false;
     }
+    {
+      std::lock_guard<std::mutex> lock(standby_mutex_);
+      ParseStandbyConfig(tasks, standby_config_);
+    }
     toml::value values;
     cyberdog::common::CyberdogToml::Get(tasks, "task", values);
     for (size_t i = 0; i < values.size(); i++) {
@@ -180,6 +215,8 @@ public:
       GET_TOML_VALUE(value, "TaskName", task_name);
       GET_TOML_VALUE(value, "DepsNav2LifecycleNodes", lifecycle_ref.nav2_lifecycle_indexs);
       GET_TOML_VALUE(value, "DepsLifecycleNodes", lifecycle_ref.lifecycle_indexs);
+      SetLifecycleOrder(task_name, value, lifecycle_ref);
+      cyberdog::common::CyberdogToml::Get(value, "WarmStandby", lifecycle_ref.warm_standby);
       task_map_.emplace(task_name, lifecycle_ref);
     }
     return true;
@@ -195,58 +232,187 @@ protected:
           index,
           std::make_shared<Nav2LifecyleMgrClient>(index));
       }
-      auto status = nav2_lifecycle_clients.find(index)->second->is_active(
-        std::chrono::nanoseconds(get_lifecycle_timeout_ * 1000 * 1000 * 1000));
-      if (status == nav2_lifecycle_manager::SystemStatus::TIMEOUT) {
-        ERROR("Failed to get %s state", index.c_str());
-        return false;
-      }
-      switch (mode) {
-        case Nav2LifecycleMode::kPause:
-          {
-            if (status == nav2_lifecycle_manager::SystemStatus::INACTIVE) {
-              continue;
-            }
-            if (!nav2_lifecycle_clients.find(index)->second->pause()) {
-              ERROR("Failed to Pause %s", index.c_str());
-              return false;
-            }
-            INFO("Success to Pause %s", index.c_str());
+    }
+    // The managers are independent of each other, so operate them all at once
+    std::vector<std::future<bool>> results;
+    for (auto & index : indexs) {
+      results.push_back(
+        std::async(
+          std::launch::async, [this, index, mode]() {
+            return OperateNav2LifecycleManager(index, mode);
+          }));
+    }
+    bool success = true;
+    for (auto & result : results) {
+      success = result.get() && success;
+    }
+    return success;
+  }
+
+  bool OperateNav2LifecycleManager(const std::string & index, Nav2LifecycleMode mode)
+  {
+    auto client = nav2_lifecycle_clients.at(index);
+    auto status = client->is_active(
+      std::chrono::nanoseconds(get_lifecycle_timeout_ * 1000 * 1000 * 1000));
+    if (status == nav2_lifecycle_manager::SystemStatus::TIMEOUT) {
+      ERROR("Failed to get %s state", index.c_str());
+      return false;
+    }
+    switch (mode) {
+      case Nav2LifecycleMode::kPause:
+        {
+          if (status == nav2_lifecycle_manager::SystemStatus::INACTIVE) {
+            break;
+          }
+          if (!client->pause()) {
+            ERROR("Failed to Pause %s", index.c_str());
+            return false;
           }
-          break;
-
-        case Nav2LifecycleMode::kStartUp:
-          {
-            if (status == nav2_lifecycle_manager::SystemStatus::ACTIVE) {
-              continue;
-            }
-            if (!nav2_lifecycle_clients.find(index)->second->startup()) {
-              ERROR("Failed to Startup %s", index.c_str());
-              return false;
-            }
-            INFO("Success to Startup %s", index.c_str());
+          INFO("Success to Pause %s", index.c_str());
+        }
+        break;
+
+      case Nav2LifecycleMode::kStartUp:
+        {
+          if (status == nav2_lifecycle_manager::SystemStatus::ACTIVE) {
+            break;
+          }
+          if (!client->startup()) {
+            ERROR("Failed to Startup %s", index.c_str());
+            return false;
+          }
+          INFO("Success to Startup %s", index.c_str());
+        }
+        break;
+
+      case Nav2LifecycleMode::kResume:
+        {
+          if (status == nav2_lifecycle_manager::SystemStatus::ACTIVE) {
+            break;
           }
-          break;
-
-        case Nav2LifecycleMode::kResume:
-          {
-            if (status == nav2_lifecycle_manager::SystemStatus::ACTIVE) {
-              continue;
-            }
-            if (!nav2_lifecycle_clients.find(index)->second->resume()) {
-              ERROR("Failed to Resume %s", index.c_str());
-              return false;
-            }
-            INFO("Success to Resume %s", index.c_str());
+          if (!client->resume()) {
+            ERROR("Failed to Resume %s", index.c_str());
+            return false;
+          }
+          INFO("Success to Resume %s", index.c_str());
+        }
+        break;
+
+      default:
+        break;
+    }
+    return true;
+  }
+
+  /**
+   * @brief
+   * 按任务配置中可选的DepsLifecycleOrder设置lifecycle_deps.
+   * 未配置或配置无效时, 节点按DepsLifecycleNodes的顺序依次激活
+   *
+   */
+  static void SetLifecycleOrder(
+    const std::string & task_name, const toml::value & task,
+    LifecycleNodeIndexs & lifecycle_ref)
+  {
+    std::vector<std::string> order;
+    if (task.is_table() && task.as_table().count("DepsLifecycleOrder") != 0) {
+      if (cyberdog::common::CyberdogToml::Get(task, "DepsLifecycleOrder", order) &&
+        ParseLifecycleOrder(task_name, order, lifecycle_ref))
+      {
+        return;
+      }
+      WARN(
+        "Task [%s] has an invalid DepsLifecycleOrder, its lifecycles will be "
+        "activated one after the other", task_name.c_str());
+    }
+    lifecycle_ref.lifecycle_deps.clear();
+    for (size_t j = 1; j < lifecycle_ref.lifecycle_indexs.size(); j++) {
+      lifecycle_ref.lifecycle_deps[lifecycle_ref.lifecycle_indexs[j]] =
+      {lifecycle_ref.lifecycle_indexs[j - 1]};
+    }
+  }
+
+  /**
+   * @brief
+   * 解析任务配置中的DepsLifecycleOrder, 每项形如 "node: dep1, dep2",
+   * 表示node需在dep1、dep2激活之后再激活
+   *
+   * @return 存在格式错误、未知节点或循环依赖时返回false, 并记录出错的项
+   */
+  static bool ParseLifecycleOrder(
+    const std::string & task_name, const std::vector<std::string> & order,
+    LifecycleNodeIndexs & lifecycle_ref)
+  {
+    const std::unordered_set<std::string> known(
+      lifecycle_ref.lifecycle_indexs.begin(), lifecycle_ref.lifecycle_indexs.end());
+    auto trim = [](const std::string & str) {
+        const auto begin = str.find_first_not_of(" \t");
+        if (begin == std::string::npos) {
+          return std::string();
+        }
+        return str.substr(begin, str.find_last_not_of(" \t") - begin + 1);
+      };
+    std::unordered_map<std::string, std::vector<std::string>> deps;
+    for (auto & entry : order) {
+      const auto colon = entry.find(':');
+      const std::string name = trim(entry.substr(0, colon));
+      if (colon == std::string::npos) {
+        ERROR(
+          "Task [%s] DepsLifecycleOrder entry \"%s\" is not of the form \"node: deps\"",
+          task_name.c_str(), entry.c_str());
+        return false;
+      }
+      if (known.count(name) == 0) {
+        ERROR(
+          "Task [%s] DepsLifecycleOrder entry \"%s\": [%s] is not in DepsLifecycleNodes",
+          task_name.c_str(), entry.c_str(), name.c_str());
+        return false;
+      }
+      std::string list = entry.substr(colon + 1);
+      size_t begin = 0;
+      while (begin <= list.size()) {
+        size_t end = std::min(list.find(',', begin), list.size());
+        const std::string dep = trim(list.substr(begin, end - begin));
+        if (!dep.empty()) {
+          if (known.count(dep) == 0) {
+            ERROR(
+              "Task [%s] DepsLifecycleOrder entry \"%s\": [%s] is not in DepsLifecycleNodes",
+              task_name.c_str(), entry.c_str(), dep.c_str());
+            return false;
           }
-          break;
+          deps[name].push_back(dep);
+        }
+        begin = end + 1;
+      }
+    }
 
-        default:
-          break;
+    // A cycle would keep its nodes waiting until the timeout
+    std::unordered_map<std::string, int> mark;  // 0 unvisited, 1 visiting, 2 done
+    std::function<bool(const std::string &)> visit = [&](const std::string & name) {
+        if (mark[name] != 0) {
+          return mark[name] == 2;
+        }
+        mark[name] = 1;
+        for (auto & dep : deps[name]) {
+          if (!visit(dep)) {
+            ERROR(
+              "Task [%s] DepsLifecycleOrder has a cycle through [%s]",
+              task_name.c_str(), name.c_str());
+            return false;
+          }
+        }
+        mark[name] = 2;
+        return true;
+      };
+    for (auto & name : lifecycle_ref.lifecycle_indexs) {
+      if (!visit(name)) {
+        return false;
       }
     }
+    lifecycle_ref.lifecycle_deps = deps;
     return true;
   }
+
   std::vector<LifecycleNodeRef>
   GetDepsLifecycleNodes(const std::string & task_name)
   {
@@ -264,108 +430,307 @@ protected:
     return clients;
   }
 
+  /**
+   * @brief
+   * 并发激活任务依赖的生命周期节点,
+   * 仅按DepsLifecycleOrder中声明的顺序等待,
+   * 所有节点共用timeout(ms)作为总超时
+   *
+   * @return 所有节点均激活成功时返回true
+   */
   bool ActivateDepsLifecycleNodes(const std::string & task_name, int timeout = 20000)
   {
     lifecycle_activated_.clear();
-    for (auto client : GetDepsLifecycleNodes(task_name)) {
-      INFO("Trying to launch [%s]", client.name.c_str());
-      int lifecycle_query = 10;
-      if (!client.lifecycle_client->service_exist(std::chrono::seconds(lifecycle_query))) {
-        ERROR("Lifecycle [%s] not exist in %ds", client.name.c_str(), lifecycle_query);
-        return false;
-      }
-      bool is_timeout = false;
-      auto state = client.lifecycle_client->get_state(is_timeout, timeout);
-      if (is_timeout) {
-        ERROR("Cannot get state of [%s]", client.name.c_str());
-        return false;
-      }
-      if (state == lifecycle_msgs::msg::State::PRIMARY_STATE_ACTIVE) {
-        INFO("Lifecycle [%s] already be active", client.name.c_str());
-        lifecycle_activated_.push_back(client);
-        continue;
+    lifecycle_activated_task_ = task_name;
+    lifecycle_activated_deps_ = task_map_.at(task_name).lifecycle_deps;
+    auto clients = GetDepsLifecycleNodes(task_name);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    auto results = RunLifecycleGraph(
+      clients, task_map_.at(task_name).lifecycle_deps,
+      [this, deadline](const LifecycleNodeRef & client) {
+        return ActivateLifecycleNode(client, deadline);
+      });
+    bool success = true;
+    for (size_t i = 0; i < clients.size(); i++) {
+      if (results[i]) {
+        lifecycle_activated_.push_back(clients[i]);
       } else {
-        // INFO("%s 1st: %d", client.name.c_str(), client.lifecycle_client->get_state());
-        if (state == lifecycle_msgs::msg::State::PRIMARY_STATE_UNCONFIGURED) {
-          if (!client.lifecycle_client->change_state(
-              lifecycle_msgs::msg::Transition::
-              TRANSITION_CONFIGURE, timeout))
-          {
-            WARN("Get error when configuring [%s], try to active", client.name.c_str());
-          }
-        }
-        // INFO("%s 2nd: %d", client.name.c_str(), client.lifecycle_client->get_state());
-        if (!client.lifecycle_client->change_state(
-            lifecycle_msgs::msg::Transition::
-            TRANSITION_ACTIVATE, timeout))
-        {
-          ERROR("Get error when activing [%s] with state: %d", client.name.c_str(), state);
-          return false;
-        }
-        lifecycle_activated_.push_back(client);
-        INFO("Success to active [%s]", client.name.c_str());
+        success = false;
       }
     }
-    return true;
+    return success;
   }
 
-  bool DeactivateDepsLifecycleNodes(const std::string & task_name, int timeout = 20000)
+  /**
+   * @brief 去激活任务依赖的所有节点, 包括激活失败的节点
+   */
+  bool DeactivateDepsLifecycleNodes(
+    const std::string & task_name, int timeout = 20000, bool cleanup = false,
+    bool force_cleanup = false)
   {
     lifecycle_activated_ = GetDepsLifecycleNodes(task_name);
-    return DeactivateDepsLifecycleNodes(timeout);
+    lifecycle_activated_task_ = task_name;
+    lifecycle_activated_deps_ = task_map_.at(task_name).lifecycle_deps;
+    return DeactivateDepsLifecycleNodes(timeout, cleanup, force_cleanup);
+  }
+
+  /**
+   * @brief
+   * 并发去激活已激活的节点, 依赖某节点的节点先于该节点去激活.
+   * 任务配置了WarmStandby时, cleanup只去激活节点并使其保持配置状态待命,
+   * 待命节点估算内存超出MemoryBudgetMB时, 按最久未使用的顺序清理.
+   * 启动失败等异常路径应传入force_cleanup, 忽略WarmStandby清理所有节点
+   *
+   */
+  bool DeactivateDepsLifecycleNodes(
+    int timeout = 20000, bool cleanup = false, bool force_cleanup = false)
+  {
+    cleanup = cleanup || force_cleanup;
+    auto task = task_map_.find(lifecycle_activated_task_);
+    const bool standby = cleanup && !force_cleanup && task != task_map_.end() &&
+      task->second.warm_standby;
+    // Reverse the activation order: a node goes down after the nodes that need it
+    std::unordered_map<std::string, std::vector<std::string>> dependents;
+    for (auto & deps : lifecycle_activated_deps_) {
+      for (auto & dep : deps.second) {
+        dependents[dep].push_back(deps.first);
+      }
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    RunLifecycleGraph(
+      lifecycle_activated_, dependents,
+      [this, deadline, cleanup, standby](const LifecycleNodeRef & client) {
+        DeactivateLifecycleNode(client, deadline, cleanup, standby);
+        // Failing to deactivate a node does not keep the others up
+        return true;
+      });
+    if (standby) {
+      EvictStandbyNodes(deadline);
+    }
+    return true;
+  }
+
+  /**
+   * @brief 读取[standby]配置: 内存预算与各节点的估算内存, 未配置的项保持默认值
+   */
+  static void ParseStandbyConfig(const toml::value & tasks, StandbyConfig & config)
+  {
+    toml::value standby;
+    if (cyberdog::common::CyberdogToml::Get(tasks, "standby", standby)) {
+      cyberdog::common::CyberdogToml::Get(standby, "MemoryBudgetMB", config.budget_mb);
+      cyberdog::common::CyberdogToml::Get(
+        standby, "DefaultNodeMemoryMB", config.default_node_mb);
+      cyberdog::common::CyberdogToml::Get(standby, "NodeMemoryMB", config.node_mb);
+    }
+  }
+
+  /**
+   * @brief 待命节点估算内存超出budget_mb时需清理的节点, 按最久未使用在前
+   */
+  static std::vector<std::string> SelectStandbyEvictions(
+    const std::unordered_map<std::string, StandbyNode> & nodes, int budget_mb)
+  {
+    std::vector<std::pair<std::string, StandbyNode>> oldest_first(nodes.begin(), nodes.end());
+    std::sort(
+      oldest_first.begin(), oldest_first.end(),
+      [](const auto & a, const auto & b) {
+        return a.second.since < b.second.since ||
+        (a.second.since == b.second.since && a.first < b.first);
+      });
+    int total_mb = 0;
+    for (auto & node : oldest_first) {
+      total_mb += node.second.memory_mb;
+    }
+    std::vector<std::string> evictions;
+    for (auto & node : oldest_first) {
+      if (total_mb <= budget_mb) {
+        break;
+      }
+      total_mb -= node.second.memory_mb;
+      evictions.push_back(node.first);
+    }
+    return evictions;
   }
 
-  bool DeactivateDepsLifecycleNodes(int timeout = 20000, bool cleanup = false)
+  /**
+   * @brief 待命节点的估算内存超出预算时, 清理最久未使用的待命节点
+   */
+  void EvictStandbyNodes(const std::chrono::steady_clock::time_point & deadline)
   {
-    // for (auto client : lifecycle_activated_) {
-    for (auto lifecycle_activated_rtr = lifecycle_activated_.rbegin();
-      lifecycle_activated_rtr != lifecycle_activated_.rend(); lifecycle_activated_rtr++)
+    std::vector<std::string> evictions;
     {
-      auto client = *lifecycle_activated_rtr;
-      int lifecycle_query = 10;
-      if (!client.lifecycle_client->service_exist(std::chrono::seconds(lifecycle_query))) {
-        WARN(
-          "Lifecycle [%s] not exist in %ds, will not deactive it",
-          client.name.c_str(), lifecycle_query);
-        continue;
+      std::lock_guard<std::mutex> lock(standby_mutex_);
+      evictions = SelectStandbyEvictions(standby_nodes_, standby_config_.budget_mb);
+      for (auto & name : evictions) {
+        standby_nodes_.erase(name);
       }
-      bool is_timeout = false;
-      auto state = client.lifecycle_client->get_state(is_timeout, timeout);
-      if (is_timeout) {
-        ERROR("Cannot get state of [%s]", client.name.c_str());
+    }
+    for (auto & name : evictions) {
+      auto client = lifecycle_clients.find(name);
+      if (client == lifecycle_clients.end()) {
         continue;
       }
-      if (state == lifecycle_msgs::msg::State::PRIMARY_STATE_UNCONFIGURED) {
-        INFO("Lifecycle [%s] is unconfigured, no need to deactivate", client.name.c_str());
-        continue;
-      } else if (state == lifecycle_msgs::msg::State::PRIMARY_STATE_INACTIVE) {
-        INFO("Lifecycle [%s] already be inactive", client.name.c_str());
-        continue;
-      } else {
-        if (!client.lifecycle_client->change_state(
-            lifecycle_msgs::msg::Transition::TRANSITION_DEACTIVATE, timeout))
+      // Another task may have taken the node over in the meantime
+      bool is_timeout = false;
+      auto state = client->second->get_state(is_timeout, RemainingMs(deadline));
+      if (!is_timeout && state == lifecycle_msgs::msg::State::PRIMARY_STATE_INACTIVE) {
+        if (client->second->change_state(
+            lifecycle_msgs::msg::Transition::TRANSITION_CLEANUP, RemainingMs(deadline)))
         {
-          ERROR("Get error when deactive %s", client.name.c_str());
+          INFO("Evict standby lifecycle [%s]", name.c_str());
         } else {
-          INFO("Success to deactive [%s]", client.name.c_str());
+          ERROR("Get error when cleanup standby %s", name.c_str());
         }
-        if (cleanup) {
-          if (client.name == std::string("vision_manager")) {
-            continue;
-          }
-          if (!client.lifecycle_client->change_state(
-              lifecycle_msgs::msg::Transition::TRANSITION_CLEANUP, timeout))
-          {
-            ERROR("Get error when cleanup %s", client.name.c_str());
-          } else {
-            INFO("Success to cleanup [%s]", client.name.c_str());
+      }
+    }
+  }
+
+  /**
+   * @brief
+   * 对每个节点并发执行operation,
+   * 节点仅等待prerequisites中列出的、同在nodes中的节点完成.
+   * 某节点的前置节点失败时, 该节点不再执行, 结果为false
+   *
+   * @return 与nodes一一对应的执行结果
+   */
+  std::vector<bool> RunLifecycleGraph(
+    const std::vector<LifecycleNodeRef> & nodes,
+    const std::unordered_map<std::string, std::vector<std::string>> & prerequisites,
+    std::function<bool(const LifecycleNodeRef &)> operation)
+  {
+    std::unordered_set<std::string> names;
+    for (auto & node : nodes) {
+      names.insert(node.name);
+    }
+    TaskGraph graph;
+    for (auto & node : nodes) {
+      std::vector<std::string> after;
+      auto it = prerequisites.find(node.name);
+      if (it != prerequisites.end()) {
+        for (auto & prerequisite : it->second) {
+          if (names.count(prerequisite) != 0) {
+            after.push_back(prerequisite);
           }
         }
       }
+      graph.AddStep(node.name, [&operation, &node]() {return operation(node);}, after);
+    }
+    graph.Run();
+    std::vector<bool> results;
+    for (auto & report : graph.GetReports()) {
+      if (report.skipped) {
+        ERROR("Skip lifecycle [%s] as a lifecycle it depends on failed", report.name.c_str());
+      }
+      results.push_back(report.success);
+    }
+    INFO("Lifecycle operations: %s", graph.Summary().c_str());
+    return results;
+  }
+
+  /**
+   * @brief 距deadline的剩余时间(ms), 不小于0
+   */
+  static int RemainingMs(const std::chrono::steady_clock::time_point & deadline)
+  {
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+      deadline - std::chrono::steady_clock::now()).count();
+    return static_cast<int>(std::max<int64_t>(remaining, 0));
+  }
+
+  bool ActivateLifecycleNode(
+    const LifecycleNodeRef & client, const std::chrono::steady_clock::time_point & deadline)
+  {
+    INFO("Trying to launch [%s]", client.name.c_str());
+    int lifecycle_query = std::min(10, RemainingMs(deadline) / 1000);
+    if (!client.lifecycle_client->service_exist(std::chrono::seconds(lifecycle_query))) {
+      ERROR("Lifecycle [%s] not exist in %ds", client.name.c_str(), lifecycle_query);
+      return false;
+    }
+    bool is_timeout = false;
+    auto state = client.lifecycle_client->get_state(is_timeout, RemainingMs(deadline));
+    if (is_timeout) {
+      ERROR("Cannot get state of [%s]", client.name.c_str());
+      return false;
+    }
+    if (state == lifecycle_msgs::msg::State::PRIMARY_STATE_ACTIVE) {
+      INFO("Lifecycle [%s] already be active", client.name.c_str());
+      return true;
+    }
+    if (state == lifecycle_msgs::msg::State::PRIMARY_STATE_UNCONFIGURED) {
+      if (!client.lifecycle_client->change_state(
+          lifecycle_msgs::msg::Transition::
+          TRANSITION_CONFIGURE, RemainingMs(deadline)))
+      {
+        WARN("Get error when configuring [%s], try to active", client.name.c_str());
+      }
     }
+    if (!client.lifecycle_client->change_state(
+        lifecycle_msgs::msg::Transition::
+        TRANSITION_ACTIVATE, RemainingMs(deadline)))
+    {
+      ERROR("Get error when activing [%s] with state: %d", client.name.c_str(), state);
+      return false;
+    }
+    {
+      std::lock_guard<std::mutex> lock(standby_mutex_);
+      standby_nodes_.erase(client.name);
+    }
+    INFO("Success to active [%s]", client.name.c_str());
     return true;
   }
 
+  void DeactivateLifecycleNode(
+    const LifecycleNodeRef & client, const std::chrono::steady_clock::time_point & deadline,
+    bool cleanup, bool standby)
+  {
+    int lifecycle_query = std::min(10, RemainingMs(deadline) / 1000);
+    if (!client.lifecycle_client->service_exist(std::chrono::seconds(lifecycle_query))) {
+      WARN(
+        "Lifecycle [%s] not exist in %ds, will not deactive it",
+        client.name.c_str(), lifecycle_query);
+      return;
+    }
+    bool is_timeout = false;
+    auto state = client.lifecycle_client->get_state(is_timeout, RemainingMs(deadline));
+    if (is_timeout) {
+      ERROR("Cannot get state of [%s]", client.name.c_str());
+      return;
+    }
+    if (state == lifecycle_msgs::msg::State::PRIMARY_STATE_UNCONFIGURED) {
+      INFO("Lifecycle [%s] is unconfigured, no need to deactivate", client.name.c_str());
+      return;
+    } else if (state == lifecycle_msgs::msg::State::PRIMARY_STATE_INACTIVE) {
+      // Configured but never activated, e.g. after a failed start
+      INFO("Lifecycle [%s] already be inactive", client.name.c_str());
+    } else if (!client.lifecycle_client->change_state(
+        lifecycle_msgs::msg::Transition::TRANSITION_DEACTIVATE, RemainingMs(deadline)))
+    {
+      ERROR("Get error when deactive %s", client.name.c_str());
+    } else {
+      INFO("Success to deactive [%s]", client.name.c_str());
+    }
+    if (standby) {
+      std::lock_guard<std::mutex> lock(standby_mutex_);
+      standby_nodes_[client.name] = {
+        standby_config_.NodeMemoryMB(client.name), std::chrono::steady_clock::now()};
+      INFO("Keep lifecycle [%s] configured for standby", client.name.c_str());
+      return;
+    }
+    if (cleanup) {
+      if (client.name == std::string("vision_manager")) {
+        return;
+      }
+      if (!client.lifecycle_client->change_state(
+          lifecycle_msgs::msg::Transition::TRANSITION_CLEANUP, RemainingMs(deadline)))
+      {
+        ERROR("Get error when cleanup %s", client.name.c_str());
+      } else {
+        INFO("Success to cleanup [%s]", client.name.c_str());
+        std::lock_guard<std::mutex> lock(standby_mutex_);
+        standby_nodes_.erase(client.name);
+      }
+    }
+  }
 
   void UpdateExecutorFeedback(const AlgorithmMGR::Feedback::SharedPtr feedback)
   {
@@ -468,6 +833,10 @@ protected:
   static std::unordered_map<std::string,
     std::shared_ptr<nav2_util::LifecycleServiceClient>> lifecycle_clients;
   static std::unordered_map<std::string, LifecycleNodeIndexs> task_map_;
+  // Lifecycle nodes kept configured by warm standby, shared by all the tasks
+  static std::unordered_map<std::string, StandbyNode> standby_nodes_;
+  static StandbyConfig standby_config_;
+  static std::mutex standby_mutex_;
   static constexpr uint8_t preparation_finished_report_time_ = 0;  // count
   std::chrono::milliseconds server_timeout_{2000};
   rclcpp::Node::SharedPtr action_client_node_;
@@ -486,6 +855,9 @@ private:
   std::condition_variable preparation_count_cv_;
   std::condition_variable preparation_finish_cv_;
   std::vector<LifecycleNodeRef> lifecycle_activated_{};
+  // Task lifecycle_activated_ belongs to, and its order constraints
+  std::string lifecycle_activated_task_{};
+  std::unordered_map<std::string, std::vector<std::string>> lifecycle_activated_deps_{};
   static std::shared_ptr<BehaviorManager> behavior_manager_;
   bool preparation_finished_{true};
 
@@ -24,6 +24,7 @@
 #include "std_msgs/msg/int32.hpp"
 #include "std_msgs/msg/bool.hpp"
 #include "algorithm_manager/timer.hpp"
+#include "algorithm_manager/task_graph.hpp"
 #include "protocol/srv/get_map_label.hpp"
 
 namespace cyberdog
@@ -150,6 +151,24 @@ private:
 
   bool StopLocalizationFunctions();
 
+  /**
+   * @brief Set the exit flag and wake up WaitRelocalization
+   *
+   * @param cleanup Whether Start() has to release what it started once woken
+   */
+  void RequestExit(bool cleanup = false);
+
+  /**
+   * @brief Get and clear the cleanup request of RequestExit
+   */
+  bool TakeExitCleanup();
+
+  /**
+   * @brief Disable relocalization, reset the lifecycle nodes and close the
+   * realsense data after a failed or stopped Start()
+   */
+  void ReleaseLocalizationFunctions();
+
   bool CheckExit();
 
   bool StartupRealsenseData(bool enable);
@@ -188,6 +207,7 @@ private:
   // in service
   bool is_activate_ {false};
   bool is_exit_ {false};
+  bool exit_cleanup_ {false};
   bool is_lifecycle_activate_ {false};
   bool is_slam_service_activate_ {false};
   bool is_realtime_pose_service_activate_ {false};
@@ -198,6 +218,9 @@ private:
   std::mutex service_mutex_;
   std::mutex realtime_pose_mutex_;
   std::mutex task_mutex_;
+  // Guards the relocalization flags WaitRelocalization waits on
+  std::mutex relocalization_mutex_;
+  std::condition_variable relocalization_cv_;
 };  // class ExecutorLaserLocalization
 }  // namespace algorithm
 }  // namespace cyberdog
@@ -0,0 +1,98 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ALGORITHM_MANAGER__TASK_GRAPH_HPP_
+#define ALGORITHM_MANAGER__TASK_GRAPH_HPP_
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cyberdog
+{
+namespace algorithm
+{
+
+/**
+ * @brief
+ * 以有向无环图描述的一组步骤(通常是服务调用).
+ * 每个步骤在其依赖的步骤全部成功后立即开始, 互不依赖的步骤并发执行;
+ * 依赖的步骤失败时, 该步骤被跳过. 每个步骤的耗时会被记录.
+ *
+ */
+class TaskGraph
+{
+public:
+  struct StepReport
+  {
+    std::string name;
+    bool success{false};
+    bool skipped{false};
+    double elapsed{0.0};  // seconds
+  };
+
+  /**
+   * @brief 添加步骤
+   *
+   * @param name 步骤名, 需唯一
+   * @param step 步骤内容, 返回false表示失败
+   * @param after 需先成功完成的步骤, 可以是之后才添加的步骤
+   * @return false 步骤名重复
+   */
+  bool AddStep(
+    const std::string & name, std::function<bool()> step,
+    const std::vector<std::string> & after = {});
+
+  /**
+   * @brief 执行所有步骤并等待其结束
+   *
+   * @return true 所有步骤均成功
+   * @return false 有步骤失败或被跳过, 或依赖关系无效(未知步骤或存在环)
+   */
+  bool Run();
+
+  /**
+   * @brief 步骤是否已成功执行
+   */
+  bool Succeeded(const std::string & name) const;
+
+  /**
+   * @brief 最近一次Run的各步骤结果, 与添加顺序一致
+   */
+  const std::vector<StepReport> & GetReports() const {return reports_;}
+
+  /**
+   * @brief 各步骤耗时的单行摘要, 如 "map_check 0.120s, activate 1.503s"
+   */
+  std::string Summary() const;
+
+private:
+  struct Step
+  {
+    std::string name;
+    std::function<bool()> run;
+    std::vector<std::string> after;
+  };
+
+  bool Validate(std::vector<std::vector<size_t>> & prerequisites) const;
+
+  std::vector<Step> steps_;
+  std::unordered_map<std::string, size_t> index_;
+  std::vector<StepReport> reports_;
+};
+
+}  // namespace algorithm
+}  // namespace cyberdog
+#endif  // ALGORITHM_MANAGER__TASK_GRAPH_HPP_
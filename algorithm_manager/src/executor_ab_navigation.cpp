@@ -140,7 +140,7 @@ void ExecutorAbNavigation::Start(const AlgorithmMGR::Goal::ConstSharedPtr goal)
   if (!connect) {
     ERROR("Connect navigation AB point server failed.");
     UpdateFeedback(kErrorConnectActionServer);
-    DeactivateDepsLifecycleNodes(20000, true);
+    DeactivateDepsLifecycleNodes(20000, true, true);
     task_abort_callback_();
     return;
   }
@@ -152,7 +152,7 @@ void ExecutorAbNavigation::Start(const AlgorithmMGR::Goal::ConstSharedPtr goal)
   if (!legal) {
     ERROR("Current navigation AB point is not legal.");
     UpdateFeedback(kErrorTargetGoalIsEmpty);
-    DeactivateDepsLifecycleNodes(20000, true);
+    DeactivateDepsLifecycleNodes(20000, true, true);
     task_abort_callback_();
     return;
   }
@@ -173,7 +173,7 @@ void ExecutorAbNavigation::Start(const AlgorithmMGR::Goal::ConstSharedPtr goal)
   // Send goal request
   if (!SendGoal(new_goal->poses[0])) {
     ERROR("Send navigation AB point send target goal request failed.");
-    DeactivateDepsLifecycleNodes(20000, true);
+    DeactivateDepsLifecycleNodes(20000, true, true);
     UpdateFeedback(kErrorSendGoalTarget);
     task_abort_callback_();
     return;
@@ -274,7 +274,8 @@ bool ExecutorAbNavigation::IsDependsReady()
   INFO("IsDependsReady(): Success to get lifecycle_mutex_");
   // Nav lifecycle
   if (!ActivateDepsLifecycleNodes(this->get_name())) {
-    DeactivateDepsLifecycleNodes(20000, true);
+    // Nodes that failed half way are not in lifecycle_activated_
+    DeactivateDepsLifecycleNodes(this->get_name(), 20000, true, true);
     return false;
   }
 
@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 #include <string>
@@ -27,6 +29,9 @@ std::unordered_map<std::string,
 std::unordered_map<std::string,
   std::shared_ptr<nav2_util::LifecycleServiceClient>> ExecutorBase::lifecycle_clients;
 std::unordered_map<std::string, ExecutorBase::LifecycleNodeIndexs> ExecutorBase::task_map_;
+std::unordered_map<std::string, ExecutorBase::StandbyNode> ExecutorBase::standby_nodes_;
+ExecutorBase::StandbyConfig ExecutorBase::standby_config_;
+std::mutex ExecutorBase::standby_mutex_;
 std::shared_ptr<BehaviorManager> ExecutorBase::behavior_manager_;
 }  // namespace algorithm
 }  // namespace cyberdog
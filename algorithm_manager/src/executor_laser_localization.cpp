@@ -61,68 +61,101 @@ void ExecutorLaserLocalization::Start(const AlgorithmMGR::Goal::ConstSharedPtr g
 {
   (void)goal;
   INFO("Laser Localization started");
+  {
+    // A Cancel() of the previous run may have left it set
+    std::lock_guard<std::mutex> lock(relocalization_mutex_);
+    is_exit_ = false;
+    exit_cleanup_ = false;
+  }
 
   Timer timer, total_timer;
   timer.Start();
   total_timer.Start();
 
-  StartupRealsenseData(true);
-
-  // Check current map available
-  UpdateFeedback(relocalization::kMapChecking);
-  bool available = CheckMapAvailable();
-  if (!available) {
-    ERROR("Map file not available");
-    UpdateFeedback(relocalization::kMapCheckingError);
-    ResetFlags();
-    task_abort_callback_();
-    return;
-  }
-  UpdateFeedback(relocalization::kMapCheckingSuccess);
-  INFO("[0] Checking map available Elapsed time: %.5f [seconds]", timer.ElapsedSeconds());
-  timer.Start();
-  // 1 正在激活依赖节点
-  UpdateFeedback(AlgorithmMGR::Feedback::TASK_PREPARATION_EXECUTING);
-  bool ready = IsDependsReady();
-  if (!ready) {
-    ERROR("Laser localization lifecycle depend start up failed.");
-    // 2 激活依赖节点失败
-    UpdateFeedback(AlgorithmMGR::Feedback::TASK_PREPARATION_FAILED);
-    ResetAllLifecyceNodes();
-    ResetFlags();
-    task_abort_callback_();
-    location_status_ = LocationStatus::FAILURE;
-    return;
-  }
-  // 3 激活依赖节点成功
-  UpdateFeedback(AlgorithmMGR::Feedback::TASK_PREPARATION_SUCCESS);
-  INFO("[1] Activate lifecycle nodes Elapsed time: %.5f [seconds]", timer.ElapsedSeconds());
-  timer.Start();
-  // Realtime response user stop operation
-  if (CheckExit()) {
-    WARN("Laser localization is stop, not need enable relocalization.");
-    return;
-  }
+  // The realsense stream comes up while the map is checked and the lifecycle
+  // nodes are activated, relocalization starts once all of them are done
+  bool exited = false;
+  TaskGraph startup;
+  startup.AddStep(
+    "realsense", [this]() {
+      if (!StartupRealsenseData(true)) {
+        WARN("Turn on realsense data failed.");
+      }
+      return true;
+    });
+  startup.AddStep(
+    "map_check", [this]() {
+      // Check current map available
+      UpdateFeedback(relocalization::kMapChecking);
+      if (!CheckMapAvailable()) {
+        ERROR("Map file not available");
+        UpdateFeedback(relocalization::kMapCheckingError);
+        return false;
+      }
+      UpdateFeedback(relocalization::kMapCheckingSuccess);
+      return true;
+    });
+  startup.AddStep(
+    "activate", [this]() {
+      // 1 正在激活依赖节点
+      UpdateFeedback(AlgorithmMGR::Feedback::TASK_PREPARATION_EXECUTING);
+      if (!IsDependsReady()) {
+        ERROR("Laser localization lifecycle depend start up failed.");
+        // 2 激活依赖节点失败
+        UpdateFeedback(AlgorithmMGR::Feedback::TASK_PREPARATION_FAILED);
+        return false;
+      }
+      // 3 激活依赖节点成功
+      UpdateFeedback(AlgorithmMGR::Feedback::TASK_PREPARATION_SUCCESS);
+      return true;
+    }, {"map_check"});
+  startup.AddStep(
+    "relocalization", [this, &exited]() {
+      // Realtime response user stop operation
+      if (CheckExit()) {
+        WARN("Laser localization is stop, not need enable relocalization.");
+        exited = true;
+        return false;
+      }
+      // Enable Relocalization
+      UpdateFeedback(relocalization::kServiceStarting);
+      if (!EnableRelocalization()) {
+        ERROR("Turn on relocalization failed.");
+        UpdateFeedback(relocalization::kServiceStartingError);
+        return false;
+      }
+      UpdateFeedback(relocalization::kServiceStartingSuccess);
+      return true;
+    }, {"realsense", "activate"});
 
-  // Enable Relocalization
-  UpdateFeedback(relocalization::kServiceStarting);
-  bool success = EnableRelocalization();
+  bool success = startup.Run();
+  INFO("[0-2] Startup steps: %s", startup.Summary().c_str());
+  INFO("[0-2] Startup Elapsed time: %.5f [seconds]", timer.ElapsedSeconds());
   if (!success) {
-    ERROR("Turn on relocalization failed.");
-    UpdateFeedback(relocalization::kServiceStartingError);
-    ResetAllLifecyceNodes();
+    if (exited) {
+      if (TakeExitCleanup()) {
+        ReleaseLocalizationFunctions();
+      }
+      return;
+    }
+    if (startup.Succeeded("map_check")) {
+      // A failed activation already tore its nodes down in IsDependsReady
+      if (startup.Succeeded("activate")) {
+        ResetAllLifecyceNodes();
+      }
+      location_status_ = LocationStatus::FAILURE;
+    }
     ResetFlags();
     task_abort_callback_();
-    location_status_ = LocationStatus::FAILURE;
     return;
   }
 
-  UpdateFeedback(relocalization::kServiceStartingSuccess);
-  INFO("[2] Enable relocalization service Elapsed time: %.5f [seconds]", timer.ElapsedSeconds());
-
   // Realtime response user stop operation
   if (CheckExit()) {
     WARN("Laser localization is stop, not need wait relocalization.");
+    if (TakeExitCleanup()) {
+      ReleaseLocalizationFunctions();
+    }
     return;
   }
 
@@ -137,31 +170,12 @@ void ExecutorLaserLocalization::Start(const AlgorithmMGR::Goal::ConstSharedPtr g
     UpdateFeedback(relocalization::kSLAMTimeout);
 
     if (!force_quit) {
-      INFO("Start: Trying call disable relocalization service.");
-      bool ret = DisableRelocalization();
-      if (!ret) {
-        ERROR("Start: Trying call disable relocalization service failed");
-      } else {
-        INFO("Start: Trying call disable relocalization service success");
-      }
-
-      INFO("Start: Trying call reset all lifecyce nodes");
-      ret = ResetAllLifecyceNodes();
-      if (!ret) {
-        ERROR("Start: Trying call reset all lifecyce nodes failed");
-      } else {
-        INFO("Start: Trying call reset all lifecyce nodes success");
-      }
-
-      success = StartupRealsenseData(false);
-      if (!success) {
-        ERROR("Start: Close realsense data failed.");
-      } else {
-        INFO("Start: Close realsense data success.");
-      }
-
-      ResetFlags();
+      ReleaseLocalizationFunctions();
       task_abort_callback_();
+    } else if (TakeExitCleanup()) {
+      // Stop() and Cancel() leave the cleanup to this thread, the reset
+      // service cleans up on its own
+      ReleaseLocalizationFunctions();
     }
 
     location_status_ = LocationStatus::FAILURE;
@@ -173,6 +187,9 @@ void ExecutorLaserLocalization::Start(const AlgorithmMGR::Goal::ConstSharedPtr g
   // Realtime response user stop operation
   if (CheckExit()) {
     WARN("Laser localization is stop, not need enable report realtime pose.");
+    if (TakeExitCleanup()) {
+      ReleaseLocalizationFunctions();
+    }
     return;
   }
   // timer.Start();
@@ -210,6 +227,9 @@ void ExecutorLaserLocalization::Stop(
   (void)request;
   WARN("Laser localization Executor Stop() is called, this should never happen");
   response->result = StopTaskSrv::Response::SUCCESS;
+  // Do not leave Start() waiting for the relocalization result, it cleans
+  // up once woken
+  RequestExit(true);
 
   // Timer timer;
   // timer.Start();
@@ -249,6 +269,7 @@ void ExecutorLaserLocalization::Stop(
 void ExecutorLaserLocalization::Cancel()
 {
   INFO("Laser Localization canceled");
+  RequestExit(true);
 }
 
 void ExecutorLaserLocalization::HandleLocationServiceCallback(
@@ -267,8 +288,10 @@ void ExecutorLaserLocalization::HandleRelocalizationCallback(
   }
 
   INFO("Relocalization result: %d", msg->data);
+  std::lock_guard<std::mutex> lock(relocalization_mutex_);
   if (msg->data == 0) {
     relocalization_success_ = true;
+    relocalization_cv_.notify_all();
     INFO("Relocalization success.");
   } else if (msg->data == 100) {
     if (relocalization_timeout_) {
@@ -280,6 +303,7 @@ void ExecutorLaserLocalization::HandleRelocalizationCallback(
     WARN("Relocalization retrying.");
   } else if (msg->data == 200) {
     relocalization_failure_ = true;
+    relocalization_cv_.notify_all();
     UpdateFeedback(relocalization::kSLAMError);
     WARN("Relocalization failed.");
   }
@@ -325,6 +349,8 @@ bool ExecutorLaserLocalization::IsDependsReady()
   INFO("[IsDependsReady(): Success to get lifecycle_mutex_");
   bool acivate_success = ActivateDepsLifecycleNodes(this->get_name());
   if (!acivate_success) {
+    // Nodes that failed half way are not in lifecycle_activated_
+    DeactivateDepsLifecycleNodes(this->get_name(), 20000, true, true);
     return false;
   }
 
@@ -335,28 +361,29 @@ bool ExecutorLaserLocalization::IsDependsReady()
 bool ExecutorLaserLocalization::WaitRelocalization(std::chrono::seconds timeout, bool & force_quit)
 {
   auto end = std::chrono::steady_clock::now() + timeout;
-  while (rclcpp::ok() && !relocalization_success_) {
-    if (is_exit_) {
-      WARN("Relocalization force quit");
-      force_quit = true;
-      return false;
-    }
-
-    auto now = std::chrono::steady_clock::now();
-    auto time_left = end - now;
-    if (time_left <= std::chrono::seconds(0)) {
-      WARN("Wait relocalization result timeout.");
-      relocalization_timeout_ = true;
-      return false;
-    }
-
-    if (relocalization_failure_) {
-      ERROR("Relocalization result failure.");
-      return false;
-    }
-    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  std::unique_lock<std::mutex> lock(relocalization_mutex_);
+  // Woken up by HandleRelocalizationCallback and RequestExit
+  relocalization_cv_.wait_until(
+    lock, end, [this]() {
+      return !rclcpp::ok() || relocalization_success_ || relocalization_failure_ || is_exit_;
+    });
+  if (relocalization_success_) {
+    return true;
   }
-  return true;
+  if (is_exit_) {
+    WARN("Relocalization force quit");
+    force_quit = true;
+    return false;
+  }
+  if (relocalization_failure_) {
+    ERROR("Relocalization result failure.");
+    return false;
+  }
+  if (rclcpp::ok()) {
+    WARN("Wait relocalization result timeout.");
+    relocalization_timeout_ = true;
+  }
+  return false;
 }
 
 bool ExecutorLaserLocalization::EnableRelocalization()
@@ -475,10 +502,12 @@ bool ExecutorLaserLocalization::DisableRelocalization()
 
 void ExecutorLaserLocalization::ResetFlags()
 {
+  std::lock_guard<std::mutex> lock(relocalization_mutex_);
   relocalization_success_ = false;
   relocalization_failure_ = false;
   is_activate_ = false;
   is_exit_ = false;
+  exit_cleanup_ = false;
   relocalization_timeout_ = false;
 }
 
@@ -539,7 +568,7 @@ bool ExecutorLaserLocalization::StopLocalizationFunctions()
   total_timer.Start();
 
   // Trigger stop localization exit flag
-  is_exit_ = true;
+  RequestExit();
   bool success = true;
 
   if (is_slam_service_activate_) {
@@ -592,6 +621,55 @@ bool ExecutorLaserLocalization::StopLocalizationFunctions()
   return success;
 }
 
+void ExecutorLaserLocalization::RequestExit(bool cleanup)
+{
+  {
+    std::lock_guard<std::mutex> lock(relocalization_mutex_);
+    is_exit_ = true;
+    exit_cleanup_ = exit_cleanup_ || cleanup;
+  }
+  relocalization_cv_.notify_all();
+}
+
+bool ExecutorLaserLocalization::TakeExitCleanup()
+{
+  std::lock_guard<std::mutex> lock(relocalization_mutex_);
+  bool cleanup = exit_cleanup_;
+  exit_cleanup_ = false;
+  return cleanup;
+}
+
+void ExecutorLaserLocalization::ReleaseLocalizationFunctions()
+{
+  bool ret = true;
+  if (is_slam_service_activate_) {
+    INFO("Start: Trying call disable relocalization service.");
+    ret = DisableRelocalization();
+    if (!ret) {
+      ERROR("Start: Trying call disable relocalization service failed");
+    } else {
+      INFO("Start: Trying call disable relocalization service success");
+    }
+  }
+
+  INFO("Start: Trying call reset all lifecyce nodes");
+  ret = ResetAllLifecyceNodes();
+  if (!ret) {
+    ERROR("Start: Trying call reset all lifecyce nodes failed");
+  } else {
+    INFO("Start: Trying call reset all lifecyce nodes success");
+  }
+
+  ret = StartupRealsenseData(false);
+  if (!ret) {
+    ERROR("Start: Close realsense data failed.");
+  } else {
+    INFO("Start: Close realsense data success.");
+  }
+
+  ResetFlags();
+}
+
 bool ExecutorLaserLocalization::CheckExit()
 {
   return is_exit_;
@@ -0,0 +1,162 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdio>
+#include <exception>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "algorithm_manager/task_graph.hpp"
+#include "algorithm_manager/timer.hpp"
+#include "cyberdog_common/cyberdog_log.hpp"
+
+namespace cyberdog
+{
+namespace algorithm
+{
+
+bool TaskGraph::AddStep(
+  const std::string & name, std::function<bool()> step,
+  const std::vector<std::string> & after)
+{
+  if (index_.count(name) != 0) {
+    ERROR("Duplicate task step: %s", name.c_str());
+    return false;
+  }
+  index_.emplace(name, steps_.size());
+  steps_.push_back({name, step, after});
+  return true;
+}
+
+bool TaskGraph::Validate(std::vector<std::vector<size_t>> & prerequisites) const
+{
+  prerequisites.assign(steps_.size(), {});
+  for (size_t i = 0; i < steps_.size(); i++) {
+    for (auto & name : steps_[i].after) {
+      auto it = index_.find(name);
+      if (it == index_.end()) {
+        ERROR("Task step %s depends on unknown step %s", steps_[i].name.c_str(), name.c_str());
+        return false;
+      }
+      prerequisites[i].push_back(it->second);
+    }
+  }
+
+  // A cycle would wait forever
+  std::vector<int> mark(steps_.size(), 0);  // 0 unvisited, 1 visiting, 2 done
+  std::function<bool(size_t)> visit = [&](size_t i) {
+      if (mark[i] != 0) {
+        return mark[i] == 2;
+      }
+      mark[i] = 1;
+      for (auto j : prerequisites[i]) {
+        if (!visit(j)) {
+          return false;
+        }
+      }
+      mark[i] = 2;
+      return true;
+    };
+  for (size_t i = 0; i < steps_.size(); i++) {
+    if (!visit(i)) {
+      ERROR("Task steps have a cycle through %s", steps_[i].name.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TaskGraph::Run()
+{
+  reports_.assign(steps_.size(), StepReport());
+  for (size_t i = 0; i < steps_.size(); i++) {
+    reports_[i].name = steps_[i].name;
+  }
+
+  std::vector<std::vector<size_t>> prerequisites;
+  if (!Validate(prerequisites)) {
+    return false;
+  }
+
+  // Each step is a continuation of the futures of its prerequisites
+  std::vector<std::promise<bool>> promises(steps_.size());
+  std::vector<std::shared_future<bool>> futures;
+  for (auto & promise : promises) {
+    futures.push_back(promise.get_future().share());
+  }
+  std::vector<std::future<void>> tasks;
+  for (size_t i = 0; i < steps_.size(); i++) {
+    tasks.push_back(
+      std::async(
+        std::launch::async, [&, i]() {
+          for (auto j : prerequisites[i]) {
+            if (!futures[j].get()) {
+              reports_[i].skipped = true;
+              promises[i].set_value(false);
+              return;
+            }
+          }
+          Timer timer;
+          timer.Start();
+          bool success = false;
+          try {
+            success = steps_[i].run();
+          } catch (const std::exception & e) {
+            ERROR("Task step %s failed: %s", steps_[i].name.c_str(), e.what());
+          }
+          reports_[i].elapsed = timer.ElapsedSeconds();
+          reports_[i].success = success;
+          promises[i].set_value(success);
+        }));
+  }
+
+  bool success = true;
+  for (size_t i = 0; i < tasks.size(); i++) {
+    tasks[i].get();
+    success = futures[i].get() && success;
+  }
+  return success;
+}
+
+bool TaskGraph::Succeeded(const std::string & name) const
+{
+  auto it = index_.find(name);
+  return it != index_.end() && it->second < reports_.size() && reports_[it->second].success;
+}
+
+std::string TaskGraph::Summary() const
+{
+  std::string summary;
+  char buffer[32];
+  for (auto & report : reports_) {
+    if (!summary.empty()) {
+      summary += ", ";
+    }
+    summary += report.name;
+    if (report.skipped) {
+      summary += " skipped";
+      continue;
+    }
+    snprintf(buffer, sizeof(buffer), " %.3fs", report.elapsed);
+    summary += buffer;
+    if (!report.success) {
+      summary += " failed";
+    }
+  }
+  return summary;
+}
+
+}  // namespace algorithm
+}  // namespace cyberdog
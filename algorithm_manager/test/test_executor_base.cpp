@@ -0,0 +1,188 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "algorithm_manager/executor_base.hpp"
+
+namespace cyberdog
+{
+namespace algorithm
+{
+
+class ExecutorBaseTest : public ExecutorBase
+{
+public:
+  using ExecutorBase::SetLifecycleOrder;
+  using ExecutorBase::ParseLifecycleOrder;
+  using ExecutorBase::SelectStandbyEvictions;
+  using ExecutorBase::ParseStandbyConfig;
+};
+
+ExecutorBase::LifecycleNodeIndexs NavNodes()
+{
+  ExecutorBase::LifecycleNodeIndexs lifecycle_ref;
+  lifecycle_ref.lifecycle_indexs =
+  {"controller_server_ab", "planner_server_ab", "recoveries_server", "bt_navigator_ab"};
+  return lifecycle_ref;
+}
+
+toml::value TaskWithOrder(const std::vector<std::string> & order)
+{
+  toml::array entries;
+  for (auto & entry : order) {
+    entries.push_back(entry);
+  }
+  return toml::value(toml::table{{"DepsLifecycleOrder", entries}});
+}
+
+std::unordered_map<std::string, std::vector<std::string>> Chain()
+{
+  return {
+    {"planner_server_ab", {"controller_server_ab"}},
+    {"recoveries_server", {"planner_server_ab"}},
+    {"bt_navigator_ab", {"recoveries_server"}}};
+}
+
+TEST(LifecycleOrder, ParsesDependencies)
+{
+  auto lifecycle_ref = NavNodes();
+  ASSERT_TRUE(
+    ExecutorBaseTest::ParseLifecycleOrder(
+      "NavAB",
+      {" bt_navigator_ab :controller_server_ab,planner_server_ab , recoveries_server",
+        "planner_server_ab: controller_server_ab,"},
+      lifecycle_ref));
+  std::unordered_map<std::string, std::vector<std::string>> expected{
+    {"bt_navigator_ab", {"controller_server_ab", "planner_server_ab", "recoveries_server"}},
+    {"planner_server_ab", {"controller_server_ab"}}};
+  EXPECT_EQ(lifecycle_ref.lifecycle_deps, expected);
+}
+
+TEST(LifecycleOrder, RejectsInvalidEntries)
+{
+  auto lifecycle_ref = NavNodes();
+  // Not of the form "node: deps"
+  EXPECT_FALSE(
+    ExecutorBaseTest::ParseLifecycleOrder("NavAB", {"bt_navigator_ab"}, lifecycle_ref));
+  // Unknown node, on either side
+  EXPECT_FALSE(
+    ExecutorBaseTest::ParseLifecycleOrder(
+      "NavAB", {"map_server: controller_server_ab"}, lifecycle_ref));
+  EXPECT_FALSE(
+    ExecutorBaseTest::ParseLifecycleOrder(
+      "NavAB", {"bt_navigator_ab: map_server"}, lifecycle_ref));
+  // Cycle
+  EXPECT_FALSE(
+    ExecutorBaseTest::ParseLifecycleOrder(
+      "NavAB",
+      {"bt_navigator_ab: planner_server_ab", "planner_server_ab: bt_navigator_ab"},
+      lifecycle_ref));
+  EXPECT_TRUE(lifecycle_ref.lifecycle_deps.empty());
+}
+
+TEST(LifecycleOrder, UsesConfiguredOrder)
+{
+  auto lifecycle_ref = NavNodes();
+  ExecutorBaseTest::SetLifecycleOrder(
+    "NavAB", TaskWithOrder({"bt_navigator_ab: planner_server_ab"}), lifecycle_ref);
+  std::unordered_map<std::string, std::vector<std::string>> expected{
+    {"bt_navigator_ab", {"planner_server_ab"}}};
+  EXPECT_EQ(lifecycle_ref.lifecycle_deps, expected);
+}
+
+TEST(LifecycleOrder, FallsBackToChain)
+{
+  // Without DepsLifecycleOrder
+  auto lifecycle_ref = NavNodes();
+  ExecutorBaseTest::SetLifecycleOrder("NavAB", toml::value(toml::table{}), lifecycle_ref);
+  EXPECT_EQ(lifecycle_ref.lifecycle_deps, Chain());
+
+  // With an invalid one
+  lifecycle_ref = NavNodes();
+  ExecutorBaseTest::SetLifecycleOrder(
+    "NavAB", TaskWithOrder({"bt_navigator_ab: map_server"}), lifecycle_ref);
+  EXPECT_EQ(lifecycle_ref.lifecycle_deps, Chain());
+}
+
+TEST(StandbyEviction, WithinBudget)
+{
+  const auto now = std::chrono::steady_clock::now();
+  std::unordered_map<std::string, ExecutorBase::StandbyNode> nodes{
+    {"a", {100, now}}, {"b", {100, now + 1s}}};
+  EXPECT_TRUE(ExecutorBaseTest::SelectStandbyEvictions(nodes, 200).empty());
+  EXPECT_TRUE(ExecutorBaseTest::SelectStandbyEvictions({}, 0).empty());
+}
+
+TEST(StandbyEviction, OldestFirst)
+{
+  const auto now = std::chrono::steady_clock::now();
+  std::unordered_map<std::string, ExecutorBase::StandbyNode> nodes{
+    {"newest", {64, now + 3s}}, {"oldest", {64, now}},
+    {"older", {96, now + 1s}}, {"newer", {96, now + 2s}}};
+  // 320 MB in standby
+  EXPECT_EQ(
+    ExecutorBaseTest::SelectStandbyEvictions(nodes, 300),
+    std::vector<std::string>({"oldest"}));
+  EXPECT_EQ(
+    ExecutorBaseTest::SelectStandbyEvictions(nodes, 200),
+    std::vector<std::string>({"oldest", "older"}));
+  EXPECT_EQ(
+    ExecutorBaseTest::SelectStandbyEvictions(nodes, 0),
+    std::vector<std::string>({"oldest", "older", "newer", "newest"}));
+}
+
+TEST(StandbyEviction, BudgetFromConfig)
+{
+  const toml::table node_mb{{"planner_server_ab", 96}, {"controller_server_ab", 96}};
+  const toml::value tasks(
+    toml::table{{"standby", toml::table{{"MemoryBudgetMB", 384}, {"NodeMemoryMB", node_mb}}}});
+  ExecutorBase::StandbyConfig config;
+  ExecutorBaseTest::ParseStandbyConfig(tasks, config);
+  EXPECT_EQ(config.budget_mb, 384);
+  // Not configured, the default is kept
+  EXPECT_EQ(config.default_node_mb, 64);
+  EXPECT_EQ(config.NodeMemoryMB("planner_server_ab"), 96);
+  EXPECT_EQ(config.NodeMemoryMB("recoveries_server"), 64);
+
+  // The nodes of NavAB, 320 MB, fit
+  const auto now = std::chrono::steady_clock::now();
+  std::unordered_map<std::string, ExecutorBase::StandbyNode> nodes;
+  nodes["bt_navigator_ab"] = {config.NodeMemoryMB("bt_navigator_ab"), now};
+  for (auto & name : {"controller_server_ab", "planner_server_ab", "recoveries_server"}) {
+    nodes[name] = {config.NodeMemoryMB(name), now + 1s};
+  }
+  EXPECT_TRUE(ExecutorBaseTest::SelectStandbyEvictions(nodes, config.budget_mb).empty());
+
+  // The 384 MB are reached with another node, and exceeded with two.
+  // bt_navigator_ab went down first.
+  nodes["mivinslocalization"] = {config.NodeMemoryMB("mivinslocalization"), now + 2s};
+  EXPECT_TRUE(ExecutorBaseTest::SelectStandbyEvictions(nodes, config.budget_mb).empty());
+  nodes["vision_manager"] = {config.NodeMemoryMB("vision_manager"), now + 3s};
+  EXPECT_EQ(
+    ExecutorBaseTest::SelectStandbyEvictions(nodes, config.budget_mb),
+    std::vector<std::string>({"bt_navigator_ab"}));
+
+  // Without a [standby] section nothing is kept
+  ExecutorBase::StandbyConfig empty;
+  ExecutorBaseTest::ParseStandbyConfig(toml::value(toml::table{}), empty);
+  EXPECT_EQ(empty.budget_mb, 0);
+}
+
+}  // namespace algorithm
+}  // namespace cyberdog
@@ -0,0 +1,175 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "algorithm_manager/task_graph.hpp"
+
+namespace cyberdog
+{
+namespace algorithm
+{
+
+// Records the order in which steps finish
+class Journal
+{
+public:
+  std::function<bool()> Step(const std::string & name, bool result = true)
+  {
+    return [this, name, result]() {
+             std::lock_guard<std::mutex> lock(mutex_);
+             finished_.push_back(name);
+             return result;
+           };
+  }
+
+  size_t Position(const std::string & name)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::find(finished_.begin(), finished_.end(), name) - finished_.begin();
+  }
+
+  size_t Count()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return finished_.size();
+  }
+
+private:
+  std::mutex mutex_;
+  std::vector<std::string> finished_;
+};
+
+TEST(TaskGraph, RunsStepsAfterTheirDependencies)
+{
+  Journal journal;
+  TaskGraph graph;
+  // Added before the steps it depends on
+  ASSERT_TRUE(graph.AddStep("relocalization", journal.Step("relocalization"), {"activate"}));
+  ASSERT_TRUE(graph.AddStep("activate", journal.Step("activate"), {"map_check"}));
+  ASSERT_TRUE(graph.AddStep("map_check", journal.Step("map_check")));
+  ASSERT_TRUE(graph.AddStep("realsense", journal.Step("realsense")));
+  ASSERT_TRUE(graph.AddStep("done", journal.Step("done"), {"relocalization", "realsense"}));
+
+  EXPECT_TRUE(graph.Run());
+  ASSERT_EQ(journal.Count(), 5u);
+  EXPECT_LT(journal.Position("map_check"), journal.Position("activate"));
+  EXPECT_LT(journal.Position("activate"), journal.Position("relocalization"));
+  EXPECT_LT(journal.Position("relocalization"), journal.Position("done"));
+  EXPECT_LT(journal.Position("realsense"), journal.Position("done"));
+
+  // Reports follow the order the steps were added in
+  const auto & reports = graph.GetReports();
+  ASSERT_EQ(reports.size(), 5u);
+  EXPECT_EQ(reports[0].name, "relocalization");
+  EXPECT_EQ(reports[4].name, "done");
+  for (auto & report : reports) {
+    EXPECT_TRUE(report.success);
+    EXPECT_FALSE(report.skipped);
+  }
+  EXPECT_TRUE(graph.Succeeded("done"));
+}
+
+TEST(TaskGraph, RunsIndependentStepsConcurrently)
+{
+  // Each step waits for the other to have started
+  std::mutex mutex;
+  std::condition_variable cv;
+  int started = 0;
+  auto meet = [&]() {
+      std::unique_lock<std::mutex> lock(mutex);
+      ++started;
+      cv.notify_all();
+      return cv.wait_for(lock, std::chrono::seconds(5), [&]() {return started == 2;});
+    };
+  TaskGraph graph;
+  graph.AddStep("a", meet);
+  graph.AddStep("b", meet);
+  EXPECT_TRUE(graph.Run());
+}
+
+TEST(TaskGraph, SkipsStepsAfterAFailure)
+{
+  Journal journal;
+  TaskGraph graph;
+  graph.AddStep("map_check", journal.Step("map_check", false));
+  graph.AddStep("activate", journal.Step("activate"), {"map_check"});
+  graph.AddStep("relocalization", journal.Step("relocalization"), {"activate", "realsense"});
+  graph.AddStep("realsense", journal.Step("realsense"));
+  graph.AddStep(
+    "throws", []() -> bool {
+      throw std::runtime_error("service unavailable");
+    });
+  graph.AddStep("after_throw", journal.Step("after_throw"), {"throws"});
+
+  EXPECT_FALSE(graph.Run());
+  // Only the failing step and the independent one ran
+  EXPECT_EQ(journal.Count(), 2u);
+  EXPECT_LT(journal.Position("map_check"), 2u);
+  EXPECT_LT(journal.Position("realsense"), 2u);
+
+  const auto & reports = graph.GetReports();
+  ASSERT_EQ(reports.size(), 6u);
+  EXPECT_FALSE(reports[0].success);
+  EXPECT_FALSE(reports[0].skipped);
+  EXPECT_TRUE(reports[1].skipped);
+  EXPECT_TRUE(reports[2].skipped);
+  EXPECT_TRUE(reports[3].success);
+  EXPECT_FALSE(reports[4].success);
+  EXPECT_FALSE(reports[4].skipped);
+  EXPECT_TRUE(reports[5].skipped);
+  EXPECT_TRUE(graph.Succeeded("realsense"));
+  EXPECT_FALSE(graph.Succeeded("activate"));
+  EXPECT_NE(graph.Summary().find("activate skipped"), std::string::npos);
+  EXPECT_NE(graph.Summary().find("failed"), std::string::npos);
+}
+
+TEST(TaskGraph, RejectsCycles)
+{
+  Journal journal;
+  TaskGraph graph;
+  graph.AddStep("a", journal.Step("a"), {"c"});
+  graph.AddStep("b", journal.Step("b"), {"a"});
+  graph.AddStep("c", journal.Step("c"), {"b"});
+  graph.AddStep("independent", journal.Step("independent"));
+
+  EXPECT_FALSE(graph.Run());
+  EXPECT_EQ(journal.Count(), 0u);
+  EXPECT_FALSE(graph.Succeeded("independent"));
+}
+
+TEST(TaskGraph, RejectsUnknownAndDuplicateNames)
+{
+  Journal journal;
+  TaskGraph graph;
+  EXPECT_TRUE(graph.AddStep("a", journal.Step("a")));
+  EXPECT_FALSE(graph.AddStep("a", journal.Step("a again")));
+  EXPECT_TRUE(graph.AddStep("b", journal.Step("b"), {"missing"}));
+
+  EXPECT_FALSE(graph.Run());
+  EXPECT_EQ(journal.Count(), 0u);
+  EXPECT_FALSE(graph.Succeeded("missing"));
+}
+
+}  // namespace algorithm
+}  // namespace cyberdog
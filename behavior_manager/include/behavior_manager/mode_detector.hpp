@@ -31,6 +31,7 @@
 #include "motion_action/motion_macros.hpp"
 #include "ament_index_cpp/get_package_share_directory.hpp"
 #include "cyberdog_common/cyberdog_toml.hpp"
+#include "behavior_manager/sliding_window_filter.hpp"
 
 namespace cyberdog
 {
@@ -71,6 +72,8 @@ public:
     INFO("detect_duration: %d", detect_duration_);
     INFO("pose_topic_name: %s", pose_topic_name_.c_str());
     INFO("filter_size: %d", filter_size_);
+    pose_x_filter_ = SlidingMedian<double>(filter_size_);
+    pose_y_filter_ = SlidingMedian<double>(filter_size_);
     stair_detected_sub_ = node_->create_subscription<std_msgs::msg::Int8>(
       "elevation_mapping/stair_detected",
       rclcpp::SystemDefaultsQoS(),
@@ -121,10 +124,10 @@ public:
     // target_first_get = false;
     // pose_queue_.clear();
     timestamp_.clear();
-    pose_x_.clear();
-    pose_y_.clear();
-    pose_x_filter_.clear();
-    pose_y_filter_.clear();
+    pose_x_.Clear();
+    pose_y_.Clear();
+    pose_x_filter_.Clear();
+    pose_y_filter_.Clear();
     first_pop_ = false;
   }
 
@@ -162,21 +165,13 @@ private:
     }
   }
 
-  double Filter(std::deque<double> & filter, double value)
+  double Filter(SlidingMedian<double> & filter, double value)
   {
-    filter.push_back(value);
-    if (filter.size() < filter_size_) {
+    filter.Push(value);
+    if (filter.Size() < filter.WindowSize()) {
       return value;
     }
-    auto filter_sorted = filter;
-    // INFO("before: [%f],[%f],[%f],[%f],[%f]",
-    // filter[0], filter[1], filter[2], filter[3], filter[4]);
-    std::sort(filter_sorted.begin(), filter_sorted.end());
-    double filtered = filter_sorted.at((filter_size_ - 1) / 2);
-    // INFO("%f", filtered);
-    filter.pop_front();
-    // INFO(" after: [%f],[%f],[%f],[%f]", filter[0], filter[1], filter[2], filter[3]);
-    return filtered;
+    return filter.Median();
   }
   /**
    * @brief
@@ -192,12 +187,8 @@ private:
       INFO("Pose not enough");
       return false;
     }
-    auto max_x = *std::max_element(pose_x_.begin(), pose_x_.end());
-    auto min_x = *std::min_element(pose_x_.begin(), pose_x_.end());
-    auto diff_x = max_x - min_x;
-    auto max_y = *std::max_element(pose_y_.begin(), pose_y_.end());
-    auto min_y = *std::min_element(pose_y_.begin(), pose_y_.end());
-    auto diff_y = max_y - min_y;
+    auto diff_x = pose_x_.Max() - pose_x_.Min();
+    auto diff_y = pose_y_.Max() - pose_y_.Min();
 
     // INFO("diff_x: %f, diff_y: %f", diff_x, diff_y);
     if (diff_x > diff_x_threashold_ || diff_y > diff_y_threashold_) {
@@ -218,16 +209,16 @@ private:
     pose.pose.position.z = msg->pose.position.z;
     pose.pose.orientation = msg->pose.orientation;
     filtered_pose_pub_->publish(pose);
-    pose_x_.push_back(pose_x_filtered);
-    pose_y_.push_back(pose_y_filtered);
+    pose_x_.Push(pose_x_filtered);
+    pose_y_.Push(pose_y_filtered);
     // INFO("back: %d, front: %d", timestamp_.back(), timestamp_.front());
     if (timestamp_.back() - timestamp_.front() < detect_duration_ && !first_pop_) {
       return false;
     }
     first_pop_ = true;
     timestamp_.pop_front();
-    pose_x_.pop_front();
-    pose_y_.pop_front();
+    pose_x_.Pop();
+    pose_y_.Pop();
     return true;
   }
   rclcpp::Node::SharedPtr node_;
@@ -241,8 +232,8 @@ private:
   std::function<void(bool)> do_normal_tracking_func_;
   // std::deque<geometry_msgs::msg::PoseStamped> pose_queue_;
   std::deque<int> timestamp_;
-  std::deque<double> pose_x_, pose_y_;
-  std::deque<double> pose_x_filter_, pose_y_filter_;
+  SlidingMinMax<double> pose_x_, pose_y_;
+  SlidingMedian<double> pose_x_filter_, pose_y_filter_;
   geometry_msgs::msg::PoseStamped target_first;
   geometry_msgs::msg::PoseStamped target_current;
   std::string pose_topic_name_;
@@ -0,0 +1,188 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BEHAVIOR_MANAGER__SLIDING_WINDOW_FILTER_HPP_
+#define BEHAVIOR_MANAGER__SLIDING_WINDOW_FILTER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <set>
+#include <utility>
+
+namespace cyberdog
+{
+namespace algorithm
+{
+/**
+ * @brief 滑动窗口中值滤波，窗口内数据分为较小和较大两半，
+ * 每次加入或移出一个数据的开销为 O(log w)
+ *
+ * @tparam T 数据类型
+ */
+template<typename T>
+class SlidingMedian
+{
+public:
+  explicit SlidingMedian(size_t window_size = 1)
+  : window_size_(window_size > 0 ? window_size : 1)
+  {}
+  /**
+   * @brief 加入一个数据，窗口已满时先移出最早的数据
+   */
+  void Push(const T & value)
+  {
+    if (window_.size() >= window_size_) {
+      Erase(window_.front());
+      window_.pop_front();
+      Balance();
+    }
+    window_.push_back(value);
+    if (low_.empty() || !(*low_.rbegin() < value)) {
+      low_.insert(value);
+    } else {
+      high_.insert(value);
+    }
+    Balance();
+  }
+  /**
+   * @brief 窗口内数据的中值，数据个数为偶数时取较小的一个，窗口不能为空
+   */
+  const T & Median() const
+  {
+    return *low_.rbegin();
+  }
+  size_t Size() const
+  {
+    return window_.size();
+  }
+  size_t WindowSize() const
+  {
+    return window_size_;
+  }
+  void Clear()
+  {
+    window_.clear();
+    low_.clear();
+    high_.clear();
+  }
+
+private:
+  void Erase(const T & value)
+  {
+    // 与 low_ 最大值相等的数据在两半中可以互换，优先从 low_ 中移出
+    if (!(*low_.rbegin() < value)) {
+      low_.erase(low_.find(value));
+    } else {
+      high_.erase(high_.find(value));
+    }
+  }
+  // 保持 low_ 的个数等于 high_ 或比其多一个
+  void Balance()
+  {
+    if (low_.size() > high_.size() + 1) {
+      auto largest = std::prev(low_.end());
+      high_.insert(*largest);
+      low_.erase(largest);
+    } else if (high_.size() > low_.size()) {
+      auto smallest = high_.begin();
+      low_.insert(*smallest);
+      high_.erase(smallest);
+    }
+  }
+  size_t window_size_;
+  std::deque<T> window_;
+  std::multiset<T> low_, high_;
+};  // class SlidingMedian
+
+/**
+ * @brief 滑动窗口最大最小值，用单调队列维护，数据从队尾加入、从队头移出，
+ * 均摊开销为 O(1)
+ *
+ * @tparam T 数据类型
+ */
+template<typename T>
+class SlidingMinMax
+{
+public:
+  /**
+   * @brief 在队尾加入一个数据
+   */
+  void Push(const T & value)
+  {
+    PushMonotonic(max_, value, std::less<T>());
+    PushMonotonic(min_, value, std::greater<T>());
+    ++tail_;
+  }
+  /**
+   * @brief 移出队头最早的数据，窗口不能为空
+   */
+  void Pop()
+  {
+    if (max_.front().first == head_) {
+      max_.pop_front();
+    }
+    if (min_.front().first == head_) {
+      min_.pop_front();
+    }
+    ++head_;
+  }
+  /**
+   * @brief 窗口内的最大值，窗口不能为空
+   */
+  const T & Max() const
+  {
+    return max_.front().second;
+  }
+  /**
+   * @brief 窗口内的最小值，窗口不能为空
+   */
+  const T & Min() const
+  {
+    return min_.front().second;
+  }
+  size_t Size() const
+  {
+    return static_cast<size_t>(tail_ - head_);
+  }
+  bool Empty() const
+  {
+    return head_ == tail_;
+  }
+  void Clear()
+  {
+    max_.clear();
+    min_.clear();
+    head_ = tail_ = 0;
+  }
+
+private:
+  // 队尾起移除所有被新数据支配的数据，队头即为窗口内的最值
+  template<typename Compare>
+  void PushMonotonic(std::deque<std::pair<uint64_t, T>> & queue, const T & value, Compare comp)
+  {
+    while (!queue.empty() && !comp(value, queue.back().second)) {
+      queue.pop_back();
+    }
+    queue.emplace_back(tail_, value);
+  }
+  // 数据序号，队头为 head_，下一个加入的数据为 tail_
+  uint64_t head_{0}, tail_{0};
+  std::deque<std::pair<uint64_t, T>> max_, min_;
+};  // class SlidingMinMax
+}  // namespace algorithm
+}  // namespace cyberdog
+#endif  // BEHAVIOR_MANAGER__SLIDING_WINDOW_FILTER_HPP_
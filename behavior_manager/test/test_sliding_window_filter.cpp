@@ -0,0 +1,163 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "behavior_manager/sliding_window_filter.hpp"
+
+using cyberdog::algorithm::SlidingMedian;
+using cyberdog::algorithm::SlidingMinMax;
+
+namespace
+{
+// Lower median of the window, by sorting it
+int BruteMedian(const std::deque<int> & window)
+{
+  std::vector<int> sorted(window.begin(), window.end());
+  std::sort(sorted.begin(), sorted.end());
+  return sorted[(sorted.size() - 1) / 2];
+}
+
+// Values drawn from a small range, so that the window has many duplicates
+std::vector<int> RandomValues(size_t count, int range, unsigned int seed)
+{
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<int> distribution(-range, range);
+  std::vector<int> values(count);
+  for (auto & value : values) {
+    value = distribution(generator);
+  }
+  return values;
+}
+}  // namespace
+
+TEST(SlidingMedian, MatchesBruteForce)
+{
+  for (size_t window_size : {1, 2, 3, 4, 5, 8, 31}) {
+    for (int range : {2, 1000}) {
+      SlidingMedian<int> median(window_size);
+      std::deque<int> window;
+      for (int value : RandomValues(500, range, window_size * 31 + range)) {
+        median.Push(value);
+        window.push_back(value);
+        if (window.size() > window_size) {
+          window.pop_front();
+        }
+        ASSERT_EQ(median.Size(), window.size());
+        ASSERT_EQ(median.Median(), BruteMedian(window)) <<
+          "window " << window_size << ", range " << range;
+      }
+    }
+  }
+}
+
+TEST(SlidingMedian, EvictsEqualValues)
+{
+  // The value evicted equals the median and is in both halves
+  SlidingMedian<int> median(3);
+  for (int value : {5, 5, 5}) {
+    median.Push(value);
+  }
+  EXPECT_EQ(median.Median(), 5);
+  median.Push(1);
+  EXPECT_EQ(median.Median(), 5);
+  median.Push(1);
+  EXPECT_EQ(median.Median(), 1);
+  median.Push(9);
+  EXPECT_EQ(median.Median(), 1);
+  median.Push(9);
+  EXPECT_EQ(median.Median(), 9);
+}
+
+TEST(SlidingMedian, WindowSizeEdges)
+{
+  // A window size of 0 holds one value
+  SlidingMedian<int> median(0);
+  EXPECT_EQ(median.WindowSize(), 1u);
+  median.Push(3);
+  median.Push(7);
+  EXPECT_EQ(median.Size(), 1u);
+  EXPECT_EQ(median.Median(), 7);
+
+  // Until the window is full, the median is the one of the values so far
+  SlidingMedian<int> partial(10);
+  partial.Push(4);
+  EXPECT_EQ(partial.Median(), 4);
+  partial.Push(2);
+  EXPECT_EQ(partial.Median(), 2);
+  partial.Push(3);
+  EXPECT_EQ(partial.Median(), 3);
+
+  partial.Clear();
+  EXPECT_EQ(partial.Size(), 0u);
+  partial.Push(8);
+  EXPECT_EQ(partial.Median(), 8);
+}
+
+TEST(SlidingMinMax, MatchesBruteForce)
+{
+  for (size_t window_size : {1, 2, 3, 7, 64}) {
+    for (int range : {2, 1000}) {
+      SlidingMinMax<int> min_max;
+      std::deque<int> window;
+      for (int value : RandomValues(500, range, window_size * 17 + range)) {
+        min_max.Push(value);
+        window.push_back(value);
+        if (window.size() > window_size) {
+          min_max.Pop();
+          window.pop_front();
+        }
+        ASSERT_EQ(min_max.Size(), window.size());
+        ASSERT_EQ(min_max.Min(), *std::min_element(window.begin(), window.end()));
+        ASSERT_EQ(min_max.Max(), *std::max_element(window.begin(), window.end())) <<
+          "window " << window_size << ", range " << range;
+      }
+    }
+  }
+}
+
+TEST(SlidingMinMax, PopsToEmpty)
+{
+  SlidingMinMax<int> min_max;
+  EXPECT_TRUE(min_max.Empty());
+  for (int value : {3, 1, 3, 1}) {
+    min_max.Push(value);
+  }
+  // Equal values leave the window one at a time
+  const std::vector<std::pair<int, int>> expected = {{1, 3}, {1, 3}, {1, 1}};
+  for (const auto & min_and_max : expected) {
+    min_max.Pop();
+    EXPECT_EQ(min_max.Min(), min_and_max.first);
+    EXPECT_EQ(min_max.Max(), min_and_max.second);
+  }
+  min_max.Pop();
+  EXPECT_TRUE(min_max.Empty());
+
+  // Usable again once empty, and after Clear
+  min_max.Push(5);
+  EXPECT_EQ(min_max.Min(), 5);
+  EXPECT_EQ(min_max.Max(), 5);
+  min_max.Clear();
+  EXPECT_TRUE(min_max.Empty());
+  min_max.Push(-2);
+  EXPECT_EQ(min_max.Size(), 1u);
+  EXPECT_EQ(min_max.Min(), -2);
+  EXPECT_EQ(min_max.Max(), -2);
+}
@@ -0,0 +1,181 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CYBERDOG_ROSBAG_RECORDER__BAG_RECORDER_HPP_
+#define CYBERDOG_ROSBAG_RECORDER__BAG_RECORDER_HPP_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rosbag2_cpp/writer.hpp"
+#include "rosbag2_storage/serialized_bag_message.hpp"
+#include "rosbag2_storage/topic_metadata.hpp"
+#include "cyberdog_rosbag_recorder/snapshot_buffer.hpp"
+#include "cyberdog_rosbag_recorder/topic_policy.hpp"
+#include "cyberdog_rosbag_recorder/write_queue.hpp"
+
+namespace cyberdog
+{
+namespace rosbag
+{
+
+/**
+ * @brief Records topics into a rosbag2 bag from inside the node, in place of
+ * a `ros2 bag record` process
+ *
+ * Topics are subscribed without a type, messages are kept serialized and
+ * handed through a bounded WriteQueue to a writer thread, which alone uses
+ * the bag writer. Topics that are not published yet are subscribed as soon
+ * as they are discovered.
+ *
+ * In buffering mode messages are only kept in a SnapshotBuffer, and written
+ * to a bag on request by Snapshot(). The latest message of transient local
+ * and OccupancyGrid topics is pinned there, with the costmap updates after it.
+ *
+ * Each topic can have a TopicPolicy, applied before a message is queued or
+ * buffered.
+ */
+class BagRecorder
+{
+public:
+  /**
+   * @brief Construct a new Bag Recorder object
+   *
+   * @param node Node the subscriptions are created on, must outlive the recorder
+   * @param max_queue_size Messages waiting to be written, newer ones are dropped when full
+   */
+  BagRecorder(rclcpp::Node * node, size_t max_queue_size);
+  ~BagRecorder();
+
+  /**
+   * @brief Set the recording policies of topics, takes effect on the next start
+   *
+   * @param policies Policy of each topic, topics without one are recorded as is
+   */
+  void SetPolicies(const std::unordered_map<std::string, TopicPolicy> & policies);
+
+  /**
+   * @brief Set the zstd compression of the bags, takes effect on the next start
+   *
+   * @param mode "none", "message" to compress each message or "file" to compress
+   * each bag file once closed
+   */
+  void SetCompression(const std::string & mode);
+
+  /**
+   * @brief Open a new bag and start recording
+   *
+   * @param uri Bag directory
+   * @param topics Topics to record
+   * @return false if already recording or the bag cannot be opened
+   */
+  bool Start(const std::string & uri, const std::vector<std::string> & topics);
+
+  /**
+   * @brief Start keeping the latest messages in memory, without writing them
+   *
+   * @param topics Topics to keep
+   * @param duration_ns Time span kept
+   * @param max_bytes Serialized size kept
+   * @return false if already recording or buffering
+   */
+  bool StartBuffering(
+    const std::vector<std::string> & topics,
+    int64_t duration_ns, size_t max_bytes);
+
+  /**
+   * @brief Write the buffered messages to a new bag, in the background
+   *
+   * @param uri Bag directory
+   * @return false if not buffering or a snapshot is still being written
+   */
+  bool Snapshot(const std::string & uri);
+
+  /**
+   * @brief Stop recording or buffering. When recording, write the queued
+   * messages and close the bag
+   */
+  void Stop();
+
+  bool IsRecording() const;
+
+  bool IsBuffering() const;
+
+private:
+  /**
+   * @brief Subscribe the topics that became known since the last call
+   */
+  void SubscribeTopics();
+
+  void Subscribe(const std::vector<std::string> & topics);
+
+  static std::unique_ptr<rosbag2_cpp::Writer> OpenWriter(
+    const std::string & uri,
+    const std::string & compression_mode);
+
+  static void WriteSnapshot(
+    const std::string & uri,
+    const std::string & compression_mode,
+    const std::vector<rosbag2_storage::TopicMetadata> & topics,
+    const std::vector<SnapshotBuffer::MessagePtr> & messages);
+
+  rclcpp::QoS AdaptedQoS(const std::string & topic) const;
+
+  /**
+   * @param pin How full messages of the topic are pinned when buffering
+   */
+  void HandleMessage(
+    const std::string & topic,
+    const std::string & updates_topic,
+    const std::shared_ptr<TopicPolicyFilter> & filter,
+    SnapshotBuffer::Pin pin,
+    std::shared_ptr<rclcpp::SerializedMessage> message);
+
+  void WriteLoop();
+
+  rclcpp::Node * node_;
+  std::unordered_map<std::string, TopicPolicy> policies_;
+  std::string compression_mode_{"none"};
+
+  // Subscribed, either recording or buffering
+  std::atomic<bool> active_{false};
+  std::atomic<bool> buffering_{false};
+  std::vector<std::string> topics_;
+  std::unordered_map<std::string, rclcpp::GenericSubscription::SharedPtr> subscriptions_;
+  std::unordered_map<std::string, rosbag2_storage::TopicMetadata> topic_metadata_;
+  rclcpp::TimerBase::SharedPtr discovery_timer_{nullptr};
+  // Guards topics_, subscriptions_, topic_metadata_ and discovery_timer_
+  std::mutex subscriptions_mutex_;
+
+  // Only used by the writer thread while it runs
+  std::unique_ptr<rosbag2_cpp::Writer> writer_{nullptr};
+  std::unique_ptr<std::thread> writer_thread_{nullptr};
+  WriteQueue write_queue_;
+
+  std::mutex snapshot_mutex_;
+  SnapshotBuffer snapshot_buffer_{0, 0};
+  std::atomic<bool> snapshot_writing_{false};
+  std::unique_ptr<std::thread> snapshot_thread_{nullptr};
+};
+}  // namespace rosbag
+}  // namespace cyberdog
+
+#endif  // CYBERDOG_ROSBAG_RECORDER__BAG_RECORDER_HPP_
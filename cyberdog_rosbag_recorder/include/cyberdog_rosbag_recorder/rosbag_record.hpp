@@ -30,6 +30,7 @@
 #include "std_msgs/msg/string.hpp"
 #include "std_srvs/srv/set_bool.hpp"
 #include "protocol/msg/algo_task_status.hpp"
+#include "cyberdog_rosbag_recorder/bag_recorder.hpp"
 
 namespace cyberdog
 {
@@ -52,6 +53,8 @@ private:
 
   void GetParams();
 
+  std::string NamespacedTopic(const std::string & topic);
+
   bool CheckUseRosbag();
 
   std::vector<std::string> GetTopics();
@@ -64,6 +67,11 @@ private:
 
   void StartTask();
 
+  /**
+   * @brief Write the buffered messages to a new bag, snapshot mode only
+   */
+  bool WriteSnapshot();
+
   void StopTask();
 
   std::string GetRosbagFilePath();
@@ -83,6 +91,17 @@ private:
   bool stop_{false};
   bool use_rosbag_record_{false};
   bool use_nav_record_{false};
+  // Record with BagRecorder instead of a `ros2 bag record` process
+  bool in_process_{false};
+  size_t max_queue_size_{1000};
+  // Keep the latest messages in memory and only write them on trigger or task failure
+  bool snapshot_{false};
+  double snapshot_duration_{30.0};
+  size_t snapshot_max_megabytes_{200};
+  bool task_failed_{false};
+  // Recording policy of each topic and zstd compression, in_process only
+  std::unordered_map<std::string, TopicPolicy> policies_;
+  std::string compression_{"none"};
   std::string rosbag_file_path_;
   std::vector<std::string> topics_;
 
@@ -92,6 +111,7 @@ private:
   rclcpp::Service<std_srvs::srv::SetBool>::SharedPtr nav_stop_server_{nullptr};
   rclcpp::Service<std_srvs::srv::SetBool>::SharedPtr server_{nullptr};
   rclcpp::Subscription<protocol::msg::AlgoTaskStatus>::SharedPtr navigator_status_sub_{nullptr};
+  std::unique_ptr<BagRecorder> bag_recorder_{nullptr};
 };
 }  // namespace rosbag
 }  // namespace cyberdog
@@ -0,0 +1,107 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CYBERDOG_ROSBAG_RECORDER__SNAPSHOT_BUFFER_HPP_
+#define CYBERDOG_ROSBAG_RECORDER__SNAPSHOT_BUFFER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "rosbag2_storage/serialized_bag_message.hpp"
+
+namespace cyberdog
+{
+namespace rosbag
+{
+
+/**
+ * @brief The most recent serialized messages, bounded both by their time
+ * span and by their total size, oldest ones dropped first
+ *
+ * Pinned messages are kept even once dropped, outside of the bounds, for
+ * what a bag cannot be read without: the latched messages of a topic, or a
+ * costmap keyframe with the updates made on top of it.
+ */
+class SnapshotBuffer
+{
+public:
+  using MessagePtr = std::shared_ptr<rosbag2_storage::SerializedBagMessage>;
+
+  enum class Pin
+  {
+    kNone,
+    // Replace the messages pinned under the key
+    kLatest,
+    // Add to the messages pinned under the key, if there are any
+    kAppend,
+    // Add to the messages pinned under the key, unless the same bytes are
+    // already pinned
+    kAccumulate,
+  };
+
+  /**
+   * @brief Construct a new Snapshot Buffer object
+   *
+   * @param duration_ns Time span kept, relative to the newest message
+   * @param max_bytes Serialized size kept
+   */
+  SnapshotBuffer(int64_t duration_ns, size_t max_bytes);
+
+  /**
+   * @brief Change the bounds, dropping messages that no longer fit
+   */
+  void Configure(int64_t duration_ns, size_t max_bytes);
+
+  /**
+   * @brief Add a message
+   *
+   * @param message Message
+   * @param pin How the message is pinned
+   * @param pin_key Key it is pinned under, its topic if empty
+   */
+  void Push(MessagePtr message, Pin pin = Pin::kNone, const std::string & pin_key = "");
+
+  /**
+   * @brief Messages to write, oldest first: the pinned messages no longer in
+   * the buffer, then the buffer
+   */
+  std::vector<MessagePtr> Messages() const;
+
+  size_t Size() const {return messages_.size();}
+
+  /**
+   * @brief Serialized size of the buffer, pinned messages dropped from it excluded
+   */
+  size_t Bytes() const {return bytes_;}
+
+  void Clear();
+
+private:
+  void Trim();
+
+  int64_t duration_ns_;
+  size_t max_bytes_;
+  std::deque<MessagePtr> messages_;
+  size_t bytes_{0};
+  std::unordered_map<std::string, std::vector<MessagePtr>> pinned_;
+};
+}  // namespace rosbag
+}  // namespace cyberdog
+
+#endif  // CYBERDOG_ROSBAG_RECORDER__SNAPSHOT_BUFFER_HPP_
@@ -0,0 +1,95 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CYBERDOG_ROSBAG_RECORDER__TOPIC_POLICY_HPP_
+#define CYBERDOG_ROSBAG_RECORDER__TOPIC_POLICY_HPP_
+
+#include <cstdint>
+#include <memory>
+
+#include "nav_msgs/msg/occupancy_grid.hpp"
+#include "rclcpp/serialized_message.hpp"
+
+namespace cyberdog
+{
+namespace rosbag
+{
+
+/**
+ * @brief How the messages of a topic are recorded
+ */
+struct TopicPolicy
+{
+  // Messages per second kept, 0 for all of them
+  double max_rate{0.0};
+  // Drop messages whose serialized content equals the last one kept
+  bool on_change{false};
+  // nav_msgs/msg/OccupancyGrid only: between full grids, keep only the
+  // changed cells as a map_msgs/msg/OccupancyGridUpdate on <topic>_updates.
+  // Turned off for rolling costmaps, whose origin changes all the time.
+  bool costmap_delta{false};
+  // With costmap_delta, a full grid is kept after this many updates
+  int keyframe_interval{10};
+};
+
+/**
+ * @brief Applies a TopicPolicy to the serialized messages of one topic
+ */
+class TopicPolicyFilter
+{
+public:
+  enum class Result
+  {
+    kDrop,
+    kKeep,
+    // The message was replaced by an OccupancyGridUpdate
+    kKeepUpdate,
+  };
+
+  explicit TopicPolicyFilter(const TopicPolicy & policy);
+
+  /**
+   * @brief Decide whether a message is recorded
+   *
+   * @param stamp_ns Receive time of the message
+   * @param message Serialized message, replaced when kKeepUpdate is returned
+   * @return Result
+   */
+  Result Filter(int64_t stamp_ns, std::shared_ptr<rclcpp::SerializedMessage> & message);
+
+  /**
+   * @brief Keep the next costmap whole, e.g. because a kept message was lost
+   * and the updates after it would not apply
+   */
+  void RequestKeyframe();
+
+private:
+  Result FilterCostmap(std::shared_ptr<rclcpp::SerializedMessage> & message);
+
+  TopicPolicy policy_;
+  int64_t min_period_ns_{0};
+  int64_t last_stamp_ns_{0};
+  bool has_last_{false};
+  uint64_t last_hash_{0};
+
+  nav_msgs::msg::OccupancyGrid previous_grid_;
+  bool has_previous_grid_{false};
+  int updates_since_keyframe_{0};
+  // Keyframes kept in a row because the grid geometry changed
+  int geometry_changes_{0};
+};
+}  // namespace rosbag
+}  // namespace cyberdog
+
+#endif  // CYBERDOG_ROSBAG_RECORDER__TOPIC_POLICY_HPP_
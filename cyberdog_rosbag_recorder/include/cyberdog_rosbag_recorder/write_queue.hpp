@@ -0,0 +1,96 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CYBERDOG_ROSBAG_RECORDER__WRITE_QUEUE_HPP_
+#define CYBERDOG_ROSBAG_RECORDER__WRITE_QUEUE_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "rosbag2_storage/serialized_bag_message.hpp"
+#include "rosbag2_storage/topic_metadata.hpp"
+
+namespace cyberdog
+{
+namespace rosbag
+{
+
+/**
+ * @brief Work handed to the bag writer thread: topics to create and
+ * messages to write
+ *
+ * Topics are queued here too, so that only the writer thread uses the writer
+ * and nothing waits on a disk write. They are never dropped, and are taken
+ * with or before the messages queued after them.
+ */
+class WriteQueue
+{
+public:
+  using MessagePtr = std::shared_ptr<rosbag2_storage::SerializedBagMessage>;
+
+  /**
+   * @brief Construct a new Write Queue object
+   *
+   * @param max_size Messages waiting to be written, newer ones are dropped when full
+   */
+  explicit WriteQueue(size_t max_size);
+
+  /**
+   * @brief Empty the queue and accept messages again
+   */
+  void Reset();
+
+  void AddTopic(const rosbag2_storage::TopicMetadata & topic);
+
+  /**
+   * @brief Queue a message
+   *
+   * @return false if stopped, or if full, in which case the message counts
+   * as dropped
+   */
+  bool Push(MessagePtr message);
+
+  /**
+   * @brief Wait for topics or messages and take all of them
+   *
+   * @return false once stopped and everything queued before was taken
+   */
+  bool Take(
+    std::vector<rosbag2_storage::TopicMetadata> & topics,
+    std::deque<MessagePtr> & messages);
+
+  /**
+   * @brief Refuse new messages and wake up Take
+   */
+  void Stop();
+
+  size_t Dropped() const;
+
+private:
+  size_t max_size_;
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::vector<rosbag2_storage::TopicMetadata> topics_;
+  std::deque<MessagePtr> messages_;
+  bool stopping_{false};
+  size_t dropped_{0};
+};
+}  // namespace rosbag
+}  // namespace cyberdog
+
+#endif  // CYBERDOG_ROSBAG_RECORDER__WRITE_QUEUE_HPP_
@@ -0,0 +1,457 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cyberdog_rosbag_recorder/bag_recorder.hpp"
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rmw/rmw.h"
+#include "rosbag2_compression/compression_options.hpp"
+#include "rosbag2_compression/sequential_compression_writer.hpp"
+#include "rosbag2_cpp/converter_options.hpp"
+#include "rosbag2_storage/storage_options.hpp"
+#include "rosbag2_storage/topic_metadata.hpp"
+#include "cyberdog_common/cyberdog_log.hpp"
+
+namespace cyberdog
+{
+namespace rosbag
+{
+
+namespace
+{
+// Fully qualified topic name, "//a/b" and "a/b" both give "/a/b"
+std::string NormalizeTopic(const std::string & topic)
+{
+  std::string normalized = "/";
+  for (char c : topic) {
+    if (c != '/' || normalized.back() != '/') {
+      normalized.push_back(c);
+    }
+  }
+  if (normalized.size() > 1 && normalized.back() == '/') {
+    normalized.pop_back();
+  }
+  return normalized;
+}
+}  // namespace
+
+BagRecorder::BagRecorder(rclcpp::Node * node, size_t max_queue_size)
+: node_(node), write_queue_(max_queue_size)
+{
+}
+
+BagRecorder::~BagRecorder()
+{
+  Stop();
+  if (snapshot_thread_ && snapshot_thread_->joinable()) {
+    snapshot_thread_->join();
+  }
+}
+
+void BagRecorder::SetPolicies(const std::unordered_map<std::string, TopicPolicy> & policies)
+{
+  std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+  policies_.clear();
+  for (const auto & policy : policies) {
+    policies_[NormalizeTopic(policy.first)] = policy.second;
+  }
+}
+
+void BagRecorder::SetCompression(const std::string & mode)
+{
+  std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+  compression_mode_ = mode;
+}
+
+bool BagRecorder::Start(const std::string & uri, const std::vector<std::string> & topics)
+{
+  if (active_) {
+    return false;
+  }
+
+  std::string compression_mode;
+  {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    compression_mode = compression_mode_;
+  }
+  writer_ = OpenWriter(uri, compression_mode);
+  if (!writer_) {
+    return false;
+  }
+  write_queue_.Reset();
+  writer_thread_ = std::make_unique<std::thread>(&BagRecorder::WriteLoop, this);
+
+  buffering_ = false;
+  Subscribe(topics);
+  INFO("Recording rosbag %s", uri.c_str());
+  return true;
+}
+
+bool BagRecorder::StartBuffering(
+  const std::vector<std::string> & topics,
+  int64_t duration_ns, size_t max_bytes)
+{
+  if (active_) {
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    snapshot_buffer_.Clear();
+    snapshot_buffer_.Configure(duration_ns, max_bytes);
+  }
+  buffering_ = true;
+  Subscribe(topics);
+  INFO(
+    "Keeping the last %.1f s of messages, up to %zu bytes, for snapshots.",
+    duration_ns * 1e-9, max_bytes);
+  return true;
+}
+
+bool BagRecorder::Snapshot(const std::string & uri)
+{
+  if (!active_ || !buffering_) {
+    return false;
+  }
+  if (snapshot_writing_.exchange(true)) {
+    WARN("Previous rosbag snapshot is still being written.");
+    return false;
+  }
+  if (snapshot_thread_ && snapshot_thread_->joinable()) {
+    snapshot_thread_->join();
+  }
+
+  // Messages are shared with the buffer, nothing is copied
+  std::vector<SnapshotBuffer::MessagePtr> messages;
+  {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    messages = snapshot_buffer_.Messages();
+  }
+  std::vector<rosbag2_storage::TopicMetadata> topics;
+  std::string compression_mode;
+  {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    for (const auto & metadata : topic_metadata_) {
+      topics.push_back(metadata.second);
+    }
+    compression_mode = compression_mode_;
+  }
+
+  INFO("Writing rosbag snapshot %s with %zu messages.", uri.c_str(), messages.size());
+  snapshot_thread_ = std::make_unique<std::thread>(
+    [this, uri, compression_mode, topics = std::move(topics), messages = std::move(messages)]() {
+      WriteSnapshot(uri, compression_mode, topics, messages);
+      snapshot_writing_ = false;
+    });
+  return true;
+}
+
+void BagRecorder::Subscribe(const std::vector<std::string> & topics)
+{
+  {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    topics_.clear();
+    for (const auto & topic : topics) {
+      topics_.push_back(NormalizeTopic(topic));
+    }
+    topic_metadata_.clear();
+  }
+  active_ = true;
+  SubscribeTopics();
+
+  std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+  discovery_timer_ = node_->create_wall_timer(
+    std::chrono::seconds(1), [this]() {SubscribeTopics();});
+}
+
+void BagRecorder::Stop()
+{
+  if (!active_.exchange(false)) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    if (discovery_timer_) {
+      discovery_timer_->cancel();
+      discovery_timer_.reset();
+    }
+    subscriptions_.clear();
+  }
+  if (buffering_) {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    snapshot_buffer_.Clear();
+    INFO("Rosbag snapshot buffering stopped.");
+    return;
+  }
+
+  write_queue_.Stop();
+  writer_thread_->join();
+  writer_thread_.reset();
+
+  // Destroying the writer closes the bag and writes its metadata
+  writer_.reset();
+  const size_t dropped = write_queue_.Dropped();
+  if (dropped > 0) {
+    WARN("Rosbag writer fell behind, %zu messages dropped.", dropped);
+  }
+  INFO("Rosbag closed.");
+}
+
+bool BagRecorder::IsRecording() const
+{
+  return active_ && !buffering_;
+}
+
+bool BagRecorder::IsBuffering() const
+{
+  return active_ && buffering_;
+}
+
+std::unique_ptr<rosbag2_cpp::Writer> BagRecorder::OpenWriter(
+  const std::string & uri,
+  const std::string & compression_mode)
+{
+  rosbag2_storage::StorageOptions storage_options;
+  storage_options.uri = uri;
+  storage_options.storage_id = "sqlite3";
+  rosbag2_cpp::ConverterOptions converter_options;
+  converter_options.input_serialization_format = rmw_get_serialization_format();
+  converter_options.output_serialization_format = rmw_get_serialization_format();
+
+  std::unique_ptr<rosbag2_cpp::Writer> writer;
+  try {
+    if (compression_mode.empty() || compression_mode == "none") {
+      writer = std::make_unique<rosbag2_cpp::Writer>();
+    } else {
+      rosbag2_compression::CompressionOptions compression_options;
+      compression_options.compression_format = "zstd";
+      compression_options.compression_mode =
+        rosbag2_compression::compression_mode_from_string(compression_mode);
+      writer = std::make_unique<rosbag2_cpp::Writer>(
+        std::make_unique<rosbag2_compression::SequentialCompressionWriter>(compression_options));
+    }
+    writer->open(storage_options, converter_options);
+  } catch (const std::exception & e) {
+    ERROR("Cannot open rosbag %s: %s", uri.c_str(), e.what());
+    return nullptr;
+  }
+  return writer;
+}
+
+void BagRecorder::WriteSnapshot(
+  const std::string & uri,
+  const std::string & compression_mode,
+  const std::vector<rosbag2_storage::TopicMetadata> & topics,
+  const std::vector<SnapshotBuffer::MessagePtr> & messages)
+{
+  auto writer = OpenWriter(uri, compression_mode);
+  if (!writer) {
+    return;
+  }
+  try {
+    for (const auto & metadata : topics) {
+      writer->create_topic(metadata);
+    }
+    for (const auto & message : messages) {
+      writer->write(message);
+    }
+  } catch (const std::exception & e) {
+    ERROR("Failed to write rosbag snapshot %s: %s", uri.c_str(), e.what());
+  }
+  writer.reset();
+  INFO("Rosbag snapshot %s closed.", uri.c_str());
+}
+
+void BagRecorder::SubscribeTopics()
+{
+  if (!active_) {
+    return;
+  }
+
+  auto names_and_types = node_->get_topic_names_and_types();
+  std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+  // Stop() may have run while the topics were listed
+  if (!active_) {
+    return;
+  }
+  for (const auto & topic : topics_) {
+    if (subscriptions_.count(topic) > 0) {
+      continue;
+    }
+    auto found = names_and_types.find(topic);
+    if (found == names_and_types.end() || found->second.empty()) {
+      continue;
+    }
+    const std::string & type = found->second.front();
+
+    std::vector<rosbag2_storage::TopicMetadata> metadata(1);
+    metadata[0].name = topic;
+    metadata[0].type = type;
+    metadata[0].serialization_format = rmw_get_serialization_format();
+
+    std::shared_ptr<TopicPolicyFilter> filter;
+    const std::string updates_topic = topic + "_updates";
+    auto policy = policies_.find(topic);
+    if (policy != policies_.end()) {
+      TopicPolicy topic_policy = policy->second;
+      if (topic_policy.costmap_delta && type != "nav_msgs/msg/OccupancyGrid") {
+        WARN("costmap_delta ignored for %s of type %s.", topic.c_str(), type.c_str());
+        topic_policy.costmap_delta = false;
+      }
+      if (topic_policy.costmap_delta) {
+        metadata.push_back(metadata[0]);
+        metadata[1].name = updates_topic;
+        metadata[1].type = "map_msgs/msg/OccupancyGridUpdate";
+      }
+      filter = std::make_shared<TopicPolicyFilter>(topic_policy);
+    }
+
+    // Created by the writer thread before it writes the first message
+    for (const auto & topic_metadata : metadata) {
+      if (!buffering_) {
+        write_queue_.AddTopic(topic_metadata);
+      }
+      topic_metadata_[topic_metadata.name] = topic_metadata;
+    }
+
+    // Latched messages and costmaps are needed to make sense of a snapshot.
+    // A new grid replaces the previous one, while each publisher of a latched
+    // topic such as /tf_static has its own latched message.
+    const rclcpp::QoS qos = AdaptedQoS(topic);
+    SnapshotBuffer::Pin pin = SnapshotBuffer::Pin::kNone;
+    if (type == "nav_msgs/msg/OccupancyGrid") {
+      pin = SnapshotBuffer::Pin::kLatest;
+    } else if (qos.get_rmw_qos_profile().durability == RMW_QOS_POLICY_DURABILITY_TRANSIENT_LOCAL) {
+      pin = SnapshotBuffer::Pin::kAccumulate;
+    }
+    subscriptions_[topic] = node_->create_generic_subscription(
+      topic, type, qos,
+      [this, topic, updates_topic, filter, pin](
+        std::shared_ptr<rclcpp::SerializedMessage> message) {
+        HandleMessage(topic, updates_topic, filter, pin, message);
+      });
+    INFO("Recording topic %s [%s]", topic.c_str(), type.c_str());
+  }
+}
+
+rclcpp::QoS BagRecorder::AdaptedQoS(const std::string & topic) const
+{
+  // Reliable unless a publisher is best effort, transient local if all publishers are
+  rclcpp::QoS qos(rclcpp::KeepLast(100));
+  auto publishers = node_->get_publishers_info_by_topic(topic);
+  if (publishers.empty()) {
+    return qos;
+  }
+  bool all_transient_local = true;
+  for (const auto & publisher : publishers) {
+    const auto profile = publisher.qos_profile().get_rmw_qos_profile();
+    if (profile.reliability == RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT) {
+      qos.best_effort();
+    }
+    if (profile.durability != RMW_QOS_POLICY_DURABILITY_TRANSIENT_LOCAL) {
+      all_transient_local = false;
+    }
+  }
+  if (all_transient_local) {
+    qos.transient_local();
+  }
+  return qos;
+}
+
+void BagRecorder::HandleMessage(
+  const std::string & topic,
+  const std::string & updates_topic,
+  const std::shared_ptr<TopicPolicyFilter> & filter,
+  SnapshotBuffer::Pin pin,
+  std::shared_ptr<rclcpp::SerializedMessage> message)
+{
+  if (!active_) {
+    return;
+  }
+
+  const int64_t stamp_ns = node_->now().nanoseconds();
+  const std::string * topic_name = &topic;
+  if (filter) {
+    switch (filter->Filter(stamp_ns, message)) {
+      case TopicPolicyFilter::Result::kDrop:
+        return;
+      case TopicPolicyFilter::Result::kKeepUpdate:
+        topic_name = &updates_topic;
+        break;
+      case TopicPolicyFilter::Result::kKeep:
+        break;
+    }
+  }
+
+  // Take over the serialized buffer instead of copying it
+  auto bag_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  bag_message->topic_name = *topic_name;
+  bag_message->time_stamp = stamp_ns;
+  bag_message->serialized_data = std::shared_ptr<rcutils_uint8_array_t>(
+    new rcutils_uint8_array_t,
+    [](rcutils_uint8_array_t * data) {
+      rcutils_uint8_array_fini(data);
+      delete data;
+    });
+  *bag_message->serialized_data = message->release_rcl_serialized_message();
+
+  if (buffering_) {
+    // Costmap updates are pinned along with the keyframe they apply to
+    if (topic_name == &updates_topic) {
+      pin = SnapshotBuffer::Pin::kAppend;
+    }
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    snapshot_buffer_.Push(std::move(bag_message), pin, topic);
+    return;
+  }
+
+  if (!write_queue_.Push(std::move(bag_message)) && filter) {
+    // Later costmap updates would apply to a grid missing from the bag
+    filter->RequestKeyframe();
+  }
+}
+
+void BagRecorder::WriteLoop()
+{
+  std::vector<rosbag2_storage::TopicMetadata> topics;
+  std::deque<WriteQueue::MessagePtr> batch;
+  while (write_queue_.Take(topics, batch)) {
+    for (const auto & topic : topics) {
+      try {
+        writer_->create_topic(topic);
+      } catch (const std::exception & e) {
+        ERROR("Failed to create topic %s in rosbag: %s", topic.name.c_str(), e.what());
+      }
+    }
+    for (const auto & message : batch) {
+      try {
+        writer_->write(message);
+      } catch (const std::exception & e) {
+        ERROR("Failed to write %s to rosbag: %s", message->topic_name.c_str(), e.what());
+      }
+    }
+    topics.clear();
+    batch.clear();
+  }
+}
+
+}  // namespace rosbag
+}  // namespace cyberdog
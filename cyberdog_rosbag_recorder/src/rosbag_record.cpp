@@ -41,6 +41,20 @@ TopicsRecorder::TopicsRecorder()
   GetParams();
 
   if (CheckUseRosbag()) {
+    if (in_process_) {
+      bag_recorder_ = std::make_unique<BagRecorder>(this, max_queue_size_);
+      bag_recorder_->SetPolicies(policies_);
+      bag_recorder_->SetCompression(compression_);
+    } else {
+      if (snapshot_) {
+        WARN("Rosbag snapshot needs in_process recording, snapshot is not use.");
+        snapshot_ = false;
+      }
+      if (!policies_.empty() || compression_ != "none") {
+        WARN("Topic policies and compression need in_process recording, they are not use.");
+      }
+    }
+
     server_ = create_service<std_srvs::srv::SetBool>(
       "rosbag_snapshot_trigger",
       std::bind(
@@ -51,6 +65,13 @@ TopicsRecorder::TopicsRecorder()
       "algo_task_status", 10,
       std::bind(&TopicsRecorder::HandleAlgoTaskStatusMessage, this, std::placeholders::_1));
 
+    if (snapshot_) {
+      bag_recorder_->StartBuffering(
+        topics_, static_cast<int64_t>(snapshot_duration_ * 1e9),
+        snapshot_max_megabytes_ * 1024 * 1024);
+      return;
+    }
+
     start_thread_ = std::make_unique<std::thread>(std::bind(&TopicsRecorder::StartTask, this));
     stop_thread_ = std::make_unique<std::thread>(std::bind(&TopicsRecorder::StopTask, this));
   }
@@ -69,6 +90,11 @@ void TopicsRecorder::SnapshotServiceCallback(
   const std::shared_ptr<std_srvs::srv::SetBool::Request> request,
   std::shared_ptr<std_srvs::srv::SetBool::Response> response)
 {
+  if (snapshot_) {
+    response->success = request->data ? WriteSnapshot() : true;
+    return;
+  }
+
   if (request->data) {
     // std::unique_lock<std::mutex> locker(mutex_);
     start_ = true;
@@ -104,6 +130,19 @@ void TopicsRecorder::HandleAlgoTaskStatusMessage(const protocol::msg::AlgoTaskSt
   constexpr uint8_t kNavStatusVisionRunning = 21;
   constexpr uint8_t kNavStatusIdle = 101;
   constexpr uint8_t kNavStatusStopping = 103;
+  constexpr uint8_t kNavStatusLidarLocalizationFailed = 6;
+  constexpr uint8_t kNavStatusVisionLocalizationFailed = 16;
+
+  if (snapshot_) {
+    bool task_failed = (msg->task_status == kNavStatusLidarLocalizationFailed ||
+      msg->task_status == kNavStatusVisionLocalizationFailed);
+    if (task_failed && !task_failed_) {
+      INFO("Task failed, writing rosbag snapshot.");
+      WriteSnapshot();
+    }
+    task_failed_ = task_failed;
+    return;
+  }
 
   if (msg->task_status == kNavStatusLidarRunning || msg->task_status == kNavStatusVisionRunning) {
     if (start_) {
@@ -156,21 +195,51 @@ void TopicsRecorder::GetParams()
   // rosbag file path
   rosbag_file_path_ = toml::find<std::string>(toml_topics, "rosbag_file_path");
 
+  // recording engine, optional, without them `ros2 bag record` is run as before
+  in_process_ = toml::find_or<bool>(toml_topics, "in_process", in_process_);
+  max_queue_size_ = toml::find_or<size_t>(toml_topics, "max_queue_size", max_queue_size_);
+  snapshot_ = toml::find_or<bool>(toml_topics, "snapshot", snapshot_);
+  snapshot_duration_ = toml::find_or<double>(toml_topics, "snapshot_duration", snapshot_duration_);
+  snapshot_max_megabytes_ =
+    toml::find_or<size_t>(toml_topics, "snapshot_max_megabytes", snapshot_max_megabytes_);
+  compression_ = toml::find_or<std::string>(toml_topics, "compression", compression_);
+
   auto topics = toml::find<std::vector<std::string>>(toml_topics, "topics");
   std::vector<std::string> rosbag_topics;
 
   for (auto topic : topics) {
-    auto namespace_topic = this->get_namespace() + std::string("/") + topic;
-    INFO("topic: %s", namespace_topic.c_str());
-
-    if (topic == "tf_static" || topic == "tf") {
-      rosbag_topics.push_back(topic);
-    } else {
-      rosbag_topics.push_back(namespace_topic);
-    }
+    INFO("topic: %s", NamespacedTopic(topic).c_str());
+    rosbag_topics.push_back(NamespacedTopic(topic));
   }
 
   topics_ = rosbag_topics;
+
+  // per topic recording policies, optional
+  if (toml_topics.as_table().count("policies") == 0) {
+    return;
+  }
+  for (const auto & item : toml::find<toml::array>(toml_topics, "policies")) {
+    auto topic = toml::find<std::string>(item, "topic");
+    TopicPolicy policy;
+    policy.max_rate = toml::find_or<double>(item, "max_rate", policy.max_rate);
+    policy.on_change = toml::find_or<bool>(item, "on_change", policy.on_change);
+    policy.costmap_delta = toml::find_or<bool>(item, "costmap_delta", policy.costmap_delta);
+    policy.keyframe_interval =
+      toml::find_or<int>(item, "keyframe_interval", policy.keyframe_interval);
+    INFO(
+      "policy of %s: max_rate %f, on_change %d, costmap_delta %d, keyframe_interval %d",
+      topic.c_str(), policy.max_rate, policy.on_change, policy.costmap_delta,
+      policy.keyframe_interval);
+    policies_[NamespacedTopic(topic)] = policy;
+  }
+}
+
+std::string TopicsRecorder::NamespacedTopic(const std::string & topic)
+{
+  if (topic == "tf_static" || topic == "tf") {
+    return topic;
+  }
+  return this->get_namespace() + std::string("/") + topic;
 }
 
 bool TopicsRecorder::CheckUseRosbag()
@@ -189,6 +258,14 @@ void TopicsRecorder::Start(const std::vector<std::string> & topics)
   std::string cmd = "ros2 bag record -o " + filename + " ";
 
   INFO("rosbag filename: %s", filename.c_str());
+  if (bag_recorder_) {
+    // Returns at once, start_ is cleared when recording stops
+    if (!bag_recorder_->Start(filename, topics)) {
+      start_ = false;
+    }
+    return;
+  }
+
   for (auto topic : topics) {
     auto cmd_str = topic + " ";
     cmd += cmd_str;
@@ -200,6 +277,12 @@ void TopicsRecorder::Start(const std::vector<std::string> & topics)
 
 void TopicsRecorder::Stop()
 {
+  if (bag_recorder_) {
+    bag_recorder_->Stop();
+    stop_ = false;
+    return;
+  }
+
   std::string cmd = "ps -ef | grep \"ros2 bag record -o\" | grep -v grep | awk '{print $2}'";
   pid_t pid;
   auto result = ExecuteCmdLineAndGetPID(cmd, pid);
@@ -220,7 +303,8 @@ void TopicsRecorder::StartTask()
 {
   while (true) {
     std::unique_lock<std::mutex> locker(start_mutex_);
-    cond_start_.wait(locker, [this] {return start_;});
+    cond_start_.wait(
+      locker, [this] {return start_ && !(bag_recorder_ && bag_recorder_->IsRecording());});
 
     if (start_) {
       auto topics = GetTopics();
@@ -232,6 +316,12 @@ void TopicsRecorder::StartTask()
   }
 }
 
+bool TopicsRecorder::WriteSnapshot()
+{
+  std::string filename = GetRosbagFilePath() + "/snapshot-" + TimeAsStr();
+  return bag_recorder_->Snapshot(filename);
+}
+
 void TopicsRecorder::StopTask()
 {
   while (true) {
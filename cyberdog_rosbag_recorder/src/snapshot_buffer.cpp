@@ -0,0 +1,129 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cyberdog_rosbag_recorder/snapshot_buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace cyberdog
+{
+namespace rosbag
+{
+
+namespace
+{
+size_t MessageBytes(const SnapshotBuffer::MessagePtr & message)
+{
+  return message->serialized_data ? message->serialized_data->buffer_length : 0;
+}
+
+bool SameBytes(const SnapshotBuffer::MessagePtr & a, const SnapshotBuffer::MessagePtr & b)
+{
+  const size_t bytes = MessageBytes(a);
+  if (bytes != MessageBytes(b)) {
+    return false;
+  }
+  return bytes == 0 ||
+         std::memcmp(a->serialized_data->buffer, b->serialized_data->buffer, bytes) == 0;
+}
+}  // namespace
+
+SnapshotBuffer::SnapshotBuffer(int64_t duration_ns, size_t max_bytes)
+: duration_ns_(duration_ns), max_bytes_(max_bytes)
+{
+}
+
+void SnapshotBuffer::Configure(int64_t duration_ns, size_t max_bytes)
+{
+  duration_ns_ = duration_ns;
+  max_bytes_ = max_bytes;
+  Trim();
+}
+
+void SnapshotBuffer::Push(MessagePtr message, Pin pin, const std::string & pin_key)
+{
+  if (pin != Pin::kNone) {
+    auto & pinned = pinned_[pin_key.empty() ? message->topic_name : pin_key];
+    if (pin == Pin::kLatest) {
+      pinned.assign(1, message);
+    } else if (pin == Pin::kAccumulate) {
+      // Publishers of a latched topic each have their own latched message
+      auto same = std::find_if(
+        pinned.begin(), pinned.end(),
+        [&message](const MessagePtr & other) {return SameBytes(message, other);});
+      if (same == pinned.end()) {
+        pinned.push_back(message);
+      }
+    } else if (!pinned.empty()) {
+      pinned.push_back(message);
+    }
+  }
+  bytes_ += MessageBytes(message);
+  messages_.push_back(std::move(message));
+  Trim();
+}
+
+std::vector<SnapshotBuffer::MessagePtr> SnapshotBuffer::Messages() const
+{
+  std::unordered_set<const rosbag2_storage::SerializedBagMessage *> dropped;
+  for (const auto & pinned : pinned_) {
+    for (const auto & message : pinned.second) {
+      dropped.insert(message.get());
+    }
+  }
+  for (const auto & message : messages_) {
+    dropped.erase(message.get());
+  }
+
+  // Dropped messages are older than the buffer
+  std::vector<MessagePtr> messages;
+  for (const auto & pinned : pinned_) {
+    for (const auto & message : pinned.second) {
+      if (dropped.count(message.get()) > 0) {
+        messages.push_back(message);
+      }
+    }
+  }
+  std::stable_sort(
+    messages.begin(), messages.end(),
+    [](const MessagePtr & a, const MessagePtr & b) {return a->time_stamp < b->time_stamp;});
+  messages.insert(messages.end(), messages_.begin(), messages_.end());
+  return messages;
+}
+
+void SnapshotBuffer::Clear()
+{
+  messages_.clear();
+  bytes_ = 0;
+  pinned_.clear();
+}
+
+void SnapshotBuffer::Trim()
+{
+  while (!messages_.empty() &&
+    (bytes_ > max_bytes_ ||
+    messages_.back()->time_stamp - messages_.front()->time_stamp > duration_ns_))
+  {
+    bytes_ -= MessageBytes(messages_.front());
+    messages_.pop_front();
+  }
+}
+
+}  // namespace rosbag
+}  // namespace cyberdog
@@ -0,0 +1,165 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cyberdog_rosbag_recorder/topic_policy.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "map_msgs/msg/occupancy_grid_update.hpp"
+#include "rclcpp/serialization.hpp"
+
+namespace cyberdog
+{
+namespace rosbag
+{
+
+namespace
+{
+// Keyframes in a row due to the grid moving before costmap_delta is turned off
+constexpr int kMaxGeometryChanges = 3;
+
+uint64_t HashBytes(const rcl_serialized_message_t & message)
+{
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < message.buffer_length; ++i) {
+    hash ^= message.buffer[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+bool SameGeometry(const nav_msgs::msg::OccupancyGrid & a, const nav_msgs::msg::OccupancyGrid & b)
+{
+  return a.header.frame_id == b.header.frame_id &&
+         a.info.width == b.info.width && a.info.height == b.info.height &&
+         a.info.resolution == b.info.resolution &&
+         a.info.origin == b.info.origin &&
+         a.data.size() == b.data.size();
+}
+}  // namespace
+
+TopicPolicyFilter::TopicPolicyFilter(const TopicPolicy & policy)
+: policy_(policy)
+{
+  if (policy_.max_rate > 0.0) {
+    min_period_ns_ = static_cast<int64_t>(1e9 / policy_.max_rate);
+  }
+}
+
+TopicPolicyFilter::Result TopicPolicyFilter::Filter(
+  int64_t stamp_ns, std::shared_ptr<rclcpp::SerializedMessage> & message)
+{
+  if (has_last_ && stamp_ns - last_stamp_ns_ < min_period_ns_) {
+    return Result::kDrop;
+  }
+
+  Result result = Result::kKeep;
+  if (policy_.costmap_delta) {
+    result = FilterCostmap(message);
+  } else if (policy_.on_change) {
+    uint64_t hash = HashBytes(message->get_rcl_serialized_message());
+    if (has_last_ && hash == last_hash_) {
+      return Result::kDrop;
+    }
+    last_hash_ = hash;
+  }
+
+  if (result != Result::kDrop) {
+    last_stamp_ns_ = stamp_ns;
+    has_last_ = true;
+  }
+  return result;
+}
+
+void TopicPolicyFilter::RequestKeyframe()
+{
+  has_previous_grid_ = false;
+  previous_grid_ = nav_msgs::msg::OccupancyGrid();
+}
+
+TopicPolicyFilter::Result TopicPolicyFilter::FilterCostmap(
+  std::shared_ptr<rclcpp::SerializedMessage> & message)
+{
+  static rclcpp::Serialization<nav_msgs::msg::OccupancyGrid> grid_serialization;
+  static rclcpp::Serialization<map_msgs::msg::OccupancyGridUpdate> update_serialization;
+
+  nav_msgs::msg::OccupancyGrid grid;
+  grid_serialization.deserialize_message(message.get(), &grid);
+
+  const bool moved = has_previous_grid_ && !SameGeometry(grid, previous_grid_);
+  geometry_changes_ = moved ? geometry_changes_ + 1 : 0;
+  if (geometry_changes_ >= kMaxGeometryChanges) {
+    // A rolling costmap, every grid would be a keyframe anyway
+    policy_.costmap_delta = false;
+    has_previous_grid_ = false;
+    previous_grid_ = nav_msgs::msg::OccupancyGrid();
+    return Result::kKeep;
+  }
+  if (!has_previous_grid_ || moved || updates_since_keyframe_ >= policy_.keyframe_interval) {
+    previous_grid_ = std::move(grid);
+    has_previous_grid_ = true;
+    updates_since_keyframe_ = 0;
+    return Result::kKeep;
+  }
+
+  // Bounding box of the changed cells
+  const unsigned int width = grid.info.width;
+  const unsigned int height = grid.info.height;
+  unsigned int min_x = width, min_y = height, max_x = 0, max_y = 0;
+  for (unsigned int y = 0; y < height; ++y) {
+    const int8_t * row = grid.data.data() + static_cast<size_t>(y) * width;
+    const int8_t * previous_row = previous_grid_.data.data() + static_cast<size_t>(y) * width;
+    auto first = std::mismatch(row, row + width, previous_row);
+    if (first.first == row + width) {
+      continue;
+    }
+    unsigned int last = width - 1;
+    while (row[last] == previous_row[last]) {
+      --last;
+    }
+    min_x = std::min(min_x, static_cast<unsigned int>(first.first - row));
+    max_x = std::max(max_x, last);
+    min_y = std::min(min_y, y);
+    max_y = y;
+  }
+  if (min_y == height) {
+    // Unchanged grid, only its stamp moved
+    return Result::kDrop;
+  }
+
+  map_msgs::msg::OccupancyGridUpdate update;
+  update.header = grid.header;
+  update.x = min_x;
+  update.y = min_y;
+  update.width = max_x - min_x + 1;
+  update.height = max_y - min_y + 1;
+  update.data.resize(static_cast<size_t>(update.width) * update.height);
+  for (unsigned int y = 0; y < update.height; ++y) {
+    const int8_t * row = grid.data.data() + static_cast<size_t>(min_y + y) * width + min_x;
+    std::copy(
+      row, row + update.width, update.data.begin() + static_cast<size_t>(y) * update.width);
+  }
+
+  previous_grid_ = std::move(grid);
+  ++updates_since_keyframe_;
+  message = std::make_shared<rclcpp::SerializedMessage>();
+  update_serialization.serialize_message(&update, message.get());
+  return Result::kKeepUpdate;
+}
+
+}  // namespace rosbag
+}  // namespace cyberdog
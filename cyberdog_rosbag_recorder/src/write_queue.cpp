@@ -0,0 +1,97 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cyberdog_rosbag_recorder/write_queue.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace cyberdog
+{
+namespace rosbag
+{
+
+WriteQueue::WriteQueue(size_t max_size)
+: max_size_(max_size)
+{
+}
+
+void WriteQueue::Reset()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  topics_.clear();
+  messages_.clear();
+  stopping_ = false;
+  dropped_ = 0;
+}
+
+void WriteQueue::AddTopic(const rosbag2_storage::TopicMetadata & topic)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    topics_.push_back(topic);
+  }
+  cond_.notify_one();
+}
+
+bool WriteQueue::Push(MessagePtr message)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+      return false;
+    }
+    if (messages_.size() >= max_size_) {
+      ++dropped_;
+      return false;
+    }
+    messages_.push_back(std::move(message));
+  }
+  cond_.notify_one();
+  return true;
+}
+
+bool WriteQueue::Take(
+  std::vector<rosbag2_storage::TopicMetadata> & topics,
+  std::deque<MessagePtr> & messages)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this] {return stopping_ || !topics_.empty() || !messages_.empty();});
+  if (topics_.empty() && messages_.empty()) {
+    return false;
+  }
+  topics.swap(topics_);
+  messages.swap(messages_);
+  topics_.clear();
+  messages_.clear();
+  return true;
+}
+
+void WriteQueue::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cond_.notify_one();
+}
+
+size_t WriteQueue::Dropped() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dropped_;
+}
+
+}  // namespace rosbag
+}  // namespace cyberdog
@@ -0,0 +1,99 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rcpputils/filesystem_helper.hpp"
+#include "rmw/rmw.h"
+#include "rosbag2_cpp/converter_options.hpp"
+#include "rosbag2_cpp/reader.hpp"
+#include "rosbag2_storage/storage_options.hpp"
+#include "std_msgs/msg/string.hpp"
+#include "cyberdog_rosbag_recorder/bag_recorder.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+// Record a topic published on the same node, then read the bag back.
+// Succeeds if the bag has the topic with its type and an unbroken run of the
+// published messages.
+TEST(BagRecorder, RoundTrip)
+{
+  const std::string topic = "bag_recorder_chatter";
+  auto node = std::make_shared<rclcpp::Node>("test_bag_recorder");
+  auto publisher = node->create_publisher<std_msgs::msg::String>(topic, 10);
+  const std::string uri =
+    (rcpputils::fs::temp_directory_path() / "test_bag_recorder_round_trip").string();
+  rcpputils::fs::remove_all(rcpputils::fs::path(uri));
+
+  {
+    cyberdog::rosbag::BagRecorder recorder(node.get(), 100);
+    ASSERT_TRUE(recorder.Start(uri, {topic}));
+    EXPECT_TRUE(recorder.IsRecording());
+    // The topic is subscribed once the discovery timer sees it
+    for (int i = 0; i < 60; ++i) {
+      std_msgs::msg::String message;
+      message.data = std::to_string(i);
+      publisher->publish(message);
+      rclcpp::spin_some(node);
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    recorder.Stop();
+    EXPECT_FALSE(recorder.IsRecording());
+  }
+
+  rosbag2_storage::StorageOptions storage_options;
+  storage_options.uri = uri;
+  storage_options.storage_id = "sqlite3";
+  rosbag2_cpp::ConverterOptions converter_options;
+  converter_options.input_serialization_format = rmw_get_serialization_format();
+  converter_options.output_serialization_format = rmw_get_serialization_format();
+  rosbag2_cpp::Reader reader;
+  reader.open(storage_options, converter_options);
+
+  auto topics = reader.get_all_topics_and_types();
+  ASSERT_EQ(topics.size(), 1u);
+  EXPECT_EQ(topics[0].name, "/" + topic);
+  EXPECT_EQ(topics[0].type, "std_msgs/msg/String");
+
+  rclcpp::Serialization<std_msgs::msg::String> serialization;
+  int previous = -1;
+  size_t count = 0;
+  while (reader.has_next()) {
+    auto bag_message = reader.read_next();
+    EXPECT_EQ(bag_message->topic_name, "/" + topic);
+    rclcpp::SerializedMessage serialized(*bag_message->serialized_data);
+    std_msgs::msg::String message;
+    serialization.deserialize_message(&serialized, &message);
+    const int index = std::stoi(message.data);
+    if (previous >= 0) {
+      EXPECT_EQ(index, previous + 1);
+    }
+    previous = index;
+    ++count;
+  }
+  EXPECT_GT(count, 0u);
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cyberdog_rosbag_recorder/snapshot_buffer.hpp"
+
+using cyberdog::rosbag::SnapshotBuffer;
+using Pin = SnapshotBuffer::Pin;
+
+namespace
+{
+SnapshotBuffer::MessagePtr Message(const std::string & topic, int64_t stamp_ns, size_t bytes)
+{
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = topic;
+  message->time_stamp = stamp_ns;
+  message->serialized_data = std::make_shared<rcutils_uint8_array_t>();
+  message->serialized_data->buffer_length = bytes;
+  return message;
+}
+
+// A message whose serialized bytes are the given string
+SnapshotBuffer::MessagePtr Message(
+  const std::string & topic, int64_t stamp_ns, const std::string & bytes)
+{
+  auto message = Message(topic, stamp_ns, bytes.size());
+  auto buffer = std::make_shared<std::string>(bytes);
+  message->serialized_data = std::shared_ptr<rcutils_uint8_array_t>(
+    new rcutils_uint8_array_t(*message->serialized_data),
+    [buffer](rcutils_uint8_array_t * data) {delete data;});
+  message->serialized_data->buffer = reinterpret_cast<uint8_t *>(&(*buffer)[0]);
+  return message;
+}
+
+// Topic and stamp of each message, in order
+std::vector<std::pair<std::string, int64_t>> Contents(const SnapshotBuffer & buffer)
+{
+  std::vector<std::pair<std::string, int64_t>> contents;
+  for (const auto & message : buffer.Messages()) {
+    contents.emplace_back(message->topic_name, message->time_stamp);
+  }
+  return contents;
+}
+}  // namespace
+
+TEST(SnapshotBuffer, TrimsByDuration)
+{
+  SnapshotBuffer buffer(10, 1000);
+  for (int64_t stamp = 0; stamp <= 25; stamp += 5) {
+    buffer.Push(Message("/scan", stamp, 1));
+  }
+  std::vector<std::pair<std::string, int64_t>> expected = {
+    {"/scan", 15}, {"/scan", 20}, {"/scan", 25}};
+  EXPECT_EQ(Contents(buffer), expected);
+  EXPECT_EQ(buffer.Size(), 3u);
+  EXPECT_EQ(buffer.Bytes(), 3u);
+}
+
+TEST(SnapshotBuffer, TrimsBySize)
+{
+  SnapshotBuffer buffer(1000, 25);
+  for (int64_t stamp = 0; stamp < 5; ++stamp) {
+    buffer.Push(Message("/scan", stamp, 10));
+  }
+  std::vector<std::pair<std::string, int64_t>> expected = {{"/scan", 3}, {"/scan", 4}};
+  EXPECT_EQ(Contents(buffer), expected);
+  EXPECT_EQ(buffer.Bytes(), 20u);
+
+  // Tighter bounds apply at once
+  buffer.Configure(1000, 10);
+  expected = {{"/scan", 4}};
+  EXPECT_EQ(Contents(buffer), expected);
+}
+
+TEST(SnapshotBuffer, KeepsPinnedMessages)
+{
+  SnapshotBuffer buffer(10, 1000);
+  buffer.Push(Message("/tf_static", 0, 100), Pin::kLatest);
+  buffer.Push(Message("/costmap", 1, 100), Pin::kLatest);
+  buffer.Push(Message("/costmap_updates", 2, 5), Pin::kAppend, "/costmap");
+  buffer.Push(Message("/costmap_updates", 3, 5), Pin::kAppend, "/costmap");
+  // No keyframe pinned under this key, nothing to apply the update to
+  buffer.Push(Message("/other_updates", 4, 5), Pin::kAppend, "/other");
+  for (int64_t stamp = 5; stamp <= 20; stamp += 5) {
+    buffer.Push(Message("/scan", stamp, 1));
+  }
+
+  // Pinned messages dropped from the buffer come first, oldest first, and
+  // do not count in its size
+  std::vector<std::pair<std::string, int64_t>> expected = {
+    {"/tf_static", 0}, {"/costmap", 1}, {"/costmap_updates", 2}, {"/costmap_updates", 3},
+    {"/scan", 10}, {"/scan", 15}, {"/scan", 20}};
+  EXPECT_EQ(Contents(buffer), expected);
+  EXPECT_EQ(buffer.Size(), 3u);
+  EXPECT_EQ(buffer.Bytes(), 3u);
+
+  // A new keyframe replaces the pinned keyframe and its updates. Pinned
+  // messages still in the buffer are written once, in place.
+  buffer.Push(Message("/costmap", 21, 100), Pin::kLatest);
+  buffer.Push(Message("/costmap_updates", 22, 5), Pin::kAppend, "/costmap");
+  expected = {
+    {"/tf_static", 0}, {"/scan", 15}, {"/scan", 20}, {"/costmap", 21},
+    {"/costmap_updates", 22}};
+  EXPECT_EQ(Contents(buffer), expected);
+
+  buffer.Clear();
+  EXPECT_TRUE(buffer.Messages().empty());
+  EXPECT_EQ(buffer.Bytes(), 0u);
+}
+
+TEST(SnapshotBuffer, AccumulatesLatchedMessages)
+{
+  SnapshotBuffer buffer(10, 1000);
+  // Two publishers of /tf_static, the first one publishing again
+  buffer.Push(Message("/tf_static", 0, "base_link"), Pin::kAccumulate);
+  buffer.Push(Message("/tf_static", 1, "laser"), Pin::kAccumulate);
+  buffer.Push(Message("/tf_static", 2, "base_link"), Pin::kAccumulate);
+  for (int64_t stamp = 5; stamp <= 20; stamp += 5) {
+    buffer.Push(Message("/scan", stamp, 1));
+  }
+
+  // A message with the same bytes as a pinned one is not pinned again
+  std::vector<std::pair<std::string, int64_t>> expected = {
+    {"/tf_static", 0}, {"/tf_static", 1}, {"/scan", 10}, {"/scan", 15}, {"/scan", 20}};
+  EXPECT_EQ(Contents(buffer), expected);
+
+  buffer.Push(Message("/tf_static", 21, "camera"), Pin::kAccumulate);
+  expected = {
+    {"/tf_static", 0}, {"/tf_static", 1}, {"/scan", 15}, {"/scan", 20}, {"/tf_static", 21}};
+  EXPECT_EQ(Contents(buffer), expected);
+}
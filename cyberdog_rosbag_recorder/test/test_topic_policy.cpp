@@ -0,0 +1,188 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "map_msgs/msg/occupancy_grid_update.hpp"
+#include "nav_msgs/msg/occupancy_grid.hpp"
+#include "rclcpp/serialization.hpp"
+#include "cyberdog_rosbag_recorder/topic_policy.hpp"
+
+using cyberdog::rosbag::TopicPolicy;
+using cyberdog::rosbag::TopicPolicyFilter;
+using Result = TopicPolicyFilter::Result;
+
+namespace
+{
+constexpr int64_t kMs = 1000000;
+
+nav_msgs::msg::OccupancyGrid Grid(unsigned int width, unsigned int height)
+{
+  nav_msgs::msg::OccupancyGrid grid;
+  grid.header.frame_id = "map";
+  grid.info.width = width;
+  grid.info.height = height;
+  grid.info.resolution = 0.05;
+  grid.data.assign(static_cast<size_t>(width) * height, 0);
+  return grid;
+}
+
+std::shared_ptr<rclcpp::SerializedMessage> Serialize(const nav_msgs::msg::OccupancyGrid & grid)
+{
+  static rclcpp::Serialization<nav_msgs::msg::OccupancyGrid> serialization;
+  auto message = std::make_shared<rclcpp::SerializedMessage>();
+  serialization.serialize_message(&grid, message.get());
+  return message;
+}
+
+map_msgs::msg::OccupancyGridUpdate DeserializeUpdate(
+  const std::shared_ptr<rclcpp::SerializedMessage> & message)
+{
+  static rclcpp::Serialization<map_msgs::msg::OccupancyGridUpdate> serialization;
+  map_msgs::msg::OccupancyGridUpdate update;
+  serialization.deserialize_message(message.get(), &update);
+  return update;
+}
+
+// Filter a grid received at stamp_ns
+Result FilterGrid(
+  TopicPolicyFilter & filter, const nav_msgs::msg::OccupancyGrid & grid, int64_t stamp_ns,
+  std::shared_ptr<rclcpp::SerializedMessage> & message)
+{
+  message = Serialize(grid);
+  return filter.Filter(stamp_ns, message);
+}
+}  // namespace
+
+TEST(TopicPolicyFilter, LimitsRate)
+{
+  TopicPolicy policy;
+  policy.max_rate = 10.0;
+  TopicPolicyFilter filter(policy);
+
+  // At most one message per 100 ms, counted from the last one kept
+  const std::vector<std::pair<int64_t, Result>> expected = {
+    {0, Result::kKeep}, {50 * kMs, Result::kDrop}, {100 * kMs, Result::kKeep},
+    {150 * kMs, Result::kDrop}, {199 * kMs, Result::kDrop}, {210 * kMs, Result::kKeep}};
+  for (const auto & step : expected) {
+    auto message = std::make_shared<rclcpp::SerializedMessage>();
+    EXPECT_EQ(filter.Filter(step.first, message), step.second) << step.first;
+  }
+}
+
+TEST(TopicPolicyFilter, DropsUnchangedMessages)
+{
+  TopicPolicy policy;
+  policy.on_change = true;
+  TopicPolicyFilter filter(policy);
+
+  auto grid = Grid(4, 4);
+  std::shared_ptr<rclcpp::SerializedMessage> message;
+  EXPECT_EQ(FilterGrid(filter, grid, 0, message), Result::kKeep);
+  EXPECT_EQ(FilterGrid(filter, grid, 1, message), Result::kDrop);
+  grid.data[5] = 100;
+  EXPECT_EQ(FilterGrid(filter, grid, 2, message), Result::kKeep);
+}
+
+TEST(TopicPolicyFilter, KeepsBoundingBoxOfChanges)
+{
+  TopicPolicy policy;
+  policy.costmap_delta = true;
+  TopicPolicyFilter filter(policy);
+
+  auto grid = Grid(10, 8);
+  std::shared_ptr<rclcpp::SerializedMessage> message;
+  EXPECT_EQ(FilterGrid(filter, grid, 0, message), Result::kKeep);
+
+  // Cells (2, 3) and (6, 5) changed
+  grid.data[3 * 10 + 2] = 100;
+  grid.data[5 * 10 + 6] = -1;
+  ASSERT_EQ(FilterGrid(filter, grid, 1, message), Result::kKeepUpdate);
+  auto update = DeserializeUpdate(message);
+  EXPECT_EQ(update.header.frame_id, "map");
+  EXPECT_EQ(update.x, 2);
+  EXPECT_EQ(update.y, 3);
+  ASSERT_EQ(update.width, 5u);
+  ASSERT_EQ(update.height, 3u);
+  for (unsigned int y = 0; y < update.height; ++y) {
+    for (unsigned int x = 0; x < update.width; ++x) {
+      EXPECT_EQ(update.data[y * update.width + x], grid.data[(y + 3) * 10 + x + 2]);
+    }
+  }
+
+  // Same cells, only the stamp moved
+  grid.header.stamp.sec = 1;
+  EXPECT_EQ(FilterGrid(filter, grid, 2, message), Result::kDrop);
+
+  // Updates are relative to the last grid kept
+  grid.data[0] = 100;
+  ASSERT_EQ(FilterGrid(filter, grid, 3, message), Result::kKeepUpdate);
+  update = DeserializeUpdate(message);
+  EXPECT_EQ(update.x, 0);
+  EXPECT_EQ(update.y, 0);
+  EXPECT_EQ(update.width, 1u);
+  EXPECT_EQ(update.height, 1u);
+}
+
+TEST(TopicPolicyFilter, KeepsKeyframes)
+{
+  TopicPolicy policy;
+  policy.costmap_delta = true;
+  policy.keyframe_interval = 2;
+  TopicPolicyFilter filter(policy);
+
+  auto grid = Grid(4, 4);
+  std::shared_ptr<rclcpp::SerializedMessage> message;
+  const std::vector<Result> expected = {
+    Result::kKeep, Result::kKeepUpdate, Result::kKeepUpdate,
+    Result::kKeep, Result::kKeepUpdate, Result::kKeepUpdate, Result::kKeep};
+  for (size_t i = 0; i < expected.size(); ++i) {
+    grid.data[i] = 100;
+    EXPECT_EQ(FilterGrid(filter, grid, i, message), expected[i]) << i;
+  }
+
+  // A full grid again once one was lost
+  filter.RequestKeyframe();
+  grid.data[10] = 100;
+  EXPECT_EQ(FilterGrid(filter, grid, 10, message), Result::kKeep);
+  grid.data[11] = 100;
+  EXPECT_EQ(FilterGrid(filter, grid, 11, message), Result::kKeepUpdate);
+
+  // Resized grids are kept whole
+  grid = Grid(5, 4);
+  EXPECT_EQ(FilterGrid(filter, grid, 12, message), Result::kKeep);
+}
+
+TEST(TopicPolicyFilter, StopsDeltasOnRollingCostmaps)
+{
+  TopicPolicy policy;
+  policy.costmap_delta = true;
+  TopicPolicyFilter filter(policy);
+
+  auto grid = Grid(4, 4);
+  std::shared_ptr<rclcpp::SerializedMessage> message;
+  for (int i = 0; i < 5; ++i) {
+    grid.info.origin.position.x = 0.1 * i;
+    grid.data[i] = 100;
+    EXPECT_EQ(FilterGrid(filter, grid, i, message), Result::kKeep) << i;
+  }
+
+  // Grids are kept whole from now on, even when the origin stays
+  grid.data[6] = 100;
+  EXPECT_EQ(FilterGrid(filter, grid, 5, message), Result::kKeep);
+}
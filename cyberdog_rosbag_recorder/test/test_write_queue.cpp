@@ -0,0 +1,126 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cyberdog_rosbag_recorder/write_queue.hpp"
+
+using cyberdog::rosbag::WriteQueue;
+
+namespace
+{
+WriteQueue::MessagePtr Message(const std::string & topic, int64_t stamp_ns)
+{
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = topic;
+  message->time_stamp = stamp_ns;
+  return message;
+}
+
+rosbag2_storage::TopicMetadata Topic(const std::string & name)
+{
+  rosbag2_storage::TopicMetadata topic;
+  topic.name = name;
+  topic.type = "std_msgs/msg/String";
+  return topic;
+}
+}  // namespace
+
+TEST(WriteQueue, DropsNewestWhenFull)
+{
+  WriteQueue queue(3);
+  for (int64_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(queue.Push(Message("/a", i)), i < 3);
+  }
+  EXPECT_EQ(queue.Dropped(), 2u);
+
+  std::vector<rosbag2_storage::TopicMetadata> topics;
+  std::deque<WriteQueue::MessagePtr> messages;
+  ASSERT_TRUE(queue.Take(topics, messages));
+  ASSERT_EQ(messages.size(), 3u);
+  for (int64_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(messages[i]->time_stamp, i);
+  }
+
+  // Taking makes room again
+  EXPECT_TRUE(queue.Push(Message("/a", 5)));
+  EXPECT_EQ(queue.Dropped(), 2u);
+}
+
+TEST(WriteQueue, TopicsAreNotBounded)
+{
+  WriteQueue queue(1);
+  queue.AddTopic(Topic("/a"));
+  EXPECT_TRUE(queue.Push(Message("/a", 0)));
+  queue.AddTopic(Topic("/b"));
+  EXPECT_FALSE(queue.Push(Message("/b", 1)));
+
+  std::vector<rosbag2_storage::TopicMetadata> topics;
+  std::deque<WriteQueue::MessagePtr> messages;
+  ASSERT_TRUE(queue.Take(topics, messages));
+  ASSERT_EQ(topics.size(), 2u);
+  EXPECT_EQ(topics[0].name, "/a");
+  EXPECT_EQ(topics[1].name, "/b");
+  ASSERT_EQ(messages.size(), 1u);
+  EXPECT_EQ(messages[0]->topic_name, "/a");
+}
+
+TEST(WriteQueue, StopDrainsQueuedMessages)
+{
+  WriteQueue queue(10);
+  EXPECT_TRUE(queue.Push(Message("/a", 0)));
+  EXPECT_TRUE(queue.Push(Message("/a", 1)));
+  queue.Stop();
+  // Refused, but not counted as falling behind
+  EXPECT_FALSE(queue.Push(Message("/a", 2)));
+  EXPECT_EQ(queue.Dropped(), 0u);
+
+  std::vector<rosbag2_storage::TopicMetadata> topics;
+  std::deque<WriteQueue::MessagePtr> messages;
+  ASSERT_TRUE(queue.Take(topics, messages));
+  EXPECT_EQ(messages.size(), 2u);
+  messages.clear();
+  EXPECT_FALSE(queue.Take(topics, messages));
+  EXPECT_TRUE(messages.empty());
+
+  queue.Reset();
+  EXPECT_TRUE(queue.Push(Message("/a", 3)));
+}
+
+TEST(WriteQueue, TakeWaitsForWork)
+{
+  WriteQueue queue(10);
+  std::vector<rosbag2_storage::TopicMetadata> topics;
+  std::deque<WriteQueue::MessagePtr> messages;
+  std::thread consumer([&]() {
+      while (queue.Take(topics, messages)) {
+        if (!messages.empty()) {
+          return;
+        }
+      }
+    });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  queue.AddTopic(Topic("/a"));
+  queue.Push(Message("/a", 0));
+  consumer.join();
+  ASSERT_EQ(messages.size(), 1u);
+  EXPECT_EQ(messages[0]->topic_name, "/a");
+}
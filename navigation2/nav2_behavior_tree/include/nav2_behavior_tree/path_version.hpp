@@ -0,0 +1,73 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_BEHAVIOR_TREE__PATH_VERSION_HPP_
+#define NAV2_BEHAVIOR_TREE__PATH_VERSION_HPP_
+
+#include <cstdint>
+#include <string>
+
+#include "behaviortree_cpp_v3/behavior_tree.h"
+#include "nav_msgs/msg/path.hpp"
+
+namespace nav2_behavior_tree
+{
+
+// Reading a path from the blackboard copies it. Nodes that write a path also
+// bump a counter stored next to it, so readers that poll the path can check
+// the counter and only copy the path when it changed.
+
+/**
+ * @brief Blackboard key of the version counter of a path
+ * @param path_key Blackboard key of the path
+ * @return Key of the counter
+ */
+inline std::string pathVersionKey(const std::string & path_key)
+{
+  return path_key + "_version";
+}
+
+/**
+ * @brief Write a path to an output port and bump its version counter
+ * @param node The node writing the path
+ * @param port Name of the output port
+ * @param path The path
+ */
+inline void setPathOutput(
+  BT::TreeNode & node, const std::string & port, const nav_msgs::msg::Path & path)
+{
+  node.setOutput(port, path);
+
+  auto remap = node.config().output_ports.find(port);
+  if (remap == node.config().output_ports.end() || !node.config().blackboard) {
+    return;
+  }
+  std::string key = remap->second;
+  if (key == "=") {
+    key = port;
+  } else if (BT::TreeNode::isBlackboardPointer(key)) {
+    key = std::string(BT::TreeNode::stripBlackboardPointer(key));
+  } else {
+    return;
+  }
+
+  auto blackboard = node.config().blackboard;
+  uint64_t version = 0;
+  blackboard->get<uint64_t>(pathVersionKey(key), version);
+  blackboard->set<uint64_t>(pathVersionKey(key), version + 1);
+}
+
+}  // namespace nav2_behavior_tree
+
+#endif  // NAV2_BEHAVIOR_TREE__PATH_VERSION_HPP_
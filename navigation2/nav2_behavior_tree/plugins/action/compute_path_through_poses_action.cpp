@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "nav2_behavior_tree/plugins/action/compute_path_through_poses_action.hpp"
+#include "nav2_behavior_tree/path_version.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -40,7 +41,7 @@ void ComputePathThroughPosesAction::on_tick()
 
 BT::NodeStatus ComputePathThroughPosesAction::on_success()
 {
-  setOutput("path", result_.result->path);
+  setPathOutput(*this, "path", result_.result->path);
   return BT::NodeStatus::SUCCESS;
 }
 
@@ -16,6 +16,7 @@
 #include <string>
 
 #include "nav2_behavior_tree/plugins/action/compute_path_to_pose_action.hpp"
+#include "nav2_behavior_tree/path_version.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -50,7 +51,7 @@ void ComputePathToPoseAction::on_wait_for_result()
 
 BT::NodeStatus ComputePathToPoseAction::on_success()
 {
-  setOutput("path", result_.result->path);
+  setPathOutput(*this, "path", result_.result->path);
   return BT::NodeStatus::SUCCESS;
 }
 
@@ -18,6 +18,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp_action/rclcpp_action.hpp"
 #include "geometry_msgs/msg/pose_stamped.hpp"
@@ -27,6 +28,7 @@
 #include "nav2_util/robot_utils.hpp"
 #include "nav_msgs/msg/path.hpp"
 #include "nav2_util/odometry_utils.hpp"
+#include "nav2_util/path_progress.hpp"
 
 namespace nav2_bt_navigator
 {
@@ -100,6 +102,12 @@ protected:
    */
   void onPreempt(ActionT::Goal::ConstSharedPtr goal) override;
 
+  /**
+   * @brief Re-index the path on the blackboard if it changed since the last call
+   * @param blackboard The BT blackboard
+   */
+  void updatePathProgress(const BT::Blackboard::Ptr & blackboard);
+
   /**
    * @brief A callback that is called when a the action is completed, can fill in
    * action result message or indicate that this action is done.
@@ -121,6 +129,10 @@ protected:
   std::string goal_blackboard_id_;
   std::string path_blackboard_id_;
 
+  // Progress along the path on the blackboard, and the version it was built from
+  nav2_util::PathProgress path_progress_;
+  uint64_t path_version_{0};
+
   // Odometry smoother object
   std::unique_ptr<nav2_util::OdomSmoother> odom_smoother_;
 
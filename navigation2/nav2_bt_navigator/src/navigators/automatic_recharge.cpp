@@ -114,11 +114,6 @@ void AutomaticRechargeNavigator::onLoop()
   // number of recoveries, and distance remaining to goal)
   auto feedback_msg = std::make_shared<ActionT::Feedback>();
 
-  geometry_msgs::msg::PoseStamped current_pose;
-  nav2_util::getCurrentPose(
-    current_pose, *feedback_utils_.tf, feedback_utils_.global_frame,
-    feedback_utils_.robot_frame, feedback_utils_.transform_tolerance);
-
   auto blackboard = bt_action_server_->getBlackboard();
 
   blackboard->get<float>("distance", feedback_msg->current_distance);
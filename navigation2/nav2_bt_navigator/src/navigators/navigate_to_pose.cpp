@@ -18,6 +18,7 @@
 #include <memory>
 #include <limits>
 #include "nav2_bt_navigator/navigators/navigate_to_pose.hpp"
+#include "nav2_behavior_tree/path_version.hpp"
 
 namespace nav2_bt_navigator
 {
@@ -116,29 +117,10 @@ NavigateToPoseNavigator::onLoop()
   auto blackboard = bt_action_server_->getBlackboard();
 
   try {
-    // Get current path points
-    nav_msgs::msg::Path current_path;
-    blackboard->get<nav_msgs::msg::Path>(path_blackboard_id_, current_path);
-
-    // Find the closest pose to current pose on global path
-    auto find_closest_pose_idx =
-      [&current_pose, &current_path]() {
-        size_t closest_pose_idx = 0;
-        double curr_min_dist = std::numeric_limits<double>::max();
-        for (size_t curr_idx = 0; curr_idx < current_path.poses.size(); ++curr_idx) {
-          double curr_dist = nav2_util::geometry_utils::euclidean_distance(
-            current_pose, current_path.poses[curr_idx]);
-          if (curr_dist < curr_min_dist) {
-            curr_min_dist = curr_dist;
-            closest_pose_idx = curr_idx;
-          }
-        }
-        return closest_pose_idx;
-      };
+    updatePathProgress(blackboard);
 
     // Calculate distance on the path
-    double distance_remaining =
-      nav2_util::geometry_utils::calculate_path_length(current_path, find_closest_pose_idx());
+    double distance_remaining = path_progress_.update(current_pose.pose);
 
     // Default value for time remaining
     rclcpp::Duration estimated_time_remaining = rclcpp::Duration::from_seconds(0.0);
@@ -169,6 +151,29 @@ NavigateToPoseNavigator::onLoop()
   bt_action_server_->publishFeedback(feedback_msg);
 }
 
+void
+NavigateToPoseNavigator::updatePathProgress(const BT::Blackboard::Ptr & blackboard)
+{
+  // Only copy the path when a BT node reports having written a new one. If
+  // the writer does not keep a version, fall back to comparing the path.
+  uint64_t version = 0;
+  if (blackboard->get<uint64_t>(
+      nav2_behavior_tree::pathVersionKey(path_blackboard_id_), version) &&
+    version == path_version_)
+  {
+    return;
+  }
+  path_version_ = version;
+
+  nav_msgs::msg::Path current_path;
+  blackboard->get<nav_msgs::msg::Path>(path_blackboard_id_, current_path);
+  if (path_progress_.empty() ||
+    !path_progress_.isSamePath(current_path.header.stamp, current_path.poses.size()))
+  {
+    path_progress_.setPath(current_path);
+  }
+}
+
 void
 NavigateToPoseNavigator::onPreempt(ActionT::Goal::ConstSharedPtr goal)
 {
@@ -15,7 +15,10 @@
 #ifndef NAV2_CONTROLLER__NAV2_CONTROLLER_HPP_
 #define NAV2_CONTROLLER__NAV2_CONTROLLER_HPP_
 
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -154,6 +157,23 @@ protected:
    * action server
    */
   void updateGlobalPath();
+  /**
+   * @brief Signal that new data for the controller is available, used by the
+   * event driven control loop
+   */
+  void triggerControl();
+  /**
+   * @brief Wait for the next control cycle of the event driven control loop
+   *
+   * Returns once a trigger was received and earliest has passed, or at latest
+   * without a trigger. The pending trigger is consumed.
+   * @param earliest Time before which the next cycle must not start
+   * @param latest Time at which the next cycle starts without a trigger
+   * @return true if woken up by a trigger, false on timeout
+   */
+  bool waitForControlTrigger(
+    const std::chrono::steady_clock::time_point & earliest,
+    const std::chrono::steady_clock::time_point & latest);
   /**
    * @brief Calls velocity publisher to publish the velocity on "cmd_vel" topic
    * @param velocity Twist velocity to be published
@@ -236,6 +256,13 @@ protected:
   std::string controller_ids_concat_, current_controller_;
 
   double controller_frequency_;
+  // Event driven control: cycles run on costmap updates and odometry, at most
+  // at controller_frequency_ and at least at min_controller_frequency_
+  bool event_driven_control_;
+  double min_controller_frequency_;
+  std::mutex control_trigger_mutex_;
+  std::condition_variable control_trigger_cv_;
+  bool control_triggered_{false};
   double min_x_velocity_threshold_;
   double min_y_velocity_threshold_;
   double min_theta_velocity_threshold_;
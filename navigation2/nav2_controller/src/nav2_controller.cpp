@@ -46,6 +46,8 @@ ControllerServer::ControllerServer()
   RCLCPP_INFO(get_logger(), "Creating controller server");
 
   declare_parameter("controller_frequency", 20.0);
+  declare_parameter("event_driven_control", false);
+  declare_parameter("min_controller_frequency", 5.0);
 
   declare_parameter("progress_checker_plugin", default_progress_checker_id_);
   declare_parameter("goal_checker_plugins", default_goal_checker_ids_);
@@ -62,6 +64,9 @@ ControllerServer::ControllerServer()
   costmap_ros_ = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
     "local_costmap", std::string{get_namespace()}, "local_costmap");
 
+  // Wake up the event driven control loop when the costmap has been updated
+  costmap_ros_->addUpdateCallback(std::bind(&ControllerServer::triggerControl, this));
+
   // Launch a thread to run the costmap node
   costmap_thread_ = std::make_unique<nav2_util::NodeThread>(costmap_ros_);
 }
@@ -111,10 +116,23 @@ ControllerServer::on_configure(const rclcpp_lifecycle::State & state)
   goal_checker_types_.resize(goal_checker_ids_.size());
 
   get_parameter("controller_frequency", controller_frequency_);
+  get_parameter("event_driven_control", event_driven_control_);
+  get_parameter("min_controller_frequency", min_controller_frequency_);
   get_parameter("min_x_velocity_threshold", min_x_velocity_threshold_);
   get_parameter("min_y_velocity_threshold", min_y_velocity_threshold_);
   get_parameter("min_theta_velocity_threshold", min_theta_velocity_threshold_);
   RCLCPP_INFO(get_logger(), "Controller frequency set to %.4fHz", controller_frequency_);
+  if (event_driven_control_) {
+    if (min_controller_frequency_ <= 0.0 || min_controller_frequency_ > controller_frequency_) {
+      RCLCPP_WARN(
+        get_logger(), "min_controller_frequency must be in (0, controller_frequency], "
+        "using controller_frequency");
+      min_controller_frequency_ = controller_frequency_;
+    }
+    RCLCPP_INFO(
+      get_logger(), "Event driven control between %.4fHz and %.4fHz",
+      min_controller_frequency_, controller_frequency_);
+  }
 
   std::string speed_limit_topic;
   get_parameter("speed_limit_topic", speed_limit_topic);
@@ -191,6 +209,7 @@ ControllerServer::on_configure(const rclcpp_lifecycle::State & state)
     "Controller Server has %s controllers available.", controller_ids_concat_.c_str());
 
   odom_sub_ = std::make_unique<nav_2d_utils::OdomSubscriber>(node);
+  odom_sub_->setOdomCallback(std::bind(&ControllerServer::triggerControl, this));
   vel_publisher_ = create_publisher<geometry_msgs::msg::Twist>("cmd_vel", 1);
 
   // Create the action server that we implement with our followPath method
@@ -358,7 +377,14 @@ void ControllerServer::computeControl()
 
     last_valid_cmd_time_ = now();
     rclcpp::WallRate loop_rate(controller_frequency_);
+    const auto min_period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(1.0 / controller_frequency_));
+    const auto max_period = event_driven_control_ ?
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(1.0 / min_controller_frequency_)) : min_period;
     while (rclcpp::ok()) {
+      const auto cycle_start = std::chrono::steady_clock::now();
+
       if (action_server_ == nullptr || !action_server_->is_server_active()) {
         RCLCPP_DEBUG(get_logger(), "Action server unavailable or inactive. Stopping.");
         return;
@@ -372,9 +398,16 @@ void ControllerServer::computeControl()
       }
 
       // Don't compute a trajectory until costmap is valid (after clear costmap)
-      rclcpp::Rate r(100);
-      while (!costmap_ros_->isCurrent()) {
-        r.sleep();
+      if (event_driven_control_) {
+        while (!costmap_ros_->isCurrent()) {
+          auto wait_start = std::chrono::steady_clock::now();
+          waitForControlTrigger(wait_start, wait_start + max_period);
+        }
+      } else {
+        rclcpp::Rate r(100);
+        while (!costmap_ros_->isCurrent()) {
+          r.sleep();
+        }
       }
 
       updateGlobalPath();
@@ -386,7 +419,14 @@ void ControllerServer::computeControl()
         break;
       }
 
-      if (!loop_rate.sleep()) {
+      if (event_driven_control_) {
+        if (std::chrono::steady_clock::now() > cycle_start + max_period) {
+          RCLCPP_WARN(
+            get_logger(), "Control loop missed its minimum rate of %.4fHz",
+            min_controller_frequency_);
+        }
+        waitForControlTrigger(cycle_start + min_period, cycle_start + max_period);
+      } else if (!loop_rate.sleep()) {
         RCLCPP_WARN(
           get_logger(), "Control loop missed its desired rate of %.4fHz",
           controller_frequency_);
@@ -531,6 +571,29 @@ void ControllerServer::updateGlobalPath()
   }
 }
 
+void ControllerServer::triggerControl()
+{
+  {
+    std::lock_guard<std::mutex> lock(control_trigger_mutex_);
+    control_triggered_ = true;
+  }
+  control_trigger_cv_.notify_one();
+}
+
+bool ControllerServer::waitForControlTrigger(
+  const std::chrono::steady_clock::time_point & earliest,
+  const std::chrono::steady_clock::time_point & latest)
+{
+  // Triggers received meanwhile stay pending, so the cycle starts right at earliest
+  std::this_thread::sleep_until(earliest);
+
+  std::unique_lock<std::mutex> lock(control_trigger_mutex_);
+  bool triggered = control_trigger_cv_.wait_until(
+    lock, latest, [this] {return control_triggered_;});
+  control_triggered_ = false;
+  return triggered;
+}
+
 void ControllerServer::publishVelocity(const geometry_msgs::msg::TwistStamped & velocity)
 {
   auto cmd_vel = std::make_unique<geometry_msgs::msg::Twist>(velocity.twist);
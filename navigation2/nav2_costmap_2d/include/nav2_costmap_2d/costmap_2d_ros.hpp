@@ -39,7 +39,9 @@
 #define NAV2_COSTMAP_2D__COSTMAP_2D_ROS_HPP_
 
 #include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -153,6 +155,14 @@ public:
    */
   void resetLayers();
 
+  /**
+   * @brief Register a function called from the map update thread each time
+   * updateMap() has finished. It should return quickly, e.g. by just waking
+   * up another thread.
+   * @param callback Function to call after each map update
+   */
+  void addUpdateCallback(std::function<void()> callback);
+
   /** @brief Same as getLayeredCostmap()->isCurrent(). */
   bool isCurrent()
   {
@@ -323,6 +333,8 @@ protected:
   std::atomic<bool> initialized_{false};
   std::atomic<bool> stopped_{true};
   std::unique_ptr<std::thread> map_update_thread_;  ///< @brief A thread for updating the map
+  std::vector<std::function<void()>> update_callbacks_;
+  std::mutex update_callbacks_mutex_;
   rclcpp::Time last_publish_{0, 0, RCL_ROS_TIME};
   rclcpp::Duration publish_cycle_{1, 0};
   pluginlib::ClassLoader<Layer> plugin_loader_{"nav2_costmap_2d", "nav2_costmap_2d::Layer"};
@@ -15,8 +15,11 @@
 #ifndef NAV2_COSTMAP_2D__COSTMAP_SUBSCRIBER_HPP_
 #define NAV2_COSTMAP_2D__COSTMAP_SUBSCRIBER_HPP_
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <mutex>
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_costmap_2d/costmap_2d.hpp"
@@ -53,9 +56,18 @@ public:
 
   /**
    * @brief A Get the costmap from topic
+   *
+   * The message is only converted again when a new one has arrived since the
+   * last call, so calling this repeatedly within a cycle is cheap.
    */
   std::shared_ptr<Costmap2D> getCostmap();
 
+  /**
+   * @brief Number of costmap messages converted so far. Changes whenever
+   * getCostmap() had to convert a new message.
+   */
+  uint64_t getCostmapVersion() const {return costmap_version_;}
+
 protected:
   /**
    * @brief Convert an occ grid message into a costmap object
@@ -68,6 +80,10 @@ protected:
 
   std::shared_ptr<Costmap2D> costmap_;
   nav2_msgs::msg::Costmap::SharedPtr costmap_msg_;
+  // Message costmap_ was last converted from
+  nav2_msgs::msg::Costmap::SharedPtr converted_msg_;
+  std::atomic<uint64_t> costmap_version_{0};
+  std::mutex convert_mutex_;
   std::string topic_name_;
   bool costmap_received_{false};
   rclcpp::Subscription<nav2_msgs::msg::Costmap>::SharedPtr costmap_sub_;
@@ -69,8 +69,50 @@ public:
    * @brief Returns if a pose is collision free
    */
   bool isCollisionFree(const geometry_msgs::msg::Pose2D & pose);
+  /**
+   * @brief Returns the obstacle footprint score for each of a set of poses
+   *
+   * The costmap and the robot pose used to unorient the footprint are only
+   * fetched once for the whole set.
+   */
+  std::vector<double> scorePoses(const std::vector<geometry_msgs::msg::Pose2D> & poses);
+  /**
+   * @brief Returns if every pose of a set is collision free, using firstCollision()
+   */
+  bool isCollisionFree(const std::vector<geometry_msgs::msg::Pose2D> & poses);
+  /**
+   * @brief Returns the index of the first pose of a motion in collision, or -1 if free
+   *
+   * Instead of rasterizing the footprint at every pose, the area swept by the
+   * whole motion is scanned once and its lethal and unknown cells are put in
+   * a grid of buckets. For a rotation in place only the annulus between the
+   * inscribed and circumscribed radius is kept. Each outline edge of each pose
+   * is then matched against the cells in the buckets around it, so the cost
+   * is O(swept cells + poses * edges * (buckets + cells) near an edge) instead
+   * of O(lethal cells * poses * edges). Poses whose outline passes near such a
+   * cell are checked with the same line-rasterized footprintCost() as
+   * scorePose(), so the result is the one of checking every pose with
+   * isCollisionFree(pose).
+   * A pose that is off the grid, or has part of its footprint off the grid, is
+   * in collision.
+   */
+  int firstCollision(const std::vector<geometry_msgs::msg::Pose2D> & poses);
 
 protected:
+  /**
+   * @brief Point the footprint checker at the latest costmap
+   */
+  void updateCostmap();
+  /**
+   * @brief Get the current footprint, unoriented to the robot frame
+   */
+  Footprint getFootprintSpec();
+  /**
+   * @brief Score a pose with an already unoriented footprint
+   */
+  double scorePose(
+    const geometry_msgs::msg::Pose2D & pose,
+    const Footprint & footprint_spec);
   /**
    * @brief Set a new footprint
    */
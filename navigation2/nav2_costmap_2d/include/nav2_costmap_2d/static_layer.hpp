@@ -38,6 +38,7 @@
 #ifndef NAV2_COSTMAP_2D__STATIC_LAYER_HPP_
 #define NAV2_COSTMAP_2D__STATIC_LAYER_HPP_
 
+#include <array>
 #include <mutex>
 #include <string>
 
@@ -152,6 +153,11 @@ private:
    */
   unsigned char interpretValue(unsigned char value);
 
+  /**
+   * @brief Fill the cost translation table from the current parameters
+   */
+  void buildCostTranslationTable();
+
   std::string global_frame_;  ///< @brief The global frame for the costmap
   std::string map_frame_;  /// @brief frame that map is located in
 
@@ -174,6 +180,8 @@ private:
   unsigned char lethal_threshold_;
   unsigned char unknown_cost_value_;
   bool trinary_costmap_;
+  // Cost of each map value, as given by interpretValue()
+  std::array<unsigned char, 256> cost_translation_table_;
   bool map_received_{false};
   tf2::Duration transform_tolerance_;
   std::atomic<bool> update_in_progress_;
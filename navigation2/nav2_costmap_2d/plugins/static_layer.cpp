@@ -158,6 +158,7 @@ StaticLayer::getParameters()
 
   // Enforce bounds
   lethal_threshold_ = std::max(std::min(temp_lethal_threshold, 100), 0);
+  buildCostTranslationTable();
   map_received_ = false;
   update_in_progress_.store(false);
 
@@ -211,18 +212,15 @@ StaticLayer::processMap(const nav_msgs::msg::OccupancyGrid & new_map)
       new_map.info.origin.position.x, new_map.info.origin.position.y);
   }
 
-  unsigned int index = 0;
-
   // we have a new map, update full size of map
   std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
 
   // initialize the costmap with static data
-  for (unsigned int i = 0; i < size_y; ++i) {
-    for (unsigned int j = 0; j < size_x; ++j) {
-      unsigned char value = new_map.data[index];
-      costmap_[index] = interpretValue(value);
-      ++index;
-    }
+  const unsigned char * table = cost_translation_table_.data();
+  const int8_t * data = new_map.data.data();
+  const size_t size = static_cast<size_t>(size_x) * size_y;
+  for (size_t index = 0; index < size; ++index) {
+    costmap_[index] = table[static_cast<unsigned char>(data[index])];
   }
 
   map_frame_ = new_map.header.frame_id;
@@ -266,6 +264,14 @@ StaticLayer::interpretValue(unsigned char value)
   return scale * LETHAL_OBSTACLE;
 }
 
+void
+StaticLayer::buildCostTranslationTable()
+{
+  for (unsigned int value = 0; value < cost_translation_table_.size(); ++value) {
+    cost_translation_table_[value] = interpretValue(value);
+  }
+}
+
 void
 StaticLayer::incomingMap(const nav_msgs::msg::OccupancyGrid::SharedPtr new_map)
 {
@@ -286,17 +292,16 @@ void
 StaticLayer::incomingUpdate(map_msgs::msg::OccupancyGridUpdate::ConstSharedPtr update)
 {
   std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
-  if (update->y < static_cast<int32_t>(y_) ||
-    y_ + height_ < update->y + update->height ||
-    update->x < static_cast<int32_t>(x_) ||
-    x_ + width_ < update->x + update->width)
+  // Updates may cover any part of the map, not only the last updated area
+  if (update->y < 0 || size_y_ < update->y + update->height ||
+    update->x < 0 || size_x_ < update->x + update->width)
   {
     RCLCPP_WARN(
       logger_,
       "StaticLayer: Map update ignored. Exceeds bounds of static layer.\n"
-      "Static layer origin: %d, %d   bounds: %d X %d\n"
+      "Static layer bounds: %d X %d\n"
       "Update origin: %d, %d   bounds: %d X %d",
-      x_, y_, width_, height_, update->x, update->y, update->width,
+      size_x_, size_y_, update->x, update->y, update->width,
       update->height);
     return;
   }
@@ -309,19 +314,30 @@ StaticLayer::incomingUpdate(map_msgs::msg::OccupancyGridUpdate::ConstSharedPtr u
       map_frame_.c_str(), update->header.frame_id.c_str());
   }
 
-  unsigned int di = 0;
+  const unsigned char * table = cost_translation_table_.data();
+  const int8_t * data = update->data.data();
   for (unsigned int y = 0; y < update->height; y++) {
-    unsigned int index_base = (update->y + y) * size_x_;
+    unsigned char * row = costmap_ + (update->y + y) * size_x_ + update->x;
     for (unsigned int x = 0; x < update->width; x++) {
-      unsigned int index = index_base + x + update->x;
-      costmap_[index] = interpretValue(update->data[di++]);
+      row[x] = table[static_cast<unsigned char>(data[x])];
     }
+    data += update->width;
   }
 
-  x_ = update->x;
-  y_ = update->y;
-  width_ = update->width;
-  height_ = update->height;
+  // Keep the area of the updates not passed on by updateBounds yet
+  unsigned int x1 = update->x + update->width;
+  unsigned int y1 = update->y + update->height;
+  if (has_updated_data_) {
+    x1 = std::max(x1, x_ + width_);
+    y1 = std::max(y1, y_ + height_);
+    x_ = std::min(x_, static_cast<unsigned int>(update->x));
+    y_ = std::min(y_, static_cast<unsigned int>(update->y));
+  } else {
+    x_ = update->x;
+    y_ = update->y;
+  }
+  width_ = x1 - x_;
+  height_ = y1 - y_;
   has_updated_data_ = true;
 }
 
@@ -413,19 +429,27 @@ StaticLayer::updateCosts(
     tf2::Transform tf2_transform;
     tf2::fromMsg(transform.transform, tf2_transform);
 
-    for (int i = min_i; i < max_i; ++i) {
-      for (int j = min_j; j < max_j; ++j) {
-        // Convert master_grid coordinates (i,j) into global_frame_(wx,wy) coordinates
-        layered_costmap_->getCostmap()->mapToWorld(i, j, wx, wy);
-        // Transform from global_frame_ to map_frame_
-        tf2::Vector3 p(wx, wy, 0);
-        p = tf2_transform * p;
+    // One cell along a row of master_grid, expressed in map_frame_
+    const tf2::Vector3 step =
+      tf2_transform.getBasis() * tf2::Vector3(master_grid.getResolution(), 0, 0);
+    unsigned char * master_array = master_grid.getCharMap();
+    const unsigned int span = master_grid.getSizeInCellsX();
+
+    for (int j = min_j; j < max_j; ++j) {
+      // Convert the first cell of the row into global_frame_(wx,wy) coordinates
+      // and transform it from global_frame_ to map_frame_
+      layered_costmap_->getCostmap()->mapToWorld(min_i, j, wx, wy);
+      const tf2::Vector3 row_start = tf2_transform * tf2::Vector3(wx, wy, 0);
+      unsigned char * master_row = master_array + j * span;
+      for (int i = min_i; i < max_i; ++i) {
+        const tf2::Vector3 p = row_start + step * static_cast<double>(i - min_i);
         // Set master_grid with cell from map
         if (worldToMap(p.x(), p.y(), mx, my)) {
+          const unsigned char cost = costmap_[getIndex(mx, my)];
           if (!use_maximum_) {
-            master_grid.setCost(i, j, getCost(mx, my));
+            master_row[i] = cost;
           } else {
-            master_grid.setCost(i, j, std::max(getCost(mx, my), master_grid.getCost(i, j)));
+            master_row[i] = std::max(cost, master_row[i]);
           }
         }
       }
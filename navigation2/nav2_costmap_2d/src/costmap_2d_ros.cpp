@@ -415,6 +415,13 @@ Costmap2DROS::mapUpdateLoop(double frequency)
       updateMap();
       timer.end();
 
+      {
+        std::lock_guard<std::mutex> lock(update_callbacks_mutex_);
+        for (auto & callback : update_callbacks_) {
+          callback();
+        }
+      }
+
       RCLCPP_DEBUG(get_logger(), "Map update time: %.9f", timer.elapsed_time_in_seconds());
       if (publish_cycle_ > rclcpp::Duration(0s) && layered_costmap_->isInitialized()) {
         unsigned int x0, y0, xn, yn;
@@ -472,6 +479,13 @@ Costmap2DROS::updateMap()
   }
 }
 
+void
+Costmap2DROS::addUpdateCallback(std::function<void()> callback)
+{
+  std::lock_guard<std::mutex> lock(update_callbacks_mutex_);
+  update_callbacks_.push_back(std::move(callback));
+}
+
 void
 Costmap2DROS::start()
 {
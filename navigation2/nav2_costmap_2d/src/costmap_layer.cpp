@@ -39,6 +39,7 @@
 #include <nav2_costmap_2d/costmap_layer.hpp>
 #include <stdexcept>
 #include <algorithm>
+#include <cstring>
 
 namespace nav2_costmap_2d
 {
@@ -152,12 +153,12 @@ void CostmapLayer::updateWithTrueOverwrite(
   unsigned char * master = master_grid.getCharMap();
   unsigned int span = master_grid.getSizeInCellsX();
 
+  if (max_i <= min_i) {
+    return;
+  }
   for (int j = min_j; j < max_j; j++) {
     unsigned int it = span * j + min_i;
-    for (int i = min_i; i < max_i; i++) {
-      master[it] = costmap_[it];
-      it++;
-    }
+    std::memcpy(master + it, costmap_ + it, max_i - min_i);
   }
 }
 
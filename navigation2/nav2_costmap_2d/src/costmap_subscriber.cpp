@@ -55,8 +55,13 @@ std::shared_ptr<Costmap2D> CostmapSubscriber::getCostmap()
 
 void CostmapSubscriber::toCostmap2D()
 {
+  std::lock_guard<std::mutex> lock(convert_mutex_);
 
   auto current_costmap_msg = std::atomic_load(&costmap_msg_);
+  if (current_costmap_msg == converted_msg_) {
+    // Already converted, nothing new on the topic
+    return;
+  }
 
   if (costmap_ == nullptr) {
     costmap_ = std::make_shared<Costmap2D>(
@@ -85,6 +90,9 @@ void CostmapSubscriber::toCostmap2D()
       ++index;
     }
   }
+
+  converted_msg_ = current_costmap_msg;
+  ++costmap_version_;
 }
 
 void CostmapSubscriber::costmapCallback(const nav2_msgs::msg::Costmap::SharedPtr msg)
@@ -17,8 +17,11 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <utility>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 
 #include "nav2_costmap_2d/costmap_topic_collision_checker.hpp"
 
@@ -32,6 +35,26 @@ using namespace std::chrono_literals;
 namespace nav2_costmap_2d
 {
 
+namespace
+{
+
+// Squared distance from (px, py) to the segment (ax, ay) - (bx, by)
+double distanceToSegmentSq(double px, double py, double ax, double ay, double bx, double by)
+{
+  const double dx = bx - ax;
+  const double dy = by - ay;
+  const double len_sq = dx * dx + dy * dy;
+  double t = 0.0;
+  if (len_sq > 0.0) {
+    t = std::clamp(((px - ax) * dx + (py - ay) * dy) / len_sq, 0.0, 1.0);
+  }
+  const double ex = ax + t * dx - px;
+  const double ey = ay + t * dy - py;
+  return ex * ex + ey * ey;
+}
+
+}  // namespace
+
 CostmapTopicCollisionChecker::CostmapTopicCollisionChecker(
   CostmapSubscriber & costmap_sub,
   FootprintSubscriber & footprint_sub,
@@ -71,25 +94,259 @@ bool CostmapTopicCollisionChecker::isCollisionFree(
   }
 }
 
+bool CostmapTopicCollisionChecker::isCollisionFree(
+  const std::vector<geometry_msgs::msg::Pose2D> & poses)
+{
+  try {
+    return firstCollision(poses) < 0;
+  } catch (const IllegalPoseException & e) {
+    RCLCPP_ERROR(rclcpp::get_logger(name_), "%s", e.what());
+    return false;
+  } catch (const CollisionCheckerException & e) {
+    RCLCPP_ERROR(rclcpp::get_logger(name_), "%s", e.what());
+    return false;
+  } catch (...) {
+    RCLCPP_ERROR(rclcpp::get_logger(name_), "Failed to check pose score!");
+    return false;
+  }
+}
+
 double CostmapTopicCollisionChecker::scorePose(
   const geometry_msgs::msg::Pose2D & pose)
 {
-  try {
-    collision_checker_.setCostmap(costmap_sub_.getCostmap());
-  } catch (const std::runtime_error & e) {
-    throw CollisionCheckerException(e.what());
+  updateCostmap();
+  return scorePose(pose, getFootprintSpec());
+}
+
+std::vector<double> CostmapTopicCollisionChecker::scorePoses(
+  const std::vector<geometry_msgs::msg::Pose2D> & poses)
+{
+  updateCostmap();
+  Footprint footprint_spec = getFootprintSpec();
+
+  std::vector<double> scores;
+  scores.reserve(poses.size());
+  for (const auto & pose : poses) {
+    scores.push_back(scorePose(pose, footprint_spec));
+  }
+  return scores;
+}
+
+int CostmapTopicCollisionChecker::firstCollision(
+  const std::vector<geometry_msgs::msg::Pose2D> & poses)
+{
+  if (poses.empty()) {
+    return -1;
   }
 
+  updateCostmap();
+  const Footprint footprint_spec = getFootprintSpec();
+  std::shared_ptr<Costmap2D> costmap = collision_checker_.getCostmap();
+  const size_t num_edges = footprint_spec.size();
+
+  std::vector<double> cos_th(poses.size()), sin_th(poses.size());
+  for (size_t k = 0; k < poses.size(); ++k) {
+    cos_th[k] = cos(poses[k].theta);
+    sin_th[k] = sin(poses[k].theta);
+  }
+
+  // Bounds of the swept area, stopping at the first pose going off the grid
+  size_t first = poses.size();
+  double min_x = std::numeric_limits<double>::max();
+  double min_y = std::numeric_limits<double>::max();
+  double max_x = std::numeric_limits<double>::lowest();
+  double max_y = std::numeric_limits<double>::lowest();
+  unsigned int mx, my;
+  for (size_t k = 0; k < poses.size() && first == poses.size(); ++k) {
+    if (!costmap->worldToMap(poses[k].x, poses[k].y, mx, my)) {
+      first = k;
+      break;
+    }
+    for (const auto & point : footprint_spec) {
+      const double wx = poses[k].x + point.x * cos_th[k] - point.y * sin_th[k];
+      const double wy = poses[k].y + point.x * sin_th[k] + point.y * cos_th[k];
+      if (!costmap->worldToMap(wx, wy, mx, my)) {
+        first = k;
+        break;
+      }
+      min_x = std::min(min_x, wx);
+      min_y = std::min(min_y, wy);
+      max_x = std::max(max_x, wx);
+      max_y = std::max(max_y, wy);
+    }
+  }
+  if (first == 0) {
+    return 0;
+  }
+
+  // The outline of a pose is rasterized between the cells of its vertices, so
+  // an outline cell lies within half a cell of the line joining their centers,
+  // and those centers within half a cell diagonal of the vertices.
+  const double resolution = costmap->getResolution();
+  const double cell_radius = resolution * (0.5 + M_SQRT1_2) * 1.01;
+  const double cell_radius_sq = cell_radius * cell_radius;
+
+  // A rotation in place only sweeps the outline over an annulus around the robot
+  bool in_place = true;
+  for (size_t k = 1; k < first; ++k) {
+    if (poses[k].x != poses[0].x || poses[k].y != poses[0].y) {
+      in_place = false;
+      break;
+    }
+  }
+  double inscribed_radius, circumscribed_radius;
+  calculateMinAndMaxDistances(footprint_spec, inscribed_radius, circumscribed_radius);
+  const double annulus_min = std::max(0.0, inscribed_radius - cell_radius);
+  const double annulus_max = circumscribed_radius + cell_radius;
+  const double annulus_min_sq = annulus_min * annulus_min;
+  const double annulus_max_sq = annulus_max * annulus_max;
+  if (in_place) {
+    min_x = std::min(min_x, poses[0].x - circumscribed_radius);
+    min_y = std::min(min_y, poses[0].y - circumscribed_radius);
+    max_x = std::max(max_x, poses[0].x + circumscribed_radius);
+    max_y = std::max(max_y, poses[0].y + circumscribed_radius);
+  }
+
+  int x0, y0, x1, y1;
+  costmap->worldToMapEnforceBounds(min_x - cell_radius, min_y - cell_radius, x0, y0);
+  costmap->worldToMapEnforceBounds(max_x + cell_radius, max_y + cell_radius, x1, y1);
+
+  // Single pass over the swept area, indexing its lethal and unknown cells in
+  // square buckets of cells
+  struct WorldPoint
+  {
+    double x, y;
+  };
+  const int bucket_cells = 8;
+  const int buckets_x = (x1 - x0) / bucket_cells + 1;
+  const int buckets_y = (y1 - y0) / bucket_cells + 1;
+  std::vector<size_t> bucket_start(static_cast<size_t>(buckets_x) * buckets_y + 1, 0);
+  std::vector<std::pair<size_t, WorldPoint>> lethal;
+  for (int cy = y0; cy <= y1; ++cy) {
+    for (int cx = x0; cx <= x1; ++cx) {
+      if (costmap->getCost(cx, cy) < LETHAL_OBSTACLE) {
+        continue;
+      }
+
+      double wx, wy;
+      costmap->mapToWorld(cx, cy, wx, wy);
+
+      if (in_place) {
+        const double dx = wx - poses[0].x;
+        const double dy = wy - poses[0].y;
+        const double r_sq = dx * dx + dy * dy;
+        if (r_sq < annulus_min_sq || r_sq > annulus_max_sq) {
+          continue;
+        }
+      }
+
+      const size_t bucket =
+        static_cast<size_t>((cy - y0) / bucket_cells) * buckets_x + (cx - x0) / bucket_cells;
+      ++bucket_start[bucket + 1];
+      lethal.push_back({bucket, {wx, wy}});
+    }
+  }
+  if (lethal.empty()) {
+    return first == poses.size() ? -1 : static_cast<int>(first);
+  }
+  for (size_t b = 1; b < bucket_start.size(); ++b) {
+    bucket_start[b] += bucket_start[b - 1];
+  }
+  std::vector<WorldPoint> cells(lethal.size());
+  {
+    std::vector<size_t> next(bucket_start.begin(), bucket_start.end() - 1);
+    for (const auto & cell : lethal) {
+      cells[next[cell.first]++] = cell.second;
+    }
+  }
+
+  // Poses in order: each outline edge only looks at the buckets around it. A
+  // pose whose outline passes near an indexed cell gets the same footprintCost
+  // test as scorePose.
+  const double bucket_size = bucket_cells * resolution;
+  const double origin_x = costmap->getOriginX() + x0 * resolution;
+  const double origin_y = costmap->getOriginY() + y0 * resolution;
+  auto bucket_range = [bucket_size](double from, double to, double origin, int count,
+      int & b0, int & b1) {
+      b0 = std::max(0, static_cast<int>(std::floor((from - origin) / bucket_size)));
+      b1 = std::min(count - 1, static_cast<int>(std::floor((to - origin) / bucket_size)));
+    };
+  std::vector<WorldPoint> outline(num_edges);
+  Footprint footprint;
+  for (size_t k = 0; k < first; ++k) {
+    for (size_t i = 0; i < num_edges; ++i) {
+      const auto & point = footprint_spec[i];
+      outline[i] = {
+        poses[k].x + point.x * cos_th[k] - point.y * sin_th[k],
+        poses[k].y + point.x * sin_th[k] + point.y * cos_th[k]};
+    }
+
+    bool near = false;
+    for (size_t i = 0; i < num_edges && !near; ++i) {
+      const WorldPoint & a = outline[i];
+      const WorldPoint & b = outline[(i + 1) % num_edges];
+      int bx0, bx1, by0, by1;
+      bucket_range(
+        std::min(a.x, b.x) - cell_radius, std::max(a.x, b.x) + cell_radius, origin_x,
+        buckets_x, bx0, bx1);
+      bucket_range(
+        std::min(a.y, b.y) - cell_radius, std::max(a.y, b.y) + cell_radius, origin_y,
+        buckets_y, by0, by1);
+      for (int by = by0; by <= by1 && !near; ++by) {
+        for (int bx = bx0; bx <= bx1 && !near; ++bx) {
+          const size_t bucket = static_cast<size_t>(by) * buckets_x + bx;
+          for (size_t c = bucket_start[bucket]; c < bucket_start[bucket + 1] && !near; ++c) {
+            near = distanceToSegmentSq(cells[c].x, cells[c].y, a.x, a.y, b.x, b.y) <=
+              cell_radius_sq;
+          }
+        }
+      }
+    }
+    if (!near) {
+      continue;
+    }
+
+    transformFootprint(poses[k].x, poses[k].y, poses[k].theta, footprint_spec, footprint);
+    if (collision_checker_.footprintCost(footprint) >= LETHAL_OBSTACLE) {
+      return static_cast<int>(k);
+    }
+  }
+
+  return first == poses.size() ? -1 : static_cast<int>(first);
+}
+
+double CostmapTopicCollisionChecker::scorePose(
+  const geometry_msgs::msg::Pose2D & pose,
+  const Footprint & footprint_spec)
+{
   unsigned int cell_x, cell_y;
   if (!collision_checker_.worldToMap(pose.x, pose.y, cell_x, cell_y)) {
     RCLCPP_DEBUG(rclcpp::get_logger(name_), "Map Cell: [%d, %d]", cell_x, cell_y);
     throw IllegalPoseException(name_, "Pose Goes Off Grid.");
   }
 
-  return collision_checker_.footprintCost(getFootprint(pose));
+  Footprint footprint;
+  transformFootprint(pose.x, pose.y, pose.theta, footprint_spec, footprint);
+  return collision_checker_.footprintCost(footprint);
+}
+
+void CostmapTopicCollisionChecker::updateCostmap()
+{
+  try {
+    collision_checker_.setCostmap(costmap_sub_.getCostmap());
+  } catch (const std::runtime_error & e) {
+    throw CollisionCheckerException(e.what());
+  }
 }
 
 Footprint CostmapTopicCollisionChecker::getFootprint(const geometry_msgs::msg::Pose2D & pose)
+{
+  Footprint footprint;
+  transformFootprint(pose.x, pose.y, pose.theta, getFootprintSpec(), footprint);
+  return footprint;
+}
+
+Footprint CostmapTopicCollisionChecker::getFootprintSpec()
 {
   Footprint footprint;
   if (!footprint_sub_.getFootprint(footprint)) {
@@ -98,9 +355,7 @@ Footprint CostmapTopicCollisionChecker::getFootprint(const geometry_msgs::msg::P
 
   Footprint footprint_spec;
   unorientFootprint(footprint, footprint_spec);
-  transformFootprint(pose.x, pose.y, pose.theta, footprint_spec, footprint);
-
-  return footprint;
+  return footprint_spec;
 }
 
 void CostmapTopicCollisionChecker::unorientFootprint(
@@ -16,6 +16,8 @@
 #include <vector>
 #include <memory>
 #include <chrono>
+#include <cmath>
+#include <random>
 
 #include "gtest/gtest.h"
 #include "rclcpp/rclcpp.hpp"
@@ -188,6 +190,65 @@ public:
     return collision_checker_->isCollisionFree(pose);
   }
 
+  bool testPoses(const std::vector<geometry_msgs::msg::Pose2D> & poses)
+  {
+    publishPose(poses.front().x, poses.front().y, poses.front().theta);
+    setPose(poses.front().x, poses.front().y, poses.front().theta);
+    publishFootprint();
+    publishCostmap();
+    rclcpp::sleep_for(std::chrono::milliseconds(1000));
+
+    // The batch result must match checking each pose on its own
+    bool all_free = true;
+    for (const auto & pose : poses) {
+      all_free = all_free && collision_checker_->isCollisionFree(pose);
+    }
+    EXPECT_EQ(collision_checker_->isCollisionFree(poses), all_free);
+    return all_free;
+  }
+
+  // Compares firstCollision with checking each pose on its own, over random motions
+  void testRandomMotions(unsigned int seed, int count)
+  {
+    publishPose(5.0, 5.0, 0.0);
+    setPose(5.0, 5.0, 0.0);
+    publishFootprint();
+    publishCostmap();
+    rclcpp::sleep_for(std::chrono::milliseconds(1000));
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> position(-0.5, 10.5);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+    std::uniform_real_distribution<double> speed(-0.5, 0.5);
+    std::uniform_real_distribution<double> turn(-1.5, 1.5);
+    for (int i = 0; i < count; ++i) {
+      // Constant velocity arcs, every fourth one a rotation in place
+      geometry_msgs::msg::Pose2D pose;
+      pose.x = position(rng);
+      pose.y = position(rng);
+      pose.theta = angle(rng);
+      const double v = i % 4 == 0 ? 0.0 : speed(rng);
+      const double w = turn(rng);
+      std::vector<geometry_msgs::msg::Pose2D> poses;
+      for (int step = 0; step < 20; ++step) {
+        poses.push_back(pose);
+        pose.x += v * cos(pose.theta) * 0.1;
+        pose.y += v * sin(pose.theta) * 0.1;
+        pose.theta += w * 0.1;
+      }
+
+      int expected = -1;
+      for (size_t k = 0; k < poses.size() && expected < 0; ++k) {
+        if (!collision_checker_->isCollisionFree(poses[k])) {
+          expected = static_cast<int>(k);
+        }
+      }
+      EXPECT_EQ(collision_checker_->firstCollision(poses), expected) <<
+        "motion " << i << " from (" << poses.front().x << ", " << poses.front().y <<
+        ", " << poses.front().theta << ")";
+    }
+  }
+
   void setFootprint(double footprint_padding, double robot_radius)
   {
     std::vector<geometry_msgs::msg::Point> new_footprint;
@@ -340,3 +401,34 @@ TEST_F(TestNode, CollisionSpace)
   // Partially in obstacle
   ASSERT_EQ(collision_checker_->testPose(4.5, 4.5, 0), false);
 }
+
+TEST_F(TestNode, BatchPoses)
+{
+  collision_checker_->setFootprint(0, 1);
+
+  std::vector<geometry_msgs::msg::Pose2D> poses(3);
+  poses[0].x = 2.0;
+  poses[0].y = 8.5;
+  poses[1].x = 2.5;
+  poses[1].y = 7.0;
+  poses[2].x = 2.0;
+  poses[2].y = 8.5;
+  poses[2].theta = 1.0;
+
+  // All in free space
+  ASSERT_EQ(collision_checker_->testPoses(poses), true);
+
+  // Last pose in obstacle
+  poses[2].x = 8.5;
+  poses[2].y = 6.5;
+  ASSERT_EQ(collision_checker_->testPoses(poses), false);
+}
+
+TEST_F(TestNode, FirstCollisionMatchesPerPose)
+{
+  collision_checker_->setFootprint(0, 1);
+  collision_checker_->testRandomMotions(3, 500);
+
+  collision_checker_->setFootprint(0.05, 0.3);
+  collision_checker_->testRandomMotions(5, 500);
+}
@@ -35,11 +35,14 @@
 #ifndef DWB_CORE__DWB_LOCAL_PLANNER_HPP_
 #define DWB_CORE__DWB_LOCAL_PLANNER_HPP_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "dwb_core/publisher.hpp"
+#include "dwb_core/scoring_pool.hpp"
+#include "dwb_core/trajectory_batch.hpp"
 #include "dwb_core/trajectory_critic.hpp"
 #include "dwb_core/trajectory_generator.hpp"
 #include "nav2_core/controller.hpp"
@@ -192,6 +195,80 @@ protected:
     const nav_2d_msgs::msg::Twist2D velocity,
     std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> & results);
 
+  /**
+   * @brief Same as coreScoringAlgorithm, but scores the twists on scoring_pool_
+   *
+   * All twists are drawn from the generator up front and split into contiguous
+   * chunks. Each chunk generates and scores its trajectories, pruning against
+   * the best score found within that chunk. The per-candidate scores are then
+   * reduced in index order, so the chosen twist (ties broken by the lowest
+   * index) is the same as the one picked by the serial algorithm. The workers
+   * share the critics and the generator, so this is only used when all of
+   * them report isThreadSafe.
+   */
+  virtual dwb_msgs::msg::TrajectoryScore parallelScoringAlgorithm(
+    const geometry_msgs::msg::Pose2D & pose,
+    const nav_2d_msgs::msg::Twist2D velocity,
+    std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> & results);
+
+  /**
+   * @brief Same as coreScoringAlgorithm, but scores all twists critic by critic
+   *
+   * All trajectories are generated into the reused batch_ buffer and every
+   * critic scores the whole batch through scoreTrajectories. Trajectories
+   * found illegal by one critic are skipped by the following ones. The
+   * remaining trajectories are scored in full (there is no bound to prune
+   * against), which yields the same best twist as the serial algorithm.
+   * When scoring_pool_ is available, each critic's pass is split across it.
+   */
+  virtual dwb_msgs::msg::TrajectoryScore batchScoringAlgorithm(
+    const geometry_msgs::msg::Pose2D & pose,
+    const nav_2d_msgs::msg::Twist2D velocity,
+    std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> & results);
+
+  /**
+   * @brief scoreTrajectory variant that runs the critics in critic_order_
+   *
+   * The order only changes when a trajectory gets pruned. A trajectory that is
+   * not pruned runs every critic, and its critic scores and total are listed
+   * and summed in configuration order, identical to scoreTrajectory. When a
+   * critic rejects the trajectory, replayConfiguredOrder decides the outcome
+   * scoreTrajectory would have given. Only the partial scores of a pruned
+   * trajectory differ, which is why it is not used when the evaluation is
+   * recorded.
+   */
+  dwb_msgs::msg::TrajectoryScore scoreTrajectoryAdaptive(
+    const dwb_msgs::msg::Trajectory2D & traj, double best_score);
+
+  /**
+   * @brief Run the critics before end in configuration order, after critic end
+   * rejected a trajectory in scoreTrajectoryAdaptive
+   *
+   * Critics that already ran are not run again. An earlier critic rejecting
+   * the trajectory throws its exception, as in scoreTrajectory.
+   *
+   * @param critic_scores Scores of the critics that already ran, completed here
+   * @param scored Which critics already ran
+   * @param end Index of the rejecting critic
+   * @param score Filled in configuration order
+   * @return true if scoreTrajectory would have pruned the trajectory before
+   * reaching critic end, false if critic end rejects it
+   */
+  bool replayConfiguredOrder(
+    const dwb_msgs::msg::Trajectory2D & traj, double best_score,
+    std::vector<dwb_msgs::msg::CriticScore> & critic_scores,
+    const std::vector<uint8_t> & scored, size_t end,
+    dwb_msgs::msg::TrajectoryScore & score);
+
+  /**
+   * @brief Reorder critic_order_ from the runtime profile of each critic
+   *
+   * Critics are sorted by their mean cost per decisive outcome (a rejection or
+   * a prune of the trajectory), so cheap critics that often end the evaluation
+   * run first. Called once per control cycle, before any scoring.
+   */
+  void updateCriticOrder();
+
   /**
    * @brief Transforms global plan into same frame as pose, clips far away poses
    * and possibly prunes passed poses
@@ -256,6 +333,36 @@ protected:
   std::string dwb_plugin_name_;
 
   bool short_circuit_trajectory_evaluation_;
+
+  // Parallel scoring, only allocated when parallel_scoring is enabled
+  bool parallel_scoring_;
+  std::unique_ptr<ScoringPool> scoring_pool_;
+
+  // Batched scoring buffers, reused across cycles
+  bool batch_scoring_;
+  TrajectoryBatch batch_;
+  std::vector<uint8_t> batch_active_;
+  std::vector<BatchScores> batch_scores_;
+
+  /**
+   * @struct CriticProfile
+   * @brief Runtime statistics of one critic, updated from the scoring threads
+   */
+  struct CriticProfile
+  {
+    std::atomic<uint64_t> calls{0};
+    // Time spent in the sampled calls
+    std::atomic<uint64_t> timed_calls{0};
+    std::atomic<uint64_t> time_ns{0};
+    std::atomic<uint64_t> rejects{0};
+    std::atomic<uint64_t> prunes{0};
+  };
+
+  // Adaptive critic scheduling
+  static constexpr uint64_t kProfileSamplePeriod = 16;
+  bool adaptive_critic_order_;
+  std::vector<size_t> critic_order_;
+  std::unique_ptr<CriticProfile[]> critic_profiles_;
 };
 
 }  // namespace dwb_core
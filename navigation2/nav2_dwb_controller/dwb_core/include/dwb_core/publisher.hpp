@@ -35,8 +35,12 @@
 #ifndef DWB_CORE__PUBLISHER_HPP_
 #define DWB_CORE__PUBLISHER_HPP_
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
@@ -65,6 +69,12 @@ namespace dwb_core
  *   4) The Full LocalPlanEvaluation
  *   5) Markers representing the different trajectories evaluated
  *   6) The CostGrid (in the form of a complex PointCloud2)
+ *
+ * The evaluation, trajectory markers and cost grid are the expensive outputs.
+ * They are only produced when someone subscribes to them, at most at
+ * debug_publish_rate, and with async_debug_publishing they are converted and
+ * published from a background thread so the control cycle only pays for a
+ * snapshot of the data.
  */
 class DWBPublisher
 {
@@ -72,6 +82,7 @@ public:
   explicit DWBPublisher(
     const rclcpp_lifecycle::LifecycleNode::WeakPtr & parent,
     const std::string & plugin_name);
+  ~DWBPublisher();
 
   nav2_util::CallbackReturn on_configure();
   nav2_util::CallbackReturn on_activate();
@@ -82,7 +93,7 @@ public:
    * @brief Does the publisher require that the LocalPlanEvaluation be saved
    * @return True if the Evaluation is needed to publish either directly or as trajectories
    */
-  bool shouldRecordEvaluation() {return publish_evaluation_ || publish_trajectories_;}
+  bool shouldRecordEvaluation();
 
   /**
    * @brief If the pointer is not null, publish the evaluation and trajectories as needed
@@ -99,7 +110,39 @@ public:
   void publishLocalPlan(const nav_2d_msgs::msg::Path2D plan);
 
 protected:
+  /**
+   * @struct CostGridSnapshot
+   * @brief Everything needed to build the cost grid PointCloud2 off the control thread
+   *
+   * Only the critics' data is copied on the control thread, their channels,
+   * the total cost and the point cloud are built by publishCostGridNow.
+   */
+  struct CostGridSnapshot
+  {
+    std_msgs::msg::Header header;
+    unsigned int size_x;
+    unsigned int size_y;
+    double origin_x;
+    double origin_y;
+    double resolution;
+    // Visualization of each critic, with the critic's scale
+    std::vector<std::pair<TrajectoryCritic::VisualizationSnapshot, double>> critics;
+  };
+
   void publishTrajectories(const dwb_msgs::msg::LocalPlanEvaluation & results);
+  void publishEvaluationNow(const dwb_msgs::msg::LocalPlanEvaluation & results);
+  void publishCostGridNow(const CostGridSnapshot & snapshot);
+
+  /**
+   * @brief Check the rate limit for a debug output, and claim the slot if it is due
+   * @param last_publish Time the output was last produced, updated when due
+   */
+  bool debugPublishDue(rclcpp::Time & last_publish);
+
+  // Background publishing of the debug outputs
+  void startDebugThread();
+  void stopDebugThread();
+  void debugThreadLoop();
 
   // Helper function for publishing other plans
   void publishGenericPlan(
@@ -118,6 +161,20 @@ protected:
   // Marker Lifetime
   builtin_interfaces::msg::Duration marker_lifetime_;
 
+  // Debug output throttling
+  double debug_publish_rate_;
+  bool async_debug_publishing_;
+  rclcpp::Time last_evaluation_publish_;
+  rclcpp::Time last_cost_grid_publish_;
+
+  // Latest pending debug outputs, consumed by debug_thread_
+  std::thread debug_thread_;
+  std::mutex debug_mutex_;
+  std::condition_variable debug_cv_;
+  bool debug_thread_stop_{false};
+  std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> pending_evaluation_;
+  std::unique_ptr<CostGridSnapshot> pending_cost_grid_;
+
   // Publisher Objects
   std::shared_ptr<LifecyclePublisher<dwb_msgs::msg::LocalPlanEvaluation>> eval_pub_;
   std::shared_ptr<LifecyclePublisher<nav_msgs::msg::Path>> global_pub_;
@@ -0,0 +1,97 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DWB_CORE__SCORING_POOL_HPP_
+#define DWB_CORE__SCORING_POOL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dwb_core
+{
+
+/**
+ * @class ScoringPool
+ * @brief Small fixed-size worker pool used to score trajectory candidates in parallel
+ *
+ * The pool splits an index range [0, count) into contiguous chunks, one per
+ * worker, and blocks the caller until every chunk has been processed. The
+ * calling thread processes the first chunk itself. Chunk boundaries only
+ * depend on count and the number of workers, so the assignment of indices
+ * to chunks is deterministic.
+ */
+class ScoringPool
+{
+public:
+  /**
+   * @brief Chunk callback: (chunk id, begin index, end index)
+   */
+  using ChunkFunction = std::function<void (size_t, size_t, size_t)>;
+
+  /**
+   * @brief Constructor
+   * @param num_threads Total number of threads working on a range, including
+   * the calling thread. Zero selects std::thread::hardware_concurrency().
+   */
+  explicit ScoringPool(unsigned int num_threads = 0);
+
+  /**
+   * @brief Destructor, stops and joins the workers
+   */
+  ~ScoringPool();
+
+  ScoringPool(const ScoringPool &) = delete;
+  ScoringPool & operator=(const ScoringPool &) = delete;
+
+  /**
+   * @brief Number of chunks a range is split into
+   */
+  size_t size() const {return workers_.size() + 1;}
+
+  /**
+   * @brief Process [0, count) in parallel, blocking until all chunks are done
+   *
+   * If a chunk throws, the first exception (by chunk id) is rethrown in the
+   * calling thread after all chunks have finished.
+   *
+   * @param count Number of indices to process
+   * @param fn Callback invoked once per non-empty chunk
+   */
+  void parallelFor(size_t count, const ChunkFunction & fn);
+
+protected:
+  void workerLoop(size_t chunk_id);
+  void runChunk(size_t chunk_id);
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+
+  const ChunkFunction * fn_{nullptr};
+  size_t count_{0};
+  size_t generation_{0};
+  size_t pending_{0};
+  bool stop_{false};
+  std::vector<std::exception_ptr> errors_;
+};
+
+}  // namespace dwb_core
+
+#endif  // DWB_CORE__SCORING_POOL_HPP_
@@ -0,0 +1,180 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DWB_CORE__TRAJECTORY_BATCH_HPP_
+#define DWB_CORE__TRAJECTORY_BATCH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "dwb_core/exceptions.hpp"
+#include "dwb_msgs/msg/trajectory2_d.hpp"
+#include "geometry_msgs/msg/pose2_d.hpp"
+#include "nav_2d_msgs/msg/twist2_d.hpp"
+#include "rclcpp/duration.hpp"
+
+namespace dwb_core
+{
+
+/**
+ * @class TrajectoryBatch
+ * @brief Struct-of-arrays storage for all the trajectories of one scoring cycle
+ *
+ * The poses of every trajectory are stored back to back in the x, y and theta
+ * arrays, and pose_begin holds the index of the first pose of each trajectory
+ * (plus one trailing entry), so the poses of trajectory i are
+ * [pose_begin[i], pose_begin[i + 1]). The time offsets are stored the same way
+ * since a Trajectory2D does not necessarily carry one per pose.
+ *
+ * clear() keeps the allocated capacity, so a batch owned by the planner stops
+ * allocating after the first few cycles.
+ */
+class TrajectoryBatch
+{
+public:
+  TrajectoryBatch()
+  {
+    clear();
+  }
+
+  /**
+   * @brief Drop all trajectories, keeping the allocated memory
+   */
+  void clear()
+  {
+    velocities.clear();
+    x.clear();
+    y.clear();
+    theta.clear();
+    time_offsets.clear();
+    pose_begin.assign(1, 0);
+    time_begin.assign(1, 0);
+  }
+
+  /**
+   * @brief Number of trajectories in the batch
+   */
+  size_t size() const {return velocities.size();}
+
+  /**
+   * @brief Number of poses in trajectory i
+   */
+  size_t numPoses(size_t i) const {return pose_begin[i + 1] - pose_begin[i];}
+
+  /**
+   * @brief Start a new trajectory. Poses and time offsets added afterwards belong to it.
+   * @param velocity The commanded velocity of the new trajectory
+   */
+  void beginTrajectory(const nav_2d_msgs::msg::Twist2D & velocity)
+  {
+    velocities.push_back(velocity);
+    pose_begin.push_back(x.size());
+    time_begin.push_back(time_offsets.size());
+  }
+
+  /**
+   * @brief Append a pose to the last trajectory
+   */
+  void addPose(double px, double py, double ptheta)
+  {
+    x.push_back(px);
+    y.push_back(py);
+    theta.push_back(ptheta);
+    pose_begin.back() = x.size();
+  }
+
+  /**
+   * @brief Append a time offset (in seconds) to the last trajectory
+   */
+  void addTimeOffset(double seconds)
+  {
+    time_offsets.push_back(seconds);
+    time_begin.back() = time_offsets.size();
+  }
+
+  /**
+   * @brief Append a full Trajectory2D message as a new trajectory
+   */
+  void addTrajectory(const dwb_msgs::msg::Trajectory2D & traj)
+  {
+    beginTrajectory(traj.velocity);
+    for (const auto & pose : traj.poses) {
+      addPose(pose.x, pose.y, pose.theta);
+    }
+    for (const auto & offset : traj.time_offsets) {
+      addTimeOffset(rclcpp::Duration(offset).seconds());
+    }
+  }
+
+  /**
+   * @brief Get pose j of trajectory i as a message
+   */
+  geometry_msgs::msg::Pose2D getPose(size_t i, size_t j) const
+  {
+    geometry_msgs::msg::Pose2D pose;
+    const size_t k = pose_begin[i] + j;
+    pose.x = x[k];
+    pose.y = y[k];
+    pose.theta = theta[k];
+    return pose;
+  }
+
+  /**
+   * @brief Copy trajectory i into a Trajectory2D, reusing its storage
+   */
+  void getTrajectory(size_t i, dwb_msgs::msg::Trajectory2D & traj) const
+  {
+    traj.velocity = velocities[i];
+    traj.poses.resize(numPoses(i));
+    for (size_t j = 0; j < traj.poses.size(); ++j) {
+      traj.poses[j] = getPose(i, j);
+    }
+    traj.time_offsets.resize(time_begin[i + 1] - time_begin[i]);
+    for (size_t j = 0; j < traj.time_offsets.size(); ++j) {
+      traj.time_offsets[j] = rclcpp::Duration::from_seconds(time_offsets[time_begin[i] + j]);
+    }
+  }
+
+  std::vector<nav_2d_msgs::msg::Twist2D> velocities;
+  std::vector<double> x, y, theta;
+  std::vector<double> time_offsets;
+  std::vector<size_t> pose_begin;
+  std::vector<size_t> time_begin;
+};
+
+/**
+ * @struct BatchScores
+ * @brief Output of one critic over a TrajectoryBatch
+ *
+ * raw[i] is the raw (unscaled) score of trajectory i. If the critic found
+ * trajectory i illegal, illegal[i] holds the exception it would have thrown
+ * from scoreTrajectory and raw[i] is meaningless.
+ */
+struct BatchScores
+{
+  void reset(size_t n)
+  {
+    raw.assign(n, 0.0);
+    illegal.assign(n, nullptr);
+  }
+
+  std::vector<double> raw;
+  std::vector<std::shared_ptr<IllegalTrajectoryException>> illegal;
+};
+
+}  // namespace dwb_core
+
+#endif  // DWB_CORE__TRAJECTORY_BATCH_HPP_
@@ -35,12 +35,15 @@
 #ifndef DWB_CORE__TRAJECTORY_CRITIC_HPP_
 #define DWB_CORE__TRAJECTORY_CRITIC_HPP_
 
+#include <functional>
 #include <string>
 #include <vector>
 #include <memory>
 #include <utility>
 
 #include "rclcpp/rclcpp.hpp"
+#include "dwb_core/exceptions.hpp"
+#include "dwb_core/trajectory_batch.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
 #include "geometry_msgs/msg/pose2_d.hpp"
 #include "nav_2d_msgs/msg/twist2_d.hpp"
@@ -79,6 +82,8 @@ class TrajectoryCritic
 {
 public:
   using Ptr = std::shared_ptr<dwb_core::TrajectoryCritic>;
+  using CostChannels = std::vector<std::pair<std::string, std::vector<float>>>;
+  using VisualizationSnapshot = std::function<void (CostChannels &)>;
 
   virtual ~TrajectoryCritic() {}
 
@@ -143,9 +148,49 @@ public:
    *
    * scores < 0 are considered invalid/errors, such as collisions
    * This is the raw score in that the scale should not be applied to it.
+   *
+   * If isThreadSafe returns true, this may be called concurrently from several
+   * threads between prepare and debrief.
    */
   virtual double scoreTrajectory(const dwb_msgs::msg::Trajectory2D & traj) = 0;
 
+  /**
+   * @brief Whether scoreTrajectory and scoreTrajectories may run concurrently
+   *
+   * Critics opt in by returning true once they keep no per-call state, i.e.
+   * scoring only reads what prepare computed. The planner only scores on
+   * several threads when every critic and the trajectory generator opt in.
+   */
+  virtual bool isThreadSafe() const {return false;}
+
+  /**
+   * @brief Score the active trajectories in [begin, end) of a batch
+   *
+   * Batched equivalent of scoreTrajectory, used when the planner runs with
+   * batch_scoring enabled. For every i in [begin, end) with active[i] set, the
+   * raw score is written to scores.raw[i], or scores.illegal[i] is set instead
+   * of throwing. The default implementation copies each trajectory into a
+   * reused Trajectory2D and calls scoreTrajectory; critics that work on the
+   * poses directly should override it and read the batch's arrays.
+   */
+  virtual void scoreTrajectories(
+    const TrajectoryBatch & batch, const std::vector<uint8_t> & active,
+    size_t begin, size_t end, BatchScores & scores)
+  {
+    dwb_msgs::msg::Trajectory2D traj;
+    for (size_t i = begin; i < end; ++i) {
+      if (!active[i]) {
+        continue;
+      }
+      batch.getTrajectory(i, traj);
+      try {
+        scores.raw[i] = scoreTrajectory(traj);
+      } catch (const IllegalTrajectoryException & e) {
+        scores.illegal[i] = std::make_shared<IllegalTrajectoryException>(e);
+      }
+    }
+  }
+
   /**
    * @brief debrief informs the critic what the chosen cmd_vel was (if it cares)
    */
@@ -169,6 +214,23 @@ public:
    */
   virtual void addCriticVisualization(std::vector<std::pair<std::string, std::vector<float>>> &) {}
 
+  /**
+   * @brief Capture the data addCriticVisualization reads, to build the channels later
+   *
+   * Called on the control thread. The returned callable may run on another
+   * thread after the next prepare, and adds the channels addCriticVisualization
+   * would have added at the time of the call. The default builds them right
+   * away; critics with a grid of their own only copy it here.
+   */
+  virtual VisualizationSnapshot snapshotCriticVisualization()
+  {
+    auto channels = std::make_shared<CostChannels>();
+    addCriticVisualization(*channels);
+    return [channels](CostChannels & cost_channels) {
+             cost_channels.insert(cost_channels.end(), channels->begin(), channels->end());
+           };
+  }
+
   std::string getName()
   {
     return name_;
@@ -41,6 +41,7 @@
 #include "rclcpp/rclcpp.hpp"
 #include "nav_2d_msgs/msg/twist2_d.hpp"
 #include "dwb_msgs/msg/trajectory2_d.hpp"
+#include "dwb_core/trajectory_batch.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 
 namespace dwb_core
@@ -124,6 +125,35 @@ public:
     const nav_2d_msgs::msg::Twist2D & start_vel,
     const nav_2d_msgs::msg::Twist2D & cmd_vel) = 0;
 
+  /**
+   * @brief Same as above, but appends the trajectory to a TrajectoryBatch
+   *
+   * The default implementation converts the generated Trajectory2D. Generators
+   * should override it to write the poses straight into the batch.
+   *
+   * @param start_pose Current robot location
+   * @param start_vel Current robot velocity
+   * @param cmd_vel The desired command velocity
+   * @param batch Batch the new trajectory is appended to
+   */
+  virtual void generateTrajectory(
+    const geometry_msgs::msg::Pose2D & start_pose,
+    const nav_2d_msgs::msg::Twist2D & start_vel,
+    const nav_2d_msgs::msg::Twist2D & cmd_vel,
+    TrajectoryBatch & batch)
+  {
+    batch.addTrajectory(generateTrajectory(start_pose, start_vel, cmd_vel));
+  }
+
+  /**
+   * @brief Whether generateTrajectory may be called concurrently
+   *
+   * Only the twist iteration is stateful in the standard generators, so
+   * generators that simulate trajectories from their parameters alone can
+   * return true and let the planner generate on several threads.
+   */
+  virtual bool isThreadSafe() const {return false;}
+
   /**
    * @brief Limits the maximum linear speed of the robot.
    * @param speed_limit expressed in absolute value (in m/s)
@@ -35,6 +35,7 @@
 #include "dwb_core/dwb_local_planner.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
@@ -105,6 +106,18 @@ void DWBLocalPlanner::configure(
   declare_parameter_if_not_declared(
     node, dwb_plugin_name_ + ".short_circuit_trajectory_evaluation",
     rclcpp::ParameterValue(true));
+  declare_parameter_if_not_declared(
+    node, dwb_plugin_name_ + ".parallel_scoring",
+    rclcpp::ParameterValue(false));
+  declare_parameter_if_not_declared(
+    node, dwb_plugin_name_ + ".scoring_threads",
+    rclcpp::ParameterValue(0));
+  declare_parameter_if_not_declared(
+    node, dwb_plugin_name_ + ".batch_scoring",
+    rclcpp::ParameterValue(false));
+  declare_parameter_if_not_declared(
+    node, dwb_plugin_name_ + ".adaptive_critic_order",
+    rclcpp::ParameterValue(false));
 
   std::string traj_generator_name;
 
@@ -131,6 +144,16 @@ void DWBLocalPlanner::configure(
   node->get_parameter(
     dwb_plugin_name_ + ".shorten_transformed_plan",
     shorten_transformed_plan_);
+  node->get_parameter(dwb_plugin_name_ + ".parallel_scoring", parallel_scoring_);
+  node->get_parameter(dwb_plugin_name_ + ".batch_scoring", batch_scoring_);
+  node->get_parameter(
+    dwb_plugin_name_ + ".adaptive_critic_order",
+    adaptive_critic_order_);
+  if (adaptive_critic_order_ && batch_scoring_) {
+    RCLCPP_WARN(
+      logger_, "adaptive_critic_order has no effect with batch_scoring, ignoring it");
+    adaptive_critic_order_ = false;
+  }
 
   pub_ = std::make_unique<DWBPublisher>(node, dwb_plugin_name_);
   pub_->on_configure();
@@ -147,6 +170,35 @@ void DWBLocalPlanner::configure(
       e.what());
     throw;
   }
+
+  if (parallel_scoring_) {
+    // The workers share the plugin instances, which must all opt in
+    std::string unsafe_plugin;
+    if (!traj_generator_->isThreadSafe()) {
+      unsafe_plugin = traj_generator_name;
+    }
+    for (TrajectoryCritic::Ptr & critic : critics_) {
+      if (unsafe_plugin.empty() && !critic->isThreadSafe()) {
+        unsafe_plugin = critic->getName();
+      }
+    }
+    if (!unsafe_plugin.empty()) {
+      RCLCPP_WARN(
+        logger_, "%s cannot score trajectories concurrently, disabling parallel_scoring",
+        unsafe_plugin.c_str());
+      parallel_scoring_ = false;
+    }
+  }
+
+  if (parallel_scoring_) {
+    int scoring_threads;
+    node->get_parameter(dwb_plugin_name_ + ".scoring_threads", scoring_threads);
+    scoring_pool_ = std::make_unique<ScoringPool>(
+      static_cast<unsigned int>(std::max(0, scoring_threads)));
+    RCLCPP_INFO(
+      logger_, "Scoring trajectories in parallel on %zu threads",
+      scoring_pool_->size());
+  }
 }
 
 void DWBLocalPlanner::activate() {pub_->on_activate();}
@@ -158,6 +210,7 @@ void DWBLocalPlanner::cleanup()
   pub_->on_cleanup();
 
   traj_generator_.reset();
+  scoring_pool_.reset();
 }
 
 std::string DWBLocalPlanner::resolveCriticClassName(std::string base_name)
@@ -226,6 +279,12 @@ void DWBLocalPlanner::loadCritics()
     }
     RCLCPP_INFO(logger_, "Critic plugin initialized");
   }
+
+  critic_order_.resize(critics_.size());
+  for (size_t i = 0; i < critic_order_.size(); ++i) {
+    critic_order_[i] = i;
+  }
+  critic_profiles_ = std::make_unique<CriticProfile[]>(critics_.size());
 }
 
 void DWBLocalPlanner::setPlan(const nav_msgs::msg::Path & path)
@@ -313,6 +372,10 @@ nav_2d_msgs::msg::Twist2DStamped DWBLocalPlanner::computeVelocityCommands(
     }
   }
 
+  if (adaptive_critic_order_) {
+    updateCriticOrder();
+  }
+
   try {
     dwb_msgs::msg::TrajectoryScore best =
       coreScoringAlgorithm(pose.pose, velocity, results);
@@ -355,6 +418,13 @@ dwb_msgs::msg::TrajectoryScore DWBLocalPlanner::coreScoringAlgorithm(
   const nav_2d_msgs::msg::Twist2D velocity,
   std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> & results)
 {
+  if (batch_scoring_) {
+    return batchScoringAlgorithm(pose, velocity, results);
+  }
+  if (scoring_pool_) {
+    return parallelScoringAlgorithm(pose, velocity, results);
+  }
+
   nav_2d_msgs::msg::Twist2D twist;
   dwb_msgs::msg::Trajectory2D traj;
   dwb_msgs::msg::TrajectoryScore best, worst;
@@ -362,13 +432,18 @@ dwb_msgs::msg::TrajectoryScore DWBLocalPlanner::coreScoringAlgorithm(
   worst.total = -1;
   IllegalTrajectoryTracker tracker;
 
+  // A recorded evaluation lists the partial scores of pruned trajectories,
+  // which depend on the critic order
+  const bool adaptive = adaptive_critic_order_ && !results;
+
   traj_generator_->startNewIteration(velocity);
   while (traj_generator_->hasMoreTwists()) {
     twist = traj_generator_->nextTwist();
     traj = traj_generator_->generateTrajectory(pose, velocity, twist);
 
     try {
-      dwb_msgs::msg::TrajectoryScore score = scoreTrajectory(traj, best.total);
+      dwb_msgs::msg::TrajectoryScore score = adaptive ?
+        scoreTrajectoryAdaptive(traj, best.total) : scoreTrajectory(traj, best.total);
       tracker.addLegalTrajectory();
       if (results) {
         results->twists.push_back(score);
@@ -418,6 +493,234 @@ dwb_msgs::msg::TrajectoryScore DWBLocalPlanner::coreScoringAlgorithm(
   return best;
 }
 
+dwb_msgs::msg::TrajectoryScore DWBLocalPlanner::parallelScoringAlgorithm(
+  const geometry_msgs::msg::Pose2D & pose,
+  const nav_2d_msgs::msg::Twist2D velocity,
+  std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> & results)
+{
+  // The velocity iterator is stateful, so all twists are drawn before scoring
+  std::vector<nav_2d_msgs::msg::Twist2D> twists;
+  traj_generator_->startNewIteration(velocity);
+  while (traj_generator_->hasMoreTwists()) {
+    twists.push_back(traj_generator_->nextTwist());
+  }
+
+  struct Candidate
+  {
+    dwb_msgs::msg::TrajectoryScore score;
+    std::shared_ptr<IllegalTrajectoryException> error;
+  };
+  std::vector<Candidate> candidates(twists.size());
+  const bool adaptive = adaptive_critic_order_ && !results;
+
+  scoring_pool_->parallelFor(
+    twists.size(), [&](size_t /*chunk*/, size_t begin, size_t end) {
+      // A candidate pruned against the chunk's best can never beat the global best
+      double chunk_best = -1;
+      for (size_t i = begin; i < end; ++i) {
+        Candidate & candidate = candidates[i];
+        dwb_msgs::msg::Trajectory2D traj =
+        traj_generator_->generateTrajectory(pose, velocity, twists[i]);
+        try {
+          candidate.score = adaptive ?
+          scoreTrajectoryAdaptive(traj, chunk_best) : scoreTrajectory(traj, chunk_best);
+          if (chunk_best < 0 || candidate.score.total < chunk_best) {
+            chunk_best = candidate.score.total;
+          }
+        } catch (const dwb_core::IllegalTrajectoryException & e) {
+          candidate.score.traj = std::move(traj);
+          candidate.error = std::make_shared<IllegalTrajectoryException>(e);
+        }
+      }
+    });
+
+  // Reduce in index order, exactly like the serial algorithm
+  dwb_msgs::msg::TrajectoryScore best, worst;
+  best.total = -1;
+  worst.total = -1;
+  IllegalTrajectoryTracker tracker;
+  size_t best_index = 0;
+
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    Candidate & candidate = candidates[i];
+    if (candidate.error) {
+      if (results) {
+        dwb_msgs::msg::TrajectoryScore failed_score;
+        failed_score.traj = std::move(candidate.score.traj);
+
+        dwb_msgs::msg::CriticScore cs;
+        cs.name = candidate.error->getCriticName();
+        cs.raw_score = -1.0;
+        failed_score.scores.push_back(cs);
+        failed_score.total = -1.0;
+        results->twists.push_back(failed_score);
+      }
+      tracker.addIllegalTrajectory(*candidate.error);
+      continue;
+    }
+
+    tracker.addLegalTrajectory();
+    const dwb_msgs::msg::TrajectoryScore & score = candidate.score;
+    if (results) {
+      results->twists.push_back(score);
+    }
+    if (best.total < 0 || score.total < best.total) {
+      best.total = score.total;
+      best_index = i;
+      if (results) {
+        results->best_index = results->twists.size() - 1;
+      }
+    }
+    if (worst.total < 0 || score.total > worst.total) {
+      worst.total = score.total;
+      if (results) {
+        results->worst_index = results->twists.size() - 1;
+      }
+    }
+  }
+
+  if (best.total < 0) {
+    if (debug_trajectory_details_) {
+      RCLCPP_ERROR(
+        rclcpp::get_logger("DWBLocalPlanner"), "%s",
+        tracker.getMessage().c_str());
+      for (auto const & x : tracker.getPercentages()) {
+        RCLCPP_ERROR(
+          rclcpp::get_logger("DWBLocalPlanner"), "%.2f: %10s/%s",
+          x.second, x.first.first.c_str(), x.first.second.c_str());
+      }
+    }
+    throw NoLegalTrajectoriesException(tracker);
+  }
+
+  return candidates[best_index].score;
+}
+
+dwb_msgs::msg::TrajectoryScore DWBLocalPlanner::batchScoringAlgorithm(
+  const geometry_msgs::msg::Pose2D & pose,
+  const nav_2d_msgs::msg::Twist2D velocity,
+  std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> & results)
+{
+  batch_.clear();
+  traj_generator_->startNewIteration(velocity);
+  while (traj_generator_->hasMoreTwists()) {
+    traj_generator_->generateTrajectory(pose, velocity, traj_generator_->nextTwist(), batch_);
+  }
+
+  const size_t num_trajectories = batch_.size();
+  batch_active_.assign(num_trajectories, 1);
+  std::vector<double> totals(num_trajectories, 0.0);
+  std::vector<std::shared_ptr<IllegalTrajectoryException>> illegal(num_trajectories);
+  batch_scores_.resize(critics_.size());
+
+  for (size_t c = 0; c < critics_.size(); ++c) {
+    TrajectoryCritic::Ptr & critic = critics_[c];
+    BatchScores & scores = batch_scores_[c];
+    scores.reset(num_trajectories);
+
+    double scale = critic->getScale();
+    if (scale == 0.0) {
+      continue;
+    }
+
+    if (scoring_pool_) {
+      scoring_pool_->parallelFor(
+        num_trajectories, [&](size_t /*chunk*/, size_t begin, size_t end) {
+          critic->scoreTrajectories(batch_, batch_active_, begin, end, scores);
+        });
+    } else {
+      critic->scoreTrajectories(batch_, batch_active_, 0, num_trajectories, scores);
+    }
+
+    for (size_t i = 0; i < num_trajectories; ++i) {
+      if (!batch_active_[i]) {
+        continue;
+      }
+      if (scores.illegal[i]) {
+        illegal[i] = scores.illegal[i];
+        batch_active_[i] = 0;
+        continue;
+      }
+      totals[i] += scores.raw[i] * scale;
+    }
+  }
+
+  // Rebuild the message form of a legal candidate, with the same critic entries
+  // scoreTrajectory would have produced
+  auto makeScore = [&](size_t i) {
+      dwb_msgs::msg::TrajectoryScore score;
+      batch_.getTrajectory(i, score.traj);
+      for (size_t c = 0; c < critics_.size(); ++c) {
+        dwb_msgs::msg::CriticScore cs;
+        cs.name = critics_[c]->getName();
+        cs.scale = critics_[c]->getScale();
+        if (cs.scale != 0.0) {
+          cs.raw_score = batch_scores_[c].raw[i];
+        }
+        score.scores.push_back(cs);
+      }
+      score.total = totals[i];
+      return score;
+    };
+
+  // Reduce in index order, exactly like the serial algorithm
+  double best_total = -1, worst_total = -1;
+  size_t best_index = 0;
+  IllegalTrajectoryTracker tracker;
+
+  for (size_t i = 0; i < num_trajectories; ++i) {
+    if (illegal[i]) {
+      if (results) {
+        dwb_msgs::msg::TrajectoryScore failed_score;
+        batch_.getTrajectory(i, failed_score.traj);
+
+        dwb_msgs::msg::CriticScore cs;
+        cs.name = illegal[i]->getCriticName();
+        cs.raw_score = -1.0;
+        failed_score.scores.push_back(cs);
+        failed_score.total = -1.0;
+        results->twists.push_back(failed_score);
+      }
+      tracker.addIllegalTrajectory(*illegal[i]);
+      continue;
+    }
+
+    tracker.addLegalTrajectory();
+    if (results) {
+      results->twists.push_back(makeScore(i));
+    }
+    if (best_total < 0 || totals[i] < best_total) {
+      best_total = totals[i];
+      best_index = i;
+      if (results) {
+        results->best_index = results->twists.size() - 1;
+      }
+    }
+    if (worst_total < 0 || totals[i] > worst_total) {
+      worst_total = totals[i];
+      if (results) {
+        results->worst_index = results->twists.size() - 1;
+      }
+    }
+  }
+
+  if (best_total < 0) {
+    if (debug_trajectory_details_) {
+      RCLCPP_ERROR(
+        rclcpp::get_logger("DWBLocalPlanner"), "%s",
+        tracker.getMessage().c_str());
+      for (auto const & x : tracker.getPercentages()) {
+        RCLCPP_ERROR(
+          rclcpp::get_logger("DWBLocalPlanner"), "%.2f: %10s/%s",
+          x.second, x.first.first.c_str(), x.first.second.c_str());
+      }
+    }
+    throw NoLegalTrajectoriesException(tracker);
+  }
+
+  return makeScore(best_index);
+}
+
 dwb_msgs::msg::TrajectoryScore DWBLocalPlanner::scoreTrajectory(
   const dwb_msgs::msg::Trajectory2D & traj, double best_score)
 {
@@ -450,6 +753,150 @@ dwb_msgs::msg::TrajectoryScore DWBLocalPlanner::scoreTrajectory(
   return score;
 }
 
+dwb_msgs::msg::TrajectoryScore DWBLocalPlanner::scoreTrajectoryAdaptive(
+  const dwb_msgs::msg::Trajectory2D & traj, double best_score)
+{
+  dwb_msgs::msg::TrajectoryScore score;
+  score.traj = traj;
+
+  std::vector<dwb_msgs::msg::CriticScore> critic_scores(critics_.size());
+  std::vector<uint8_t> scored(critics_.size(), 0);
+  double partial_total = 0.0;
+
+  for (size_t c : critic_order_) {
+    TrajectoryCritic::Ptr & critic = critics_[c];
+    CriticProfile & profile = critic_profiles_[c];
+    dwb_msgs::msg::CriticScore & cs = critic_scores[c];
+    cs.name = critic->getName();
+    cs.scale = critic->getScale();
+    scored[c] = 1;
+
+    if (cs.scale == 0.0) {
+      continue;
+    }
+
+    // Only one call in kProfileSamplePeriod is timed
+    const bool timed = profile.calls++ % kProfileSamplePeriod == 0;
+    std::chrono::steady_clock::time_point start;
+    if (timed) {
+      start = std::chrono::steady_clock::now();
+    }
+    double critic_score;
+    try {
+      critic_score = critic->scoreTrajectory(traj);
+    } catch (const dwb_core::IllegalTrajectoryException &) {
+      profile.rejects++;
+      if (timed) {
+        profile.time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start).count();
+        profile.timed_calls++;
+      }
+      if (replayConfiguredOrder(traj, best_score, critic_scores, scored, c, score)) {
+        return score;
+      }
+      throw;
+    }
+    if (timed) {
+      profile.time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+      profile.timed_calls++;
+    }
+
+    cs.raw_score = critic_score;
+    partial_total += critic_score * cs.scale;
+    if (short_circuit_trajectory_evaluation_ && best_score > 0 &&
+      partial_total > best_score)
+    {
+      profile.prunes++;
+      break;
+    }
+  }
+
+  // Report in configuration order, summing in the same order as scoreTrajectory
+  for (size_t c = 0; c < critics_.size(); ++c) {
+    if (!scored[c]) {
+      continue;
+    }
+    score.scores.push_back(critic_scores[c]);
+    if (critic_scores[c].scale != 0.0) {
+      score.total += critic_scores[c].raw_score * critic_scores[c].scale;
+    }
+  }
+
+  return score;
+}
+
+bool DWBLocalPlanner::replayConfiguredOrder(
+  const dwb_msgs::msg::Trajectory2D & traj, double best_score,
+  std::vector<dwb_msgs::msg::CriticScore> & critic_scores,
+  const std::vector<uint8_t> & scored, size_t end,
+  dwb_msgs::msg::TrajectoryScore & score)
+{
+  for (size_t c = 0; c < end; ++c) {
+    TrajectoryCritic::Ptr & critic = critics_[c];
+    dwb_msgs::msg::CriticScore & cs = critic_scores[c];
+    cs.name = critic->getName();
+    cs.scale = critic->getScale();
+
+    if (cs.scale == 0.0) {
+      score.scores.push_back(cs);
+      continue;
+    }
+
+    if (!scored[c]) {
+      try {
+        cs.raw_score = critic->scoreTrajectory(traj);
+      } catch (const dwb_core::IllegalTrajectoryException &) {
+        // The first rejecting critic in configuration order is the one
+        // scoreTrajectory reports
+        throw;
+      }
+    }
+    score.scores.push_back(cs);
+    score.total += cs.raw_score * cs.scale;
+    if (short_circuit_trajectory_evaluation_ && best_score > 0 &&
+      score.total > best_score)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void DWBLocalPlanner::updateCriticOrder()
+{
+  // Mean cost per decisive outcome; critics that were never run sort first
+  // so they get profiled, and ties keep the configured order
+  std::vector<double> rank(critics_.size(), 0.0);
+  for (size_t c = 0; c < critics_.size(); ++c) {
+    const CriticProfile & profile = critic_profiles_[c];
+    const uint64_t calls = profile.calls;
+    if (calls == 0) {
+      continue;
+    }
+    const uint64_t timed_calls = profile.timed_calls;
+    double mean_ns = timed_calls > 0 ? static_cast<double>(profile.time_ns) / timed_calls : 0.0;
+    double decisive_rate = static_cast<double>(profile.rejects + profile.prunes) / calls;
+    rank[c] = mean_ns / (decisive_rate + 0.01);
+  }
+
+  std::sort(
+    critic_order_.begin(), critic_order_.end(),
+    [&](size_t a, size_t b) {return rank[a] < rank[b] || (rank[a] == rank[b] && a < b);});
+
+  // Decay the statistics so the order follows the current environment
+  for (size_t c = 0; c < critics_.size(); ++c) {
+    CriticProfile & profile = critic_profiles_[c];
+    if (profile.calls > 100000) {
+      profile.calls = profile.calls / 2;
+      profile.time_ns = profile.time_ns / 2;
+      profile.timed_calls = profile.timed_calls / 2;
+      profile.rejects = profile.rejects / 2;
+      profile.prunes = profile.prunes / 2;
+    }
+  }
+}
+
 double getSquareDistance(
   const geometry_msgs::msg::Pose2D & pose_a,
   const geometry_msgs::msg::Pose2D & pose_b)
@@ -64,6 +64,11 @@ DWBPublisher::DWBPublisher(
   clock_ = node->get_clock();
 }
 
+DWBPublisher::~DWBPublisher()
+{
+  stopDebugThread();
+}
+
 nav2_util::CallbackReturn
 DWBPublisher::on_configure()
 {
@@ -93,6 +98,12 @@ DWBPublisher::on_configure()
   declare_parameter_if_not_declared(
     node, plugin_name_ + ".marker_lifetime",
     rclcpp::ParameterValue(0.1));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".debug_publish_rate",
+    rclcpp::ParameterValue(0.0));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".async_debug_publishing",
+    rclcpp::ParameterValue(false));
 
   node->get_parameter(plugin_name_ + ".publish_evaluation", publish_evaluation_);
   node->get_parameter(plugin_name_ + ".publish_global_plan", publish_global_plan_);
@@ -100,6 +111,10 @@ DWBPublisher::on_configure()
   node->get_parameter(plugin_name_ + ".publish_local_plan", publish_local_plan_);
   node->get_parameter(plugin_name_ + ".publish_trajectories", publish_trajectories_);
   node->get_parameter(plugin_name_ + ".publish_cost_grid_pc", publish_cost_grid_pc_);
+  node->get_parameter(plugin_name_ + ".debug_publish_rate", debug_publish_rate_);
+  node->get_parameter(plugin_name_ + ".async_debug_publishing", async_debug_publishing_);
+  last_evaluation_publish_ = rclcpp::Time(0, 0, clock_->get_clock_type());
+  last_cost_grid_publish_ = rclcpp::Time(0, 0, clock_->get_clock_type());
 
   eval_pub_ = node->create_publisher<dwb_msgs::msg::LocalPlanEvaluation>("evaluation", 1);
   global_pub_ = node->create_publisher<nav_msgs::msg::Path>("received_global_plan", 1);
@@ -125,12 +140,18 @@ DWBPublisher::on_activate()
   marker_pub_->on_activate();
   cost_grid_pc_pub_->on_activate();
 
+  if (async_debug_publishing_) {
+    startDebugThread();
+  }
+
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
 nav2_util::CallbackReturn
 DWBPublisher::on_deactivate()
 {
+  stopDebugThread();
+
   eval_pub_->on_deactivate();
   global_pub_->on_deactivate();
   transformed_pub_->on_deactivate();
@@ -144,6 +165,8 @@ DWBPublisher::on_deactivate()
 nav2_util::CallbackReturn
 DWBPublisher::on_cleanup()
 {
+  stopDebugThread();
+
   eval_pub_.reset();
   global_pub_.reset();
   transformed_pub_.reset();
@@ -154,16 +177,58 @@ DWBPublisher::on_cleanup()
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
+bool
+DWBPublisher::shouldRecordEvaluation()
+{
+  // Recording the evaluation copies every candidate trajectory, so only do it
+  // when the result will actually be published
+  bool wanted = (publish_evaluation_ && eval_pub_->get_subscription_count() > 0) ||
+    (publish_trajectories_ && marker_pub_->get_subscription_count() > 0);
+  return wanted && debugPublishDue(last_evaluation_publish_);
+}
+
+bool
+DWBPublisher::debugPublishDue(rclcpp::Time & last_publish)
+{
+  if (debug_publish_rate_ <= 0.0) {
+    return true;
+  }
+  rclcpp::Time now = clock_->now();
+  if ((now - last_publish).seconds() < 1.0 / debug_publish_rate_) {
+    return false;
+  }
+  last_publish = now;
+  return true;
+}
+
 void
 DWBPublisher::publishEvaluation(std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> results)
 {
-  if (results) {
-    if (publish_evaluation_ && eval_pub_->get_subscription_count() > 0) {
-      auto msg = std::make_unique<dwb_msgs::msg::LocalPlanEvaluation>(*results);
-      eval_pub_->publish(std::move(msg));
+  if (!results) {
+    return;
+  }
+
+  if (debug_thread_.joinable()) {
+    // The planner does not touch results after this call, so it is handed over as is
+    {
+      std::lock_guard<std::mutex> lock(debug_mutex_);
+      pending_evaluation_ = results;
     }
-    publishTrajectories(*results);
+    debug_cv_.notify_one();
+    return;
   }
+
+  publishEvaluationNow(*results);
+}
+
+void
+DWBPublisher::publishEvaluationNow(const dwb_msgs::msg::LocalPlanEvaluation & results)
+{
+  if (publish_evaluation_ && eval_pub_->get_subscription_count() > 0) {
+    auto msg = std::make_unique<dwb_msgs::msg::LocalPlanEvaluation>(results);
+    eval_pub_->publish(std::move(msg));
+  }
+  publishTrajectories(results);
 }
 
 void
@@ -257,32 +322,61 @@ DWBPublisher::publishCostGrid(
 
   if (!publish_cost_grid_pc_) {return;}
 
-  auto cost_grid_pc = std::make_unique<sensor_msgs::msg::PointCloud2>();
-  cost_grid_pc->header.frame_id = costmap_ros->getGlobalFrameID();
-  cost_grid_pc->header.stamp = clock_->now();
+  if (!debugPublishDue(last_cost_grid_publish_)) {return;}
+
+  // The critic grids change on the next prepare, so their data is copied here
+  auto snapshot = std::make_unique<CostGridSnapshot>();
+  snapshot->header.frame_id = costmap_ros->getGlobalFrameID();
+  snapshot->header.stamp = clock_->now();
 
   nav2_costmap_2d::Costmap2D * costmap = costmap_ros->getCostmap();
-  double x_coord, y_coord;
-  unsigned int size_x = costmap->getSizeInCellsX();
-  unsigned int size_y = costmap->getSizeInCellsY();
+  snapshot->size_x = costmap->getSizeInCellsX();
+  snapshot->size_y = costmap->getSizeInCellsY();
+  snapshot->origin_x = costmap->getOriginX();
+  snapshot->origin_y = costmap->getOriginY();
+  snapshot->resolution = costmap->getResolution();
+
+  for (const TrajectoryCritic::Ptr & critic : critics) {
+    snapshot->critics.emplace_back(critic->snapshotCriticVisualization(), critic->getScale());
+  }
 
-  std::vector<std::pair<std::string, std::vector<float>>> cost_channels;
+  if (debug_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(debug_mutex_);
+      pending_cost_grid_ = std::move(snapshot);
+    }
+    debug_cv_.notify_one();
+    return;
+  }
+
+  publishCostGridNow(*snapshot);
+}
+
+void
+DWBPublisher::publishCostGridNow(const CostGridSnapshot & snapshot)
+{
+  unsigned int size_x = snapshot.size_x;
+  unsigned int size_y = snapshot.size_y;
+  TrajectoryCritic::CostChannels cost_channels;
   std::vector<float> total_cost(size_x * size_y, 0.0);
 
-  for (TrajectoryCritic::Ptr critic : critics) {
+  for (const auto & critic : snapshot.critics) {
     unsigned int channel_index = cost_channels.size();
-    critic->addCriticVisualization(cost_channels);
+    critic.first(cost_channels);
     if (channel_index == cost_channels.size()) {
       // No channels were added, so skip to next critic
       continue;
     }
-    double scale = critic->getScale();
+    double scale = critic.second;
     for (unsigned int i = 0; i < size_x * size_y; i++) {
       total_cost[i] += cost_channels[channel_index].second[i] * scale;
     }
   }
 
-  cost_channels.push_back(std::make_pair("total_cost", total_cost));
+  cost_channels.push_back(std::make_pair("total_cost", std::move(total_cost)));
+
+  auto cost_grid_pc = std::make_unique<sensor_msgs::msg::PointCloud2>();
+  cost_grid_pc->header = snapshot.header;
 
   cost_grid_pc->width = size_x * size_y;
   cost_grid_pc->height = 1;
@@ -318,9 +412,9 @@ DWBPublisher::publishCostGrid(
   unsigned int j = 0;
   for (unsigned int cy = 0; cy < size_y; cy++) {
     for (unsigned int cx = 0; cx < size_x; cx++) {
-      costmap->mapToWorld(cx, cy, x_coord, y_coord);
-      *cost_grid_pc_iter[0] = x_coord;
-      *cost_grid_pc_iter[1] = y_coord;
+      // Same as Costmap2D::mapToWorld
+      *cost_grid_pc_iter[0] = snapshot.origin_x + (cx + 0.5) * snapshot.resolution;
+      *cost_grid_pc_iter[1] = snapshot.origin_y + (cy + 0.5) * snapshot.resolution;
       *cost_grid_pc_iter[2] = 0.0;   // z value
 
       for (size_t i = 3; i < cost_grid_pc_iter.size(); ++i) {
@@ -337,6 +431,61 @@ DWBPublisher::publishCostGrid(
   cost_grid_pc_pub_->publish(std::move(cost_grid_pc));
 }
 
+void
+DWBPublisher::startDebugThread()
+{
+  if (debug_thread_.joinable()) {
+    return;
+  }
+  debug_thread_stop_ = false;
+  debug_thread_ = std::thread(&DWBPublisher::debugThreadLoop, this);
+}
+
+void
+DWBPublisher::stopDebugThread()
+{
+  if (!debug_thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(debug_mutex_);
+    debug_thread_stop_ = true;
+  }
+  debug_cv_.notify_one();
+  debug_thread_.join();
+  pending_evaluation_.reset();
+  pending_cost_grid_.reset();
+}
+
+void
+DWBPublisher::debugThreadLoop()
+{
+  while (true) {
+    std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> evaluation;
+    std::unique_ptr<CostGridSnapshot> cost_grid;
+    {
+      std::unique_lock<std::mutex> lock(debug_mutex_);
+      debug_cv_.wait(
+        lock, [this] {
+          return debug_thread_stop_ || pending_evaluation_ || pending_cost_grid_;
+        });
+      if (debug_thread_stop_) {
+        return;
+      }
+      // Only the latest output of each kind is kept, older ones are dropped
+      evaluation = std::move(pending_evaluation_);
+      cost_grid = std::move(pending_cost_grid_);
+    }
+
+    if (evaluation) {
+      publishEvaluationNow(*evaluation);
+    }
+    if (cost_grid) {
+      publishCostGridNow(*cost_grid);
+    }
+  }
+}
+
 void
 DWBPublisher::publishGlobalPlan(const nav_2d_msgs::msg::Path2D plan)
 {
@@ -0,0 +1,121 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dwb_core/scoring_pool.hpp"
+
+#include <algorithm>
+
+namespace dwb_core
+{
+
+ScoringPool::ScoringPool(unsigned int num_threads)
+{
+  if (num_threads == 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  errors_.resize(num_threads);
+  for (size_t i = 1; i < num_threads; ++i) {
+    workers_.emplace_back(&ScoringPool::workerLoop, this, i);
+  }
+}
+
+ScoringPool::~ScoringPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto & worker : workers_) {
+    worker.join();
+  }
+}
+
+void ScoringPool::parallelFor(size_t count, const ChunkFunction & fn)
+{
+  if (count == 0) {
+    return;
+  }
+
+  if (workers_.empty()) {
+    fn(0, 0, count);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fn_ = &fn;
+    count_ = count;
+    pending_ = workers_.size();
+    std::fill(errors_.begin(), errors_.end(), nullptr);
+    ++generation_;
+  }
+  work_cv_.notify_all();
+
+  runChunk(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this] {return pending_ == 0;});
+  fn_ = nullptr;
+
+  for (auto & error : errors_) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+void ScoringPool::workerLoop(size_t chunk_id)
+{
+  size_t seen_generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_cv_.wait(lock, [&] {return stop_ || generation_ != seen_generation;});
+      if (stop_) {
+        return;
+      }
+      seen_generation = generation_;
+    }
+
+    runChunk(chunk_id);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --pending_;
+    }
+    done_cv_.notify_one();
+  }
+}
+
+void ScoringPool::runChunk(size_t chunk_id)
+{
+  // Contiguous, near-equal chunks: the first (count % size) chunks get one extra index
+  const size_t chunks = size();
+  const size_t base = count_ / chunks;
+  const size_t extra = count_ % chunks;
+  const size_t begin = chunk_id * base + std::min(chunk_id, extra);
+  const size_t end = begin + base + (chunk_id < extra ? 1 : 0);
+  if (begin == end) {
+    return;
+  }
+
+  try {
+    (*fn_)(chunk_id, begin, end);
+  } catch (...) {
+    errors_[chunk_id] = std::current_exception();
+  }
+}
+
+}  // namespace dwb_core
@@ -0,0 +1,279 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "dwb_core/dwb_local_planner.hpp"
+#include "dwb_core/illegal_trajectory_tracker.hpp"
+
+namespace
+{
+
+// Scores trajectory i (its velocity.x) from a table, negative entries reject it
+class TableCritic : public dwb_core::TrajectoryCritic
+{
+public:
+  TableCritic(const std::string & name, double scale, std::vector<double> table)
+  : table_(std::move(table))
+  {
+    name_ = name;
+    setScale(scale);
+  }
+
+  double scoreTrajectory(const dwb_msgs::msg::Trajectory2D & traj) override
+  {
+    double score = table_[static_cast<size_t>(traj.velocity.x)];
+    if (score < 0.0) {
+      throw dwb_core::IllegalTrajectoryException(name_, "Rejected.");
+    }
+    return score;
+  }
+
+private:
+  std::vector<double> table_;
+};
+
+class IndexGenerator : public dwb_core::TrajectoryGenerator
+{
+public:
+  explicit IndexGenerator(size_t count)
+  : count_(count) {}
+
+  void initialize(const nav2_util::LifecycleNode::SharedPtr &, const std::string &) override {}
+  void startNewIteration(const nav_2d_msgs::msg::Twist2D &) override {next_ = 0;}
+  bool hasMoreTwists() override {return next_ < count_;}
+  nav_2d_msgs::msg::Twist2D nextTwist() override
+  {
+    nav_2d_msgs::msg::Twist2D twist;
+    twist.x = static_cast<double>(next_++);
+    return twist;
+  }
+  dwb_msgs::msg::Trajectory2D generateTrajectory(
+    const geometry_msgs::msg::Pose2D & start_pose,
+    const nav_2d_msgs::msg::Twist2D &,
+    const nav_2d_msgs::msg::Twist2D & cmd_vel) override
+  {
+    dwb_msgs::msg::Trajectory2D traj;
+    traj.velocity = cmd_vel;
+    traj.poses.push_back(start_pose);
+    return traj;
+  }
+  void setSpeedLimit(const double &, const bool &) override {}
+
+private:
+  size_t count_;
+  size_t next_{0};
+};
+
+class TestPlanner : public dwb_core::DWBLocalPlanner
+{
+public:
+  TestPlanner(std::vector<dwb_core::TrajectoryCritic::Ptr> critics, size_t num_twists)
+  {
+    critics_ = std::move(critics);
+    traj_generator_ = std::make_shared<IndexGenerator>(num_twists);
+    short_circuit_trajectory_evaluation_ = true;
+    debug_trajectory_details_ = false;
+    parallel_scoring_ = false;
+    batch_scoring_ = false;
+    adaptive_critic_order_ = false;
+    critic_order_.resize(critics_.size());
+    for (size_t i = 0; i < critic_order_.size(); ++i) {
+      critic_order_[i] = i;
+    }
+    critic_profiles_ = std::make_unique<CriticProfile[]>(critics_.size());
+  }
+
+  void setAdaptiveOrder(const std::vector<size_t> & order)
+  {
+    adaptive_critic_order_ = true;
+    critic_order_ = order;
+  }
+
+  dwb_msgs::msg::TrajectoryScore scoreBest()
+  {
+    std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> results;
+    return coreScoringAlgorithm(
+      geometry_msgs::msg::Pose2D(), nav_2d_msgs::msg::Twist2D(), results);
+  }
+
+  using dwb_core::DWBLocalPlanner::scoreTrajectoryAdaptive;
+};
+
+struct Setup
+{
+  std::vector<dwb_core::TrajectoryCritic::Ptr> critics;
+  std::vector<size_t> order;
+};
+
+Setup randomSetup(std::mt19937 & rng, size_t num_critics, size_t num_twists, double reject_rate)
+{
+  std::uniform_real_distribution<double> score(0.0, 10.0);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  Setup setup;
+  for (size_t c = 0; c < num_critics; ++c) {
+    std::vector<double> table(num_twists);
+    for (double & value : table) {
+      value = unit(rng) < reject_rate ? -1.0 : score(rng);
+    }
+    double scale = unit(rng) < 0.15 ? 0.0 : 0.5 + unit(rng);
+    setup.critics.push_back(
+      std::make_shared<TableCritic>("Critic" + std::to_string(c), scale, table));
+    setup.order.push_back(c);
+  }
+  std::shuffle(setup.order.begin(), setup.order.end(), rng);
+  return setup;
+}
+
+dwb_msgs::msg::Trajectory2D indexTrajectory(size_t i)
+{
+  dwb_msgs::msg::Trajectory2D traj;
+  traj.velocity.x = static_cast<double>(i);
+  return traj;
+}
+
+void expectSameScores(
+  const dwb_msgs::msg::TrajectoryScore & expected,
+  const dwb_msgs::msg::TrajectoryScore & actual)
+{
+  EXPECT_EQ(actual.traj.velocity.x, expected.traj.velocity.x);
+  EXPECT_EQ(actual.total, expected.total);
+  ASSERT_EQ(actual.scores.size(), expected.scores.size());
+  for (size_t c = 0; c < expected.scores.size(); ++c) {
+    EXPECT_EQ(actual.scores[c].name, expected.scores[c].name);
+    EXPECT_EQ(actual.scores[c].raw_score, expected.scores[c].raw_score);
+  }
+}
+
+}  // namespace
+
+TEST(AdaptiveCriticOrder, SameTrajectoryOutcome)
+{
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> bound(0.0, 30.0);
+  const size_t num_twists = 40;
+
+  for (int round = 0; round < 50; ++round) {
+    Setup setup = randomSetup(rng, 5, num_twists, 0.1);
+    TestPlanner serial(setup.critics, num_twists);
+    TestPlanner adaptive(setup.critics, num_twists);
+    adaptive.setAdaptiveOrder(setup.order);
+
+    for (size_t i = 0; i < num_twists; ++i) {
+      dwb_msgs::msg::Trajectory2D traj = indexTrajectory(i);
+      double best_score = i % 4 == 0 ? -1.0 : bound(rng);
+
+      std::string serial_critic, adaptive_critic;
+      dwb_msgs::msg::TrajectoryScore serial_score, adaptive_score;
+      try {
+        serial_score = serial.scoreTrajectory(traj, best_score);
+      } catch (const dwb_core::IllegalTrajectoryException & e) {
+        serial_critic = e.getCriticName();
+      }
+      try {
+        adaptive_score = adaptive.scoreTrajectoryAdaptive(traj, best_score);
+      } catch (const dwb_core::IllegalTrajectoryException & e) {
+        adaptive_critic = e.getCriticName();
+      }
+
+      const bool serial_pruned = serial_critic.empty() && best_score > 0 &&
+        serial_score.total > best_score;
+      if (!serial_critic.empty()) {
+        // Rejected by the same critic, unless pruned before running it
+        if (adaptive_critic.empty()) {
+          EXPECT_GT(adaptive_score.total, best_score);
+        } else {
+          EXPECT_EQ(adaptive_critic, serial_critic);
+        }
+      } else if (serial_pruned) {
+        EXPECT_TRUE(adaptive_critic.empty());
+        EXPECT_GT(adaptive_score.total, best_score);
+      } else {
+        EXPECT_TRUE(adaptive_critic.empty());
+        expectSameScores(serial_score, adaptive_score);
+      }
+    }
+  }
+}
+
+TEST(AdaptiveCriticOrder, SameBestTwist)
+{
+  std::mt19937 rng(11);
+  const size_t num_twists = 60;
+
+  for (int round = 0; round < 50; ++round) {
+    Setup setup = randomSetup(rng, 6, num_twists, 0.05);
+    TestPlanner serial(setup.critics, num_twists);
+    TestPlanner adaptive(setup.critics, num_twists);
+    adaptive.setAdaptiveOrder(setup.order);
+
+    dwb_msgs::msg::TrajectoryScore serial_best, adaptive_best;
+    bool serial_failed = false, adaptive_failed = false;
+    try {
+      serial_best = serial.scoreBest();
+    } catch (const dwb_core::NoLegalTrajectoriesException &) {
+      serial_failed = true;
+    }
+    try {
+      adaptive_best = adaptive.scoreBest();
+    } catch (const dwb_core::NoLegalTrajectoriesException &) {
+      adaptive_failed = true;
+    }
+
+    ASSERT_EQ(adaptive_failed, serial_failed);
+    if (!serial_failed) {
+      expectSameScores(serial_best, adaptive_best);
+    }
+  }
+}
+
+TEST(AdaptiveCriticOrder, SameRejectionAttribution)
+{
+  std::mt19937 rng(13);
+  const size_t num_twists = 30;
+
+  for (int round = 0; round < 50; ++round) {
+    // Every trajectory is rejected by at least one critic
+    Setup setup = randomSetup(rng, 4, num_twists, 0.4);
+    std::vector<double> reject_all(num_twists, -1.0);
+    setup.critics.push_back(std::make_shared<TableCritic>("RejectAll", 1.0, reject_all));
+    setup.order.insert(setup.order.begin(), setup.critics.size() - 1);
+
+    TestPlanner serial(setup.critics, num_twists);
+    TestPlanner adaptive(setup.critics, num_twists);
+    adaptive.setAdaptiveOrder(setup.order);
+
+    std::map<std::pair<std::string, std::string>, double> serial_percentages, adaptive_percentages;
+    try {
+      serial.scoreBest();
+      FAIL() << "Every trajectory should be rejected";
+    } catch (const dwb_core::NoLegalTrajectoriesException & e) {
+      serial_percentages = e.tracker_.getPercentages();
+    }
+    try {
+      adaptive.scoreBest();
+      FAIL() << "Every trajectory should be rejected";
+    } catch (const dwb_core::NoLegalTrajectoriesException & e) {
+      adaptive_percentages = e.tracker_.getPercentages();
+    }
+    EXPECT_EQ(adaptive_percentages, serial_percentages);
+  }
+}
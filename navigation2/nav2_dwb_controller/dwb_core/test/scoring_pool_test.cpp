@@ -0,0 +1,85 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "dwb_core/scoring_pool.hpp"
+
+using dwb_core::ScoringPool;
+
+TEST(ScoringPool, CoversEveryIndexOnce)
+{
+  ScoringPool pool(4);
+  EXPECT_EQ(pool.size(), 4u);
+
+  for (size_t count : {0u, 1u, 3u, 4u, 401u}) {
+    std::vector<int> hits(count, 0);
+    pool.parallelFor(
+      count, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          hits[i]++;
+        }
+      });
+    for (size_t i = 0; i < count; ++i) {
+      EXPECT_EQ(hits[i], 1) << "count " << count << " index " << i;
+    }
+  }
+}
+
+TEST(ScoringPool, ContiguousChunks)
+{
+  ScoringPool pool(3);
+  std::vector<size_t> chunk_of(10, 99);
+  pool.parallelFor(
+    10, [&](size_t chunk, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        chunk_of[i] = chunk;
+      }
+    });
+  std::vector<size_t> expected{0, 0, 0, 0, 1, 1, 1, 2, 2, 2};
+  EXPECT_EQ(chunk_of, expected);
+}
+
+TEST(ScoringPool, RethrowsFirstError)
+{
+  ScoringPool pool(2);
+  EXPECT_THROW(
+    pool.parallelFor(
+      8, [](size_t chunk, size_t, size_t) {
+        if (chunk == 1) {
+          throw std::runtime_error("chunk failed");
+        }
+      }), std::runtime_error);
+
+  // The pool must remain usable after an error
+  size_t total = 0;
+  pool.parallelFor(
+    8, [&](size_t chunk, size_t begin, size_t end) {
+      if (chunk == 0) {
+        total = end - begin;
+      }
+    });
+  EXPECT_EQ(total, 4u);
+}
+
+TEST(ScoringPool, SingleThread)
+{
+  ScoringPool pool(1);
+  EXPECT_EQ(pool.size(), 1u);
+  size_t calls = 0;
+  pool.parallelFor(5, [&](size_t, size_t begin, size_t end) {calls += end - begin;});
+  EXPECT_EQ(calls, 5u);
+}
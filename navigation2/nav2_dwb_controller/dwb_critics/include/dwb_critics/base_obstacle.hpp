@@ -59,8 +59,13 @@ class BaseObstacleCritic : public dwb_core::TrajectoryCritic
 public:
   void onInit() override;
   double scoreTrajectory(const dwb_msgs::msg::Trajectory2D & traj) override;
+  bool isThreadSafe() const override {return true;}
+  void scoreTrajectories(
+    const dwb_core::TrajectoryBatch & batch, const std::vector<uint8_t> & active,
+    size_t begin, size_t end, dwb_core::BatchScores & scores) override;
   void addCriticVisualization(
     std::vector<std::pair<std::string, std::vector<float>>> & cost_channels) override;
+  VisualizationSnapshot snapshotCriticVisualization() override;
 
   /**
    * @brief Return the obstacle score for a particular pose
@@ -42,6 +42,7 @@
 
 #include "dwb_core/trajectory_critic.hpp"
 #include "costmap_queue/costmap_queue.hpp"
+#include "dwb_core/exceptions.hpp"
 
 namespace dwb_critics
 {
@@ -64,8 +65,13 @@ public:
   // Standard TrajectoryCritic Interface
   void onInit() override;
   double scoreTrajectory(const dwb_msgs::msg::Trajectory2D & traj) override;
+  bool isThreadSafe() const override {return true;}
+  void scoreTrajectories(
+    const dwb_core::TrajectoryBatch & batch, const std::vector<uint8_t> & active,
+    size_t begin, size_t end, dwb_core::BatchScores & scores) override;
   void addCriticVisualization(
     std::vector<std::pair<std::string, std::vector<float>>> & cost_channels) override;
+  VisualizationSnapshot snapshotCriticVisualization() override;
   double getScale() const override {return costmap_->getResolution() * 0.5 * scale_;}
 
   // Helper Functions
@@ -93,6 +99,13 @@ public:
    */
   void setAsObstacle(unsigned int index);
 
+  /**
+   * @brief Mark a cell as a source of the distance propagation (score 0)
+   * @param x x-coordinate within the costmap
+   * @param y y-coordinate within the costmap
+   */
+  void addSourceCell(unsigned int x, unsigned int y);
+
 protected:
   /**
    * @brief Separate modes for aggregating scores across the multiple poses in a trajectory.
@@ -127,15 +140,99 @@ protected:
 
   /**
    * @brief Go through the queue and set the cells to the Manhattan distance from their parents
+   *
+   * With windowed_propagation enabled, only the cells of the window set by
+   * setPropagationWindow get a distance, computed by propagateWindow.
    */
   void propogateManhattanDistances();
 
+  /**
+   * @brief Restrict the next propagation to the cells the robot can reach
+   *
+   * The window is centered on the robot and extends as far as the robot can
+   * travel within sim_time at the larger of its current and maximum speed,
+   * plus window_padding_. Does nothing unless windowed_propagation is set.
+   *
+   * @param pose Current pose (costmap frame)
+   * @param vel Current velocity
+   */
+  void setPropagationWindow(
+    const geometry_msgs::msg::Pose2D & pose,
+    const nav_2d_msgs::msg::Twist2D & vel);
+
+  /**
+   * @brief Compute the Manhattan distance to the nearest source for the window cells
+   *
+   * MapGridQueue accepts every cell, so the queue expansion yields the exact
+   * Manhattan distance to the nearest source. The same values are computed
+   * here with a two-pass distance transform restricted to the window. Sources
+   * outside the window are moved to the closest window cell with their
+   * distance to it as initial value, which is exact for the Manhattan metric
+   * on an axis-aligned window.
+   */
+  void propagateWindow();
+
+  /**
+   * @brief Aggregate the scores of the poses of one trajectory
+   * @param num_poses Number of poses in the trajectory
+   * @param pose_at Callable returning pose j of the trajectory
+   */
+  template<typename PoseAt>
+  double aggregateScores(size_t num_poses, PoseAt pose_at)
+  {
+    double score = 0.0;
+    size_t start_index = 0;
+    if (aggregationType_ == ScoreAggregationType::Product) {
+      score = 1.0;
+    } else if (aggregationType_ == ScoreAggregationType::Last && !stop_on_failure_) {
+      start_index = num_poses - 1;
+    }
+    double grid_dist;
+
+    for (size_t i = start_index; i < num_poses; ++i) {
+      grid_dist = scorePose(pose_at(i));
+      if (stop_on_failure_) {
+        if (grid_dist == obstacle_score_) {
+          throw dwb_core::
+                IllegalTrajectoryException(name_, "Trajectory Hits Obstacle.");
+        } else if (grid_dist == unreachable_score_) {
+          throw dwb_core::
+                IllegalTrajectoryException(name_, "Trajectory Hits Unreachable Area.");
+        }
+      }
+
+      switch (aggregationType_) {
+        case ScoreAggregationType::Last:
+          score = grid_dist;
+          break;
+        case ScoreAggregationType::Sum:
+          score += grid_dist;
+          break;
+        case ScoreAggregationType::Product:
+          if (score > 0) {
+            score *= grid_dist;
+          }
+          break;
+      }
+    }
+
+    return score;
+  }
+
   std::shared_ptr<MapGridQueue> queue_;
   nav2_costmap_2d::Costmap2D * costmap_;
   std::vector<double> cell_values_;
   double obstacle_score_, unreachable_score_;  ///< Special cell_values
   bool stop_on_failure_;
   ScoreAggregationType aggregationType_;
+
+  // Windowed propagation
+  bool windowed_propagation_;
+  double window_padding_;
+  double max_reach_speed_, sim_time_;
+  std::vector<std::pair<unsigned int, unsigned int>> sources_;
+  unsigned int window_x0_{0}, window_y0_{0}, window_x1_{0}, window_y1_{0};
+  bool window_valid_{false};
 };
 }  // namespace dwb_critics
 
@@ -68,6 +68,9 @@ public:
   bool prepare(
     const geometry_msgs::msg::Pose2D & pose, const nav_2d_msgs::msg::Twist2D & vel,
     const geometry_msgs::msg::Pose2D & goal, const nav_2d_msgs::msg::Path2D & global_plan) override;
+  void scoreTrajectories(
+    const dwb_core::TrajectoryBatch & batch, const std::vector<uint8_t> & active,
+    size_t begin, size_t end, dwb_core::BatchScores & scores) override;
   double scorePose(const geometry_msgs::msg::Pose2D & pose) override;
   virtual double scorePose(
     const geometry_msgs::msg::Pose2D & pose,
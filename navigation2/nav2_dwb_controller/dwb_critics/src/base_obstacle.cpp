@@ -31,6 +31,7 @@
  *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  *  POSSIBILITY OF SUCH DAMAGE.
  */
+#include <memory>
 #include <vector>
 #include <string>
 #include <utility>
@@ -73,6 +74,50 @@ double BaseObstacleCritic::scoreTrajectory(const dwb_msgs::msg::Trajectory2D & t
   return score;
 }
 
+void BaseObstacleCritic::scoreTrajectories(
+  const dwb_core::TrajectoryBatch & batch, const std::vector<uint8_t> & active,
+  size_t begin, size_t end, dwb_core::BatchScores & scores)
+{
+  // Look the cells up straight from the pose arrays, inlining Costmap2D::worldToMap
+  const unsigned char * charmap = costmap_->getCharMap();
+  const double origin_x = costmap_->getOriginX();
+  const double origin_y = costmap_->getOriginY();
+  const double resolution = costmap_->getResolution();
+  const unsigned int size_x = costmap_->getSizeInCellsX();
+  const unsigned int size_y = costmap_->getSizeInCellsY();
+
+  for (size_t i = begin; i < end; ++i) {
+    if (!active[i]) {
+      continue;
+    }
+    double score = 0.0;
+    for (size_t k = batch.pose_begin[i]; k < batch.pose_begin[i + 1]; ++k) {
+      const double wx = batch.x[k];
+      const double wy = batch.y[k];
+      unsigned int cell_x = 0, cell_y = 0;
+      bool on_grid = wx >= origin_x && wy >= origin_y;
+      if (on_grid) {
+        cell_x = static_cast<unsigned int>((wx - origin_x) / resolution);
+        cell_y = static_cast<unsigned int>((wy - origin_y) / resolution);
+        on_grid = cell_x < size_x && cell_y < size_y;
+      }
+      if (!on_grid) {
+        scores.illegal[i] = std::make_shared<dwb_core::IllegalTrajectoryException>(
+          name_, "Trajectory Goes Off Grid.");
+        break;
+      }
+      unsigned char cost = charmap[cell_y * size_x + cell_x];
+      if (!isValidCost(cost)) {
+        scores.illegal[i] = std::make_shared<dwb_core::IllegalTrajectoryException>(
+          name_, "Trajectory Hits Obstacle.");
+        break;
+      }
+      score = static_cast<double>(sum_scores_) * score + cost;
+    }
+    scores.raw[i] = score;
+  }
+}
+
 double BaseObstacleCritic::scorePose(const geometry_msgs::msg::Pose2D & pose)
 {
   unsigned int cell_x, cell_y;
@@ -114,4 +159,16 @@ void BaseObstacleCritic::addCriticVisualization(
   cost_channels.push_back(grid_scores);
 }
 
+dwb_core::TrajectoryCritic::VisualizationSnapshot BaseObstacleCritic::snapshotCriticVisualization()
+{
+  // Same channel as addCriticVisualization, the costmap is stored row by row
+  const unsigned char * charmap = costmap_->getCharMap();
+  auto costs = std::make_shared<std::vector<unsigned char>>(
+    charmap, charmap + costmap_->getSizeInCellsX() * costmap_->getSizeInCellsY());
+  std::string name = name_;
+  return [name, costs](CostChannels & cost_channels) {
+           cost_channels.emplace_back(name, std::vector<float>(costs->begin(), costs->end()));
+         };
+}
+
 }  // namespace dwb_critics
@@ -55,6 +55,8 @@ void GoalAlignCritic::onInit()
   forward_point_distance_ = nav_2d_utils::searchAndGetParam(
     node,
     dwb_plugin_name_ + "." + name_ + ".forward_point_distance", 0.325);
+  // Scored poses are projected forward_point_distance ahead of the trajectory
+  window_padding_ += forward_point_distance_;
 }
 
 bool GoalAlignCritic::prepare(
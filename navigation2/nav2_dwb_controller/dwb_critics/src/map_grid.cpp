@@ -42,6 +42,7 @@
 #include "dwb_core/exceptions.hpp"
 #include "nav2_costmap_2d/cost_values.hpp"
 #include "nav2_util/node_utils.hpp"
+#include "nav_2d_utils/parameters.hpp"
 
 using std::abs;
 using costmap_queue::CellData;
@@ -73,6 +74,27 @@ void MapGridCritic::onInit()
     dwb_plugin_name_ + "." + name_ + ".aggregation_type",
     rclcpp::ParameterValue(std::string("last")));
 
+  nav2_util::declare_parameter_if_not_declared(
+    node,
+    dwb_plugin_name_ + "." + name_ + ".windowed_propagation",
+    rclcpp::ParameterValue(false));
+  nav2_util::declare_parameter_if_not_declared(
+    node,
+    dwb_plugin_name_ + "." + name_ + ".window_padding",
+    rclcpp::ParameterValue(0.5));
+  node->get_parameter(
+    dwb_plugin_name_ + "." + name_ + ".windowed_propagation",
+    windowed_propagation_);
+  node->get_parameter(dwb_plugin_name_ + "." + name_ + ".window_padding", window_padding_);
+
+  // The reachable area follows the trajectory generator's limits
+  sim_time_ = nav_2d_utils::searchAndGetParam(node, dwb_plugin_name_ + ".sim_time", 1.7);
+  max_reach_speed_ = std::max(
+    {nav_2d_utils::searchAndGetParam(node, dwb_plugin_name_ + ".max_speed_xy", 0.0),
+      std::fabs(nav_2d_utils::searchAndGetParam(node, dwb_plugin_name_ + ".max_vel_x", 0.0)),
+      std::fabs(nav_2d_utils::searchAndGetParam(node, dwb_plugin_name_ + ".min_vel_x", 0.0)),
+      std::fabs(nav_2d_utils::searchAndGetParam(node, dwb_plugin_name_ + ".max_vel_y", 0.0))});
+
   std::string aggro_str;
   node->get_parameter(dwb_plugin_name_ + "." + name_ + ".aggregation_type", aggro_str);
   std::transform(aggro_str.begin(), aggro_str.end(), aggro_str.begin(), ::tolower);
@@ -96,17 +118,122 @@ void MapGridCritic::setAsObstacle(unsigned int index)
   cell_values_[index] = obstacle_score_;
 }
 
+void MapGridCritic::addSourceCell(unsigned int x, unsigned int y)
+{
+  if (windowed_propagation_) {
+    sources_.emplace_back(x, y);
+    return;
+  }
+  cell_values_[costmap_->getIndex(x, y)] = 0.0;
+  queue_->enqueueCell(x, y);
+}
+
 void MapGridCritic::reset()
 {
-  queue_->reset();
-  cell_values_.resize(costmap_->getSizeInCellsX() * costmap_->getSizeInCellsY());
-  obstacle_score_ = static_cast<double>(cell_values_.size());
+  const size_t size = costmap_->getSizeInCellsX() * costmap_->getSizeInCellsY();
+  obstacle_score_ = static_cast<double>(size);
   unreachable_score_ = obstacle_score_ + 1.0;
+
+  if (windowed_propagation_) {
+    // Only the previous window can hold anything but the unreachable score
+    sources_.clear();
+    if (cell_values_.size() != size) {
+      cell_values_.assign(size, unreachable_score_);
+    } else if (window_valid_) {
+      for (unsigned int y = window_y0_; y <= window_y1_; ++y) {
+        auto row = cell_values_.begin() + costmap_->getIndex(window_x0_, y);
+        std::fill(row, row + (window_x1_ - window_x0_ + 1), unreachable_score_);
+      }
+    }
+    window_valid_ = false;
+    return;
+  }
+
+  queue_->reset();
+  cell_values_.resize(size);
   std::fill(cell_values_.begin(), cell_values_.end(), unreachable_score_);
 }
 
+void MapGridCritic::setPropagationWindow(
+  const geometry_msgs::msg::Pose2D & pose,
+  const nav_2d_msgs::msg::Twist2D & vel)
+{
+  if (!windowed_propagation_) {
+    return;
+  }
+
+  double reach = std::max(max_reach_speed_, std::hypot(vel.x, vel.y)) * sim_time_ +
+    window_padding_;
+  int radius = static_cast<int>(std::ceil(reach / costmap_->getResolution()));
+  int cell_x, cell_y;
+  costmap_->worldToMapEnforceBounds(pose.x, pose.y, cell_x, cell_y);
+
+  const int max_x = static_cast<int>(costmap_->getSizeInCellsX()) - 1;
+  const int max_y = static_cast<int>(costmap_->getSizeInCellsY()) - 1;
+  window_x0_ = std::max(0, cell_x - radius);
+  window_y0_ = std::max(0, cell_y - radius);
+  window_x1_ = std::min(max_x, cell_x + radius);
+  window_y1_ = std::min(max_y, cell_y + radius);
+  window_valid_ = true;
+}
+
+void MapGridCritic::propagateWindow()
+{
+  if (sources_.empty()) {
+    return;
+  }
+
+  auto clamp = [](unsigned int v, unsigned int lo, unsigned int hi) {
+      return std::min(std::max(v, lo), hi);
+    };
+
+  for (const auto & source : sources_) {
+    unsigned int x = clamp(source.first, window_x0_, window_x1_);
+    unsigned int y = clamp(source.second, window_y0_, window_y1_);
+    double d = CellData::absolute_difference(source.first, x) +
+      CellData::absolute_difference(source.second, y);
+    double & value = cell_values_[costmap_->getIndex(x, y)];
+    value = std::min(value, d);
+  }
+
+  // Forward pass (from the left and from above)
+  for (unsigned int y = window_y0_; y <= window_y1_; ++y) {
+    unsigned int index = costmap_->getIndex(window_x0_, y);
+    for (unsigned int x = window_x0_; x <= window_x1_; ++x, ++index) {
+      double & value = cell_values_[index];
+      if (x > window_x0_) {
+        value = std::min(value, cell_values_[index - 1] + 1.0);
+      }
+      if (y > window_y0_) {
+        value = std::min(value, cell_values_[index - costmap_->getSizeInCellsX()] + 1.0);
+      }
+    }
+  }
+
+  // Backward pass (from the right and from below)
+  for (unsigned int y = window_y1_ + 1; y-- > window_y0_; ) {
+    unsigned int index = costmap_->getIndex(window_x1_, y);
+    for (unsigned int x = window_x1_ + 1; x-- > window_x0_; --index) {
+      double & value = cell_values_[index];
+      if (x < window_x1_) {
+        value = std::min(value, cell_values_[index + 1] + 1.0);
+      }
+      if (y < window_y1_) {
+        value = std::min(value, cell_values_[index + costmap_->getSizeInCellsX()] + 1.0);
+      }
+    }
+  }
+}
+
 void MapGridCritic::propogateManhattanDistances()
 {
+  if (windowed_propagation_) {
+    if (window_valid_) {
+      propagateWindow();
+    }
+    return;
+  }
+
   while (!queue_->isEmpty()) {
     costmap_queue::CellData cell = queue_->getNextCell();
     cell_values_[cell.index_] = CellData::absolute_difference(cell.src_x_, cell.x_) +
@@ -116,43 +243,27 @@ void MapGridCritic::propogateManhattanDistances()
 
 double MapGridCritic::scoreTrajectory(const dwb_msgs::msg::Trajectory2D & traj)
 {
-  double score = 0.0;
-  unsigned int start_index = 0;
-  if (aggregationType_ == ScoreAggregationType::Product) {
-    score = 1.0;
-  } else if (aggregationType_ == ScoreAggregationType::Last && !stop_on_failure_) {
-    start_index = traj.poses.size() - 1;
-  }
-  double grid_dist;
-
-  for (unsigned int i = start_index; i < traj.poses.size(); ++i) {
-    grid_dist = scorePose(traj.poses[i]);
-    if (stop_on_failure_) {
-      if (grid_dist == obstacle_score_) {
-        throw dwb_core::
-              IllegalTrajectoryException(name_, "Trajectory Hits Obstacle.");
-      } else if (grid_dist == unreachable_score_) {
-        throw dwb_core::
-              IllegalTrajectoryException(name_, "Trajectory Hits Unreachable Area.");
-      }
-    }
+  return aggregateScores(
+    traj.poses.size(), [&](size_t i) -> const geometry_msgs::msg::Pose2D & {
+      return traj.poses[i];
+    });
+}
 
-    switch (aggregationType_) {
-      case ScoreAggregationType::Last:
-        score = grid_dist;
-        break;
-      case ScoreAggregationType::Sum:
-        score += grid_dist;
-        break;
-      case ScoreAggregationType::Product:
-        if (score > 0) {
-          score *= grid_dist;
-        }
-        break;
+void MapGridCritic::scoreTrajectories(
+  const dwb_core::TrajectoryBatch & batch, const std::vector<uint8_t> & active,
+  size_t begin, size_t end, dwb_core::BatchScores & scores)
+{
+  for (size_t i = begin; i < end; ++i) {
+    if (!active[i]) {
+      continue;
+    }
+    try {
+      scores.raw[i] = aggregateScores(
+        batch.numPoses(i), [&](size_t j) {return batch.getPose(i, j);});
+    } catch (const dwb_core::IllegalTrajectoryException & e) {
+      scores.illegal[i] = std::make_shared<dwb_core::IllegalTrajectoryException>(e);
     }
   }
-
-  return score;
 }
 
 double MapGridCritic::scorePose(const geometry_msgs::msg::Pose2D & pose)
@@ -186,4 +297,14 @@ void MapGridCritic::addCriticVisualization(
   cost_channels.push_back(grid_scores);
 }
 
+dwb_core::TrajectoryCritic::VisualizationSnapshot MapGridCritic::snapshotCriticVisualization()
+{
+  // Same channel as addCriticVisualization, cell_values_ is indexed like the costmap
+  auto values = std::make_shared<std::vector<double>>(cell_values_);
+  std::string name = name_;
+  return [name, values](CostChannels & cost_channels) {
+           cost_channels.emplace_back(name, std::vector<float>(values->begin(), values->end()));
+         };
+}
+
 }  // namespace dwb_critics
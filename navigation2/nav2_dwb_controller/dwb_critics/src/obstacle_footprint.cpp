@@ -34,6 +34,7 @@
 
 #include "dwb_critics/obstacle_footprint.hpp"
 #include <algorithm>
+#include <memory>
 #include <vector>
 #include "dwb_critics/line_iterator.hpp"
 #include "dwb_core/exceptions.hpp"
@@ -74,6 +75,28 @@ bool ObstacleFootprintCritic::prepare(
   return true;
 }
 
+void ObstacleFootprintCritic::scoreTrajectories(
+  const dwb_core::TrajectoryBatch & batch, const std::vector<uint8_t> & active,
+  size_t begin, size_t end, dwb_core::BatchScores & scores)
+{
+  // The center-cell lookup of BaseObstacleCritic does not apply to footprints
+  for (size_t i = begin; i < end; ++i) {
+    if (!active[i]) {
+      continue;
+    }
+    try {
+      double score = 0.0;
+      for (size_t j = 0; j < batch.numPoses(i); ++j) {
+        double pose_score = scorePose(batch.getPose(i, j));
+        score = static_cast<double>(sum_scores_) * score + pose_score;
+      }
+      scores.raw[i] = score;
+    } catch (const dwb_core::IllegalTrajectoryException & e) {
+      scores.illegal[i] = std::make_shared<dwb_core::IllegalTrajectoryException>(e);
+    }
+  }
+}
+
 double ObstacleFootprintCritic::scorePose(const geometry_msgs::msg::Pose2D & pose)
 {
   unsigned int cell_x, cell_y;
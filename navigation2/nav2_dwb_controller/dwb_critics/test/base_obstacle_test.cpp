@@ -155,6 +155,15 @@ TEST(BaseObstacle, CriticVisualization)
       ASSERT_EQ(static_cast<int>(pointValue), costmap_ros->getCostmap()->getCost(x, y));
     }
   }
+
+  // The snapshot keeps the costs of the time it was taken
+  auto snapshot = critic->snapshotCriticVisualization();
+  costmap_ros->getCostmap()->setCost(3, 2, 0);
+  std::vector<std::pair<std::string, std::vector<float>>> snapshot_channels;
+  snapshot(snapshot_channels);
+  ASSERT_EQ(snapshot_channels.size(), 1u);
+  EXPECT_EQ(snapshot_channels[0].first, cost_channels[0].first);
+  EXPECT_EQ(snapshot_channels[0].second, cost_channels[0].second);
 }
 
 int main(int argc, char ** argv)
@@ -0,0 +1,93 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "rclcpp/rclcpp.hpp"
+#include "dwb_critics/path_dist.hpp"
+#include "dwb_critics/goal_dist.hpp"
+
+template<typename CriticT>
+void compareWindowedPropagation(const std::string & node_name)
+{
+  auto node = nav2_util::LifecycleNode::make_shared(node_name);
+  node->declare_parameter("ns.windowed.windowed_propagation", rclcpp::ParameterValue(true));
+  node->declare_parameter("ns.windowed.window_padding", rclcpp::ParameterValue(1.0));
+
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>("test_global_costmap");
+  costmap_ros->configure();
+  nav2_costmap_2d::Costmap2D * costmap = costmap_ros->getCostmap();
+
+  auto full = std::make_shared<CriticT>();
+  auto windowed = std::make_shared<CriticT>();
+  full->initialize(node, "full", "ns", costmap_ros);
+  windowed->initialize(node, "windowed", "ns", costmap_ros);
+
+  // A diagonal plan that leaves the window around the robot on both ends
+  nav_2d_msgs::msg::Path2D plan;
+  for (int i = 0; i < 40; ++i) {
+    geometry_msgs::msg::Pose2D pose;
+    pose.x = 0.5 + i * 0.1;
+    pose.y = 0.3 + i * 0.08;
+    plan.poses.push_back(pose);
+  }
+
+  geometry_msgs::msg::Pose2D robot;
+  nav_2d_msgs::msg::Twist2D vel;
+  for (double offset : {1.0, 2.0, 2.5}) {
+    robot.x = offset;
+    robot.y = offset - 0.4;
+    ASSERT_TRUE(full->prepare(robot, vel, plan.poses.back(), plan));
+    ASSERT_TRUE(windowed->prepare(robot, vel, plan.poses.back(), plan));
+
+    // Every cell within the padding of the robot must match the full propagation
+    unsigned int rx, ry;
+    ASSERT_TRUE(costmap->worldToMap(robot.x, robot.y, rx, ry));
+    int radius = static_cast<int>(1.0 / costmap->getResolution());
+    for (int dy = -radius; dy <= radius; ++dy) {
+      for (int dx = -radius; dx <= radius; ++dx) {
+        int x = static_cast<int>(rx) + dx;
+        int y = static_cast<int>(ry) + dy;
+        if (x < 0 || y < 0 || x >= static_cast<int>(costmap->getSizeInCellsX()) ||
+          y >= static_cast<int>(costmap->getSizeInCellsY()))
+        {
+          continue;
+        }
+        ASSERT_DOUBLE_EQ(windowed->getScore(x, y), full->getScore(x, y)) <<
+          "cell " << x << ", " << y;
+      }
+    }
+  }
+}
+
+TEST(MapGrid, WindowedPathDistMatchesFull)
+{
+  compareWindowedPropagation<dwb_critics::PathDistCritic>("windowed_path_dist_tester");
+}
+
+TEST(MapGrid, WindowedGoalDistMatchesFull)
+{
+  compareWindowedPropagation<dwb_critics::GoalDistCritic>("windowed_goal_dist_tester");
+}
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  int ret = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return ret;
+}
@@ -176,6 +176,34 @@ dwb_msgs::msg::Trajectory2D StandardTrajectoryGenerator::generateTrajectory(
   return traj;
 }
 
+void StandardTrajectoryGenerator::generateTrajectory(
+  const geometry_msgs::msg::Pose2D & start_pose,
+  const nav_2d_msgs::msg::Twist2D & start_vel,
+  const nav_2d_msgs::msg::Twist2D & cmd_vel,
+  dwb_core::TrajectoryBatch & batch)
+{
+  // Same simulation as above, written straight into the batch arrays
+  batch.beginTrajectory(cmd_vel);
+  geometry_msgs::msg::Pose2D pose = start_pose;
+  nav_2d_msgs::msg::Twist2D vel = start_vel;
+  double running_time = 0.0;
+  std::vector<double> steps = getTimeSteps(cmd_vel);
+  batch.addPose(start_pose.x, start_pose.y, start_pose.theta);
+  for (double dt : steps) {
+    vel = computeNewVelocity(cmd_vel, vel, dt);
+    pose = computeNewPosition(pose, vel, dt);
+
+    batch.addPose(pose.x, pose.y, pose.theta);
+    batch.addTimeOffset(running_time);
+    running_time += dt;
+  }
+
+  if (include_last_point_) {
+    batch.addPose(pose.x, pose.y, pose.theta);
+    batch.addTimeOffset(running_time);
+  }
+}
+
 /**
  * change vel using acceleration limits to converge towards sample_target-vel
  */
@@ -492,6 +492,40 @@ TEST(TrajectoryGenerator, dwa)
   matchPose(res.poses[5], 1.5, 0, 0);
 }
 
+TEST(TrajectoryGenerator, batch_matches_message)
+{
+  auto nh = makeTestNode(
+    "batch_matches_message", {rclcpp::Parameter("dwb.linear_granularity", 0.5)});
+  StandardTrajectoryGenerator gen;
+  gen.initialize(nh, "dwb");
+
+  nav_2d_msgs::msg::Twist2D cmd;
+  cmd.x = 0.2;
+  cmd.theta = 0.5;
+  dwb_core::TrajectoryBatch batch;
+  gen.generateTrajectory(origin, forward, forward, batch);
+  gen.generateTrajectory(origin, zero, cmd, batch);
+  ASSERT_EQ(batch.size(), 2u);
+
+  dwb_msgs::msg::Trajectory2D from_batch;
+  for (size_t i = 0; i < batch.size(); ++i) {
+    dwb_msgs::msg::Trajectory2D res = i == 0 ?
+      gen.generateTrajectory(origin, forward, forward) :
+      gen.generateTrajectory(origin, zero, cmd);
+    batch.getTrajectory(i, from_batch);
+    matchTwist(from_batch.velocity, res.velocity);
+    ASSERT_EQ(batch.numPoses(i), res.poses.size());
+    ASSERT_EQ(from_batch.time_offsets.size(), res.time_offsets.size());
+    for (size_t j = 0; j < res.poses.size(); ++j) {
+      matchPose(from_batch.poses[j], res.poses[j]);
+    }
+    for (size_t j = 0; j < res.time_offsets.size(); ++j) {
+      EXPECT_DOUBLE_EQ(
+        durationToSec(from_batch.time_offsets[j]), durationToSec(res.time_offsets[j]));
+    }
+  }
+}
+
 int main(int argc, char ** argv)
 {
   forward.x = 0.3;
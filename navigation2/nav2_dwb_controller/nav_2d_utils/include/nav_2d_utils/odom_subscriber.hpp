@@ -36,6 +36,7 @@
 #define NAV_2D_UTILS__ODOM_SUBSCRIBER_HPP_
 
 #include <cmath>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -80,20 +81,37 @@ public:
   inline nav_2d_msgs::msg::Twist2D getTwist() {return odom_vel_.velocity;}
   inline nav_2d_msgs::msg::Twist2DStamped getTwistStamped() {return odom_vel_;}
 
+  /**
+   * @brief Set a function to be called after each odometry message has been stored
+   */
+  void setOdomCallback(std::function<void()> callback)
+  {
+    std::lock_guard<std::mutex> lock(odom_mutex_);
+    odom_callback_ = std::move(callback);
+  }
+
 protected:
   void odomCallback(const nav_msgs::msg::Odometry::SharedPtr msg)
   {
     // ROS_INFO_ONCE("odom received!");
-    std::lock_guard<std::mutex> lock(odom_mutex_);
-    odom_vel_.header = msg->header;
-    odom_vel_.velocity.x = msg->twist.twist.linear.x;
-    odom_vel_.velocity.y = msg->twist.twist.linear.y;
-    odom_vel_.velocity.theta = msg->twist.twist.angular.z;
+    std::function<void()> callback;
+    {
+      std::lock_guard<std::mutex> lock(odom_mutex_);
+      odom_vel_.header = msg->header;
+      odom_vel_.velocity.x = msg->twist.twist.linear.x;
+      odom_vel_.velocity.y = msg->twist.twist.linear.y;
+      odom_vel_.velocity.theta = msg->twist.twist.angular.z;
+      callback = odom_callback_;
+    }
+    if (callback) {
+      callback();
+    }
   }
 
   rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr odom_sub_;
   nav_2d_msgs::msg::Twist2DStamped odom_vel_;
   std::mutex odom_mutex_;
+  std::function<void()> odom_callback_;
 };
 
 }  // namespace nav_2d_utils
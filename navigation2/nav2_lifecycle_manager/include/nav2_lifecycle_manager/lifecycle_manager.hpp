@@ -137,6 +137,23 @@ protected:
    */
   bool createBondConnection(const std::string & node_name);
 
+  /**
+   * @brief Create the bond connections of several nodes, waiting for all of
+   * them to form at the same time rather than one after the other
+   */
+  bool createBondConnections(const std::vector<std::string> & node_names);
+
+  /**
+   * @brief Start a bond with a node if there is none yet
+   * @return true if a new bond was started
+   */
+  bool startBond(const std::string & node_name);
+
+  /**
+   * @brief Wait for a started bond to form
+   */
+  bool waitForBond(const std::string & node_name);
+
   // Support function for killing bond connections
   /**
    * @brief Support function for killing bond connections
@@ -157,11 +174,32 @@ protected:
     const std::string & node_name,
     std::uint8_t transition);
 
+  /**
+   * @brief For a node, call the transition and check the resulting state,
+   * without touching the bonds. Safe to call for different nodes concurrently.
+   */
+  bool transitionNode(
+    const std::string & node_name,
+    std::uint8_t transition);
+
   /**
    * @brief For each node in the map, transition to the new target state
    */
   bool changeStateForAllNodes(std::uint8_t transition);
 
+  /**
+   * @brief Transition all the nodes concurrently. A node is transitioned as
+   * soon as the nodes it depends on are done when going up (configure,
+   * activate), or the nodes depending on it when going down.
+   */
+  bool changeStateForAllNodesParallel(std::uint8_t transition);
+
+  /**
+   * @brief Parse the node_dependencies parameter into node_dependencies_
+   * @return false if it names unknown nodes or contains a cycle
+   */
+  bool loadNodeDependencies(const std::vector<std::string> & entries);
+
   // Convenience function to highlight the output on the console
   /**
    * @brief Helper function to highlight the output on the console
@@ -190,6 +228,12 @@ protected:
   // Whether to automatically start up the system
   bool autostart_;
 
+  // Whether to transition independent nodes at the same time
+  bool parallel_bringup_;
+
+  // The managed nodes each managed node depends on, used by parallel bring-up
+  std::map<std::string, std::vector<std::string>> node_dependencies_;
+
   bool system_active_{false};
 };
 
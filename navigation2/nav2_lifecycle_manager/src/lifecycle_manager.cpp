@@ -15,7 +15,10 @@
 #include "nav2_lifecycle_manager/lifecycle_manager.hpp"
 
 #include <chrono>
+#include <functional>
+#include <future>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -41,9 +44,19 @@ LifecycleManager::LifecycleManager()
   declare_parameter("node_names", rclcpp::PARAMETER_STRING_ARRAY);
   declare_parameter("autostart", rclcpp::ParameterValue(false));
   declare_parameter("bond_timeout", 4.0);
+  declare_parameter("parallel_bringup", false);
+  declare_parameter("node_dependencies", std::vector<std::string>());
 
   node_names_ = get_parameter("node_names").as_string_array();
   get_parameter("autostart", autostart_);
+  get_parameter("parallel_bringup", parallel_bringup_);
+  if (parallel_bringup_ &&
+    !loadNodeDependencies(get_parameter("node_dependencies").as_string_array()))
+  {
+    RCLCPP_ERROR(get_logger(), "Invalid node_dependencies, falling back to sequential bring-up");
+    node_dependencies_.clear();
+    parallel_bringup_ = false;
+  }
   double bond_timeout_s;
   get_parameter("bond_timeout", bond_timeout_s);
   bond_timeout_ = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -157,45 +170,91 @@ LifecycleManager::destroyLifecycleServiceClients()
 
 bool
 LifecycleManager::createBondConnection(const std::string & node_name)
+{
+  if (startBond(node_name)) {
+    return waitForBond(node_name);
+  }
+  return true;
+}
+
+bool
+LifecycleManager::createBondConnections(const std::vector<std::string> & node_names)
+{
+  std::vector<std::string> started;
+  for (auto & node_name : node_names) {
+    if (startBond(node_name)) {
+      started.push_back(node_name);
+    }
+  }
+
+  // The bonds form in the background, so the waits overlap
+  bool success = true;
+  for (auto & node_name : started) {
+    success = waitForBond(node_name) && success;
+  }
+  return success;
+}
+
+bool
+LifecycleManager::startBond(const std::string & node_name)
+{
+  if (bond_map_.find(node_name) != bond_map_.end() || bond_timeout_.count() <= 0) {
+    return false;
+  }
+
+  const double timeout_s =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(bond_timeout_).count() / 1e9;
+  bond_map_[node_name] =
+    std::make_shared<bond::Bond>("bond", node_name, shared_from_this());
+  bond_map_[node_name]->setHeartbeatTimeout(timeout_s);
+  bond_map_[node_name]->setHeartbeatPeriod(0.10);
+  bond_map_[node_name]->start();
+  return true;
+}
+
+bool
+LifecycleManager::waitForBond(const std::string & node_name)
 {
   const double timeout_ns =
     std::chrono::duration_cast<std::chrono::nanoseconds>(bond_timeout_).count();
   const double timeout_s = timeout_ns / 1e9;
 
-  if (bond_map_.find(node_name) == bond_map_.end() && bond_timeout_.count() > 0.0) {
-    bond_map_[node_name] =
-      std::make_shared<bond::Bond>("bond", node_name, shared_from_this());
-    bond_map_[node_name]->setHeartbeatTimeout(timeout_s);
-    bond_map_[node_name]->setHeartbeatPeriod(0.10);
-    bond_map_[node_name]->start();
-    if (
-      !bond_map_[node_name]->waitUntilFormed(
-        rclcpp::Duration(rclcpp::Duration::from_nanoseconds(timeout_ns / 2))))
-    {
-      RCLCPP_ERROR(
-        get_logger(),
-        "Server %s was unable to be reached after %0.2fs by bond. "
-        "This server may be misconfigured.",
-        node_name.c_str(), timeout_s);
-      return false;
-    }
-    RCLCPP_INFO(get_logger(), "Server %s connected with bond.", node_name.c_str());
+  if (
+    !bond_map_[node_name]->waitUntilFormed(
+      rclcpp::Duration(rclcpp::Duration::from_nanoseconds(timeout_ns / 2))))
+  {
+    RCLCPP_ERROR(
+      get_logger(),
+      "Server %s was unable to be reached after %0.2fs by bond. "
+      "This server may be misconfigured.",
+      node_name.c_str(), timeout_s);
+    return false;
   }
-
+  RCLCPP_INFO(get_logger(), "Server %s connected with bond.", node_name.c_str());
   return true;
 }
 
 bool
-LifecycleManager::changeStateForNode(const std::string & node_name, std::uint8_t transition)
+LifecycleManager::transitionNode(const std::string & node_name, std::uint8_t transition)
 {
-  message(transition_label_map_[transition] + node_name);
+  message(transition_label_map_.at(transition) + node_name);
 
-  if (!node_map_[node_name]->change_state(transition) ||
-    !(node_map_[node_name]->get_state() == transition_state_map_[transition]))
+  auto & client = node_map_.at(node_name);
+  if (!client->change_state(transition) ||
+    !(client->get_state() == transition_state_map_.at(transition)))
   {
     RCLCPP_ERROR(get_logger(), "Failed to change state for node: %s", node_name.c_str());
     return false;
   }
+  return true;
+}
+
+bool
+LifecycleManager::changeStateForNode(const std::string & node_name, std::uint8_t transition)
+{
+  if (!transitionNode(node_name, transition)) {
+    return false;
+  }
 
   if (transition == Transition::TRANSITION_ACTIVATE) {
     return createBondConnection(node_name);
@@ -209,6 +268,10 @@ LifecycleManager::changeStateForNode(const std::string & node_name, std::uint8_t
 bool
 LifecycleManager::changeStateForAllNodes(std::uint8_t transition)
 {
+  if (parallel_bringup_) {
+    return changeStateForAllNodesParallel(transition);
+  }
+
   if (transition == Transition::TRANSITION_CONFIGURE ||
     transition == Transition::TRANSITION_ACTIVATE)
   {
@@ -228,6 +291,156 @@ LifecycleManager::changeStateForAllNodes(std::uint8_t transition)
   return true;
 }
 
+bool
+LifecycleManager::changeStateForAllNodesParallel(std::uint8_t transition)
+{
+  const bool going_up = transition == Transition::TRANSITION_CONFIGURE ||
+    transition == Transition::TRANSITION_ACTIVATE;
+
+  // The nodes that have to finish this transition before each node starts it
+  std::map<std::string, std::vector<std::string>> prerequisites;
+  for (auto & node_name : node_names_) {
+    prerequisites[node_name];
+  }
+  for (auto & kv : node_dependencies_) {
+    for (auto & dependency : kv.second) {
+      if (going_up) {
+        prerequisites[kv.first].push_back(dependency);
+      } else {
+        prerequisites[dependency].push_back(kv.first);
+      }
+    }
+  }
+
+  std::map<std::string, std::promise<bool>> promises;
+  std::map<std::string, std::shared_future<bool>> results;
+  for (auto & node_name : node_names_) {
+    results[node_name] = promises[node_name].get_future().share();
+  }
+
+  // One task per node, each waiting on its prerequisites. The dependency
+  // graph is acyclic (see loadNodeDependencies), so every task finishes.
+  std::vector<std::future<void>> tasks;
+  for (auto & node_name : node_names_) {
+    tasks.push_back(
+      std::async(
+        std::launch::async, [&, node_name]() {
+          for (auto & prerequisite : prerequisites.at(node_name)) {
+            if (!results.at(prerequisite).get()) {
+              RCLCPP_ERROR(
+                get_logger(), "Skipping %s since %s failed to transition",
+                node_name.c_str(), prerequisite.c_str());
+              promises.at(node_name).set_value(false);
+              return;
+            }
+          }
+          bool success = false;
+          try {
+            success = transitionNode(node_name, transition);
+          } catch (const std::exception & ex) {
+            RCLCPP_ERROR(
+              get_logger(), "Failed to change state for node %s: %s",
+              node_name.c_str(), ex.what());
+          }
+          promises.at(node_name).set_value(success);
+        }));
+  }
+  for (auto & task : tasks) {
+    task.get();
+  }
+
+  bool success = true;
+  std::vector<std::string> transitioned;
+  for (auto & node_name : node_names_) {
+    if (results.at(node_name).get()) {
+      transitioned.push_back(node_name);
+    } else {
+      success = false;
+    }
+  }
+
+  if (transition == Transition::TRANSITION_ACTIVATE) {
+    success = createBondConnections(transitioned) && success;
+  } else if (transition == Transition::TRANSITION_DEACTIVATE) {
+    for (auto & node_name : transitioned) {
+      bond_map_.erase(node_name);
+    }
+  }
+
+  return success;
+}
+
+bool
+LifecycleManager::loadNodeDependencies(const std::vector<std::string> & entries)
+{
+  // Each entry reads "node: dependency, dependency, ..."
+  const std::set<std::string> known(node_names_.begin(), node_names_.end());
+  auto trim = [](const std::string & str) {
+      const auto begin = str.find_first_not_of(" \t");
+      if (begin == std::string::npos) {
+        return std::string();
+      }
+      return str.substr(begin, str.find_last_not_of(" \t") - begin + 1);
+    };
+
+  for (auto & entry : entries) {
+    const auto colon = entry.find(':');
+    const std::string node_name = trim(entry.substr(0, colon));
+    if (colon == std::string::npos || known.count(node_name) == 0) {
+      RCLCPP_ERROR(get_logger(), "Bad node_dependencies entry \"%s\"", entry.c_str());
+      return false;
+    }
+    std::string list = entry.substr(colon + 1);
+    size_t begin = 0;
+    while (begin <= list.size()) {
+      size_t end = list.find(',', begin);
+      if (end == std::string::npos) {
+        end = list.size();
+      }
+      const std::string dependency = trim(list.substr(begin, end - begin));
+      if (!dependency.empty()) {
+        if (known.count(dependency) == 0) {
+          RCLCPP_ERROR(
+            get_logger(), "%s depends on %s, which is not a managed node",
+            node_name.c_str(), dependency.c_str());
+          return false;
+        }
+        node_dependencies_[node_name].push_back(dependency);
+      }
+      begin = end + 1;
+    }
+  }
+
+  // Reject cycles, which would deadlock the bring-up
+  std::map<std::string, int> mark;  // 0 unvisited, 1 in progress, 2 done
+  std::function<bool(const std::string &)> visit = [&](const std::string & node_name) {
+      if (mark[node_name] == 1) {
+        RCLCPP_ERROR(get_logger(), "node_dependencies has a cycle through %s", node_name.c_str());
+        return false;
+      }
+      if (mark[node_name] == 2) {
+        return true;
+      }
+      mark[node_name] = 1;
+      auto it = node_dependencies_.find(node_name);
+      if (it != node_dependencies_.end()) {
+        for (auto & dependency : it->second) {
+          if (!visit(dependency)) {
+            return false;
+          }
+        }
+      }
+      mark[node_name] = 2;
+      return true;
+    };
+  for (auto & node_name : node_names_) {
+    if (!visit(node_name)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void
 LifecycleManager::shutdownAllNodes()
 {
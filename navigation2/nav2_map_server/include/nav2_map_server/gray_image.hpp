@@ -0,0 +1,86 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_MAP_SERVER__GRAY_IMAGE_HPP_
+#define NAV2_MAP_SERVER__GRAY_IMAGE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nav2_map_server
+{
+
+/**
+ * @class nav2_map_server::GrayImage
+ * @brief Read-only access to the pixels of an 8 bit grayscale image file
+ *
+ * The file is memory mapped. Binary PGM (P5) pixels are read in place from
+ * the mapping, 8 bit grayscale PNG files are decoded from it into a buffer.
+ * Any other format, or a file that cannot be parsed, makes open() return
+ * false so that the caller can fall back to GraphicsMagick.
+ */
+class GrayImage
+{
+public:
+  GrayImage() = default;
+  ~GrayImage();
+
+  GrayImage(const GrayImage &) = delete;
+  GrayImage & operator=(const GrayImage &) = delete;
+
+  /**
+   * @brief Open an image file
+   * @param file_name Path of the image
+   * @return true if the file is a supported 8 bit grayscale image
+   */
+  bool open(const std::string & file_name);
+
+  /**
+   * @brief Width of the image in pixels
+   */
+  unsigned int width() const {return width_;}
+
+  /**
+   * @brief Height of the image in pixels
+   */
+  unsigned int height() const {return height_;}
+
+  /**
+   * @brief Pixels of row y, counted from the top of the image
+   */
+  const uint8_t * row(unsigned int y) const {return pixels_ + y * stride_;}
+
+protected:
+  bool openPgm();
+  bool openPng();
+  void close();
+
+  // The memory mapped file
+  const uint8_t * data_{nullptr};
+  size_t size_{0};
+
+  // Decoded pixels, for formats that cannot be read in place
+  std::vector<uint8_t> buffer_;
+
+  const uint8_t * pixels_{nullptr};
+  size_t stride_{0};
+  unsigned int width_{0};
+  unsigned int height_{0};
+};
+
+}  // namespace nav2_map_server
+
+#endif  // NAV2_MAP_SERVER__GRAY_IMAGE_HPP_
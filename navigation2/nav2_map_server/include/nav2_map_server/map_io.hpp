@@ -31,6 +31,8 @@ namespace nav2_map_server
 struct LoadParameters
 {
   std::string image_file_name;
+  // Optional tiled copy of the map, see tiled_map.hpp
+  std::string tiles_file_name;
   double resolution{0};
   std::vector<double> origin{0, 0, 0};
   double free_thresh;
@@ -59,9 +61,24 @@ LoadParameters loadMapYaml(const std::string & yaml_filename);
  * @brief Load the image from map file and generate an OccupancyGrid
  * @param load_parameters Parameters of loading map
  * @param map Output loaded map
+ * @param fast_path Whether 8 bit grayscale PGM and PNG images may be read
+ * through loadMapFromGrayImage() instead of GraphicsMagick
  * @throw std::exception
  */
 void loadMapFromFile(
+  const LoadParameters & load_parameters,
+  nav_msgs::msg::OccupancyGrid & map,
+  bool fast_path = true);
+
+/**
+ * @brief Fill the size and data of an OccupancyGrid from a binary PGM or
+ * 8 bit grayscale PNG image, without going through GraphicsMagick
+ * @param load_parameters Parameters of loading map
+ * @param map Output map, only the info size and data are set
+ * @return false if the image is in another format, map is then untouched
+ * @throw std::exception
+ */
+bool loadMapFromGrayImage(
   const LoadParameters & load_parameters,
   nav_msgs::msg::OccupancyGrid & map);
 
@@ -86,6 +103,8 @@ struct SaveParameters
   double free_thresh{0.0};
   double occupied_thresh{0.0};
   MapMode mode{MapMode::Trinary};
+  // If not 0, also write the map as a tiled map file with tiles of this side in cells
+  unsigned int tile_size{0};
 };
 
 /**
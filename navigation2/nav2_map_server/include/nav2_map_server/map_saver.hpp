@@ -105,6 +105,8 @@ protected:
   double occupied_thresh_default_;
   // param for handling QoS configuration
   bool map_subscribe_transient_local_;
+  // Side in cells of the tiles of the tiled map written next to the image, 0 for none
+  int tile_size_;
 
   // The name of the service for saving a map from topic
   const std::string save_map_service_name_{"save_map"};
@@ -18,12 +18,18 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_util/lifecycle_node.hpp"
+#include "map_msgs/msg/occupancy_grid_update.hpp"
 #include "nav_msgs/msg/occupancy_grid.hpp"
+#include "nav_msgs/msg/path.hpp"
 #include "nav_msgs/srv/get_map.hpp"
 #include "nav2_msgs/srv/load_map.hpp"
+#include "nav2_map_server/tiled_map.hpp"
+#include "tf2_ros/buffer.h"
+#include "tf2_ros/transform_listener.h"
 
 namespace nav2_map_server
 {
@@ -95,6 +101,43 @@ protected:
    */
   void updateMsgHeader();
 
+  /**
+   * @brief Open the tiled map of a map YAML file instead of loading its image.
+   * msg_ spans the whole map, with the tiles around the robot, or around the
+   * map frame origin if its pose is not known yet, read into it.
+   * @param yaml_file name of input YAML file
+   * @param response Output response with the loaded part of the map
+   * @return false if the YAML file has no tiled map or loading failed
+   */
+  bool loadTiledMapFromYaml(
+    const std::string & yaml_file,
+    std::shared_ptr<nav2_msgs::srv::LoadMap::Response> response);
+
+  /**
+   * @brief Read the tiles around the robot and along the last plan into msg_.
+   * Tiles stay in msg_ once read, so the map size and origin never change.
+   * @param robot_known Whether the robot position is known. The tiles along
+   * the plan are read either way.
+   * @param x Robot position in the map frame
+   * @param y Robot position in the map frame
+   * @param update Output update with the cells of the tiles read, if any
+   * @return true if tiles were read
+   */
+  bool updateTileWindow(
+    bool robot_known, double x, double y,
+    map_msgs::msg::OccupancyGridUpdate & update);
+
+  /**
+   * @brief Get the robot position in the map frame
+   * @return false if the transform is not available
+   */
+  bool getRobotPosition(double & x, double & y);
+
+  /**
+   * @brief Timer callback moving the published tiles with the robot
+   */
+  void tileTimerCallback();
+
   /**
    * @brief Map getting service callback
    * @param request_header Service request header
@@ -137,6 +180,27 @@ protected:
 
   // The message to publish on the occupancy grid topic
   nav_msgs::msg::OccupancyGrid msg_;
+
+  // Tiled map mode: the map is published with its full size, and tiles are
+  // read into it once the robot or the last plan comes within half a window
+  // or a margin of them. Tiles read later are published as map updates.
+  // This shortens loading only: tiles are never dropped from msg_, which has
+  // the size of the whole map, and the costmaps allocate the whole map too.
+  double tile_window_size_;
+  double tile_plan_margin_;
+  double tile_update_period_;
+  std::string robot_base_frame_;
+  std::unique_ptr<TiledMap> tiled_map_;
+  // Tiles read into msg_, by rows of tiles
+  std::vector<bool> loaded_tiles_;
+  rclcpp_lifecycle::LifecyclePublisher<map_msgs::msg::OccupancyGridUpdate>::SharedPtr update_pub_;
+  // Subscribers of occ_pub_ when the map was last published whole
+  size_t map_subscribers_{0};
+  nav_msgs::msg::Path::SharedPtr plan_;
+  rclcpp::Subscription<nav_msgs::msg::Path>::SharedPtr plan_sub_;
+  rclcpp::TimerBase::SharedPtr tile_timer_;
+  std::shared_ptr<tf2_ros::Buffer> tf_buffer_;
+  std::shared_ptr<tf2_ros::TransformListener> tf_listener_;
 };
 
 }  // namespace nav2_map_server
@@ -0,0 +1,163 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Tiled occupancy map file */
+
+#ifndef NAV2_MAP_SERVER__TILED_MAP_HPP_
+#define NAV2_MAP_SERVER__TILED_MAP_HPP_
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "nav_msgs/msg/occupancy_grid.hpp"
+
+namespace nav2_map_server
+{
+
+/*
+ * A tiled map file holds the occupancy values of a map cut into square
+ * tiles, each compressed with zlib, so that a part of a large map can be
+ * read without decoding the whole image. All integers are little-endian:
+ *
+ *   char[8]  magic "NAV2TILE"
+ *   uint32   format version
+ *   uint32   width, height    map size in cells
+ *   uint32   tile_size        tile side in cells
+ *   tiles_x * tiles_y times, by rows of tiles starting at the map origin:
+ *     uint64 offset           of the compressed tile in the file
+ *     uint32 size             of the compressed tile
+ *   compressed tiles
+ *
+ * A tile holds the int8 occupancy values of its cells in OccupancyGrid
+ * order. Tiles on the last row and column are cut to the map size. The
+ * resolution and origin of the map are kept in the map YAML file.
+ */
+
+/**
+ * @brief Write the occupancy values of a map to a tiled map file
+ * @param map Map to write
+ * @param file_name Output file
+ * @param tile_size Tile side in cells
+ * @throw std::runtime_error
+ */
+void saveTiledMap(
+  const nav_msgs::msg::OccupancyGrid & map,
+  const std::string & file_name,
+  unsigned int tile_size);
+
+/**
+ * @class nav2_map_server::TiledMap
+ * @brief Reads regions of a tiled map file, decompressing tiles on demand
+ *
+ * Only the header and the tile index are read by open(). Decompressed tiles
+ * are kept in a small LRU cache.
+ */
+class TiledMap
+{
+public:
+  /**
+   * @brief Constructor
+   * @param cache_size Maximum number of decompressed tiles kept
+   */
+  explicit TiledMap(size_t cache_size = 64);
+
+  /**
+   * @brief Open a tiled map file and read its index
+   * @param file_name Tiled map file
+   * @throw std::runtime_error
+   */
+  void open(const std::string & file_name);
+
+  /**
+   * @brief Change the maximum number of decompressed tiles kept
+   */
+  void setCacheSize(size_t cache_size);
+
+  /**
+   * @brief Map width in cells
+   */
+  unsigned int width() const {return width_;}
+
+  /**
+   * @brief Map height in cells
+   */
+  unsigned int height() const {return height_;}
+
+  /**
+   * @brief Tile side in cells
+   */
+  unsigned int tileSize() const {return tile_size_;}
+
+  /**
+   * @brief Number of tile columns
+   */
+  unsigned int tilesX() const {return tiles_x_;}
+
+  /**
+   * @brief Number of tile rows
+   */
+  unsigned int tilesY() const {return tiles_y_;}
+
+  /**
+   * @brief Read a rectangle of cells
+   * @param x0 First column of the rectangle
+   * @param y0 First row of the rectangle
+   * @param size_x Width of the rectangle, in cells
+   * @param size_y Height of the rectangle, in cells
+   * @param data Output cells of the rectangle, in OccupancyGrid order
+   * @param use_tile If set, tiles it returns false for are not read and
+   * their cells are unknown
+   * @throw std::runtime_error
+   */
+  void readRegion(
+    unsigned int x0, unsigned int y0, unsigned int size_x, unsigned int size_y,
+    std::vector<int8_t> & data,
+    const std::function<bool(unsigned int, unsigned int)> & use_tile = nullptr);
+
+protected:
+  struct TileIndex
+  {
+    uint64_t offset;
+    uint32_t size;
+  };
+
+  /**
+   * @brief Get the cells of a tile, from the cache or the file
+   */
+  const std::vector<int8_t> & tile(unsigned int tx, unsigned int ty);
+
+  size_t cache_size_;
+  std::ifstream file_;
+  unsigned int width_{0};
+  unsigned int height_{0};
+  unsigned int tile_size_{0};
+  unsigned int tiles_x_{0};
+  unsigned int tiles_y_{0};
+  std::vector<TileIndex> index_;
+
+  // Most recently used tile first
+  std::list<std::pair<unsigned int, std::vector<int8_t>>> cache_;
+  std::unordered_map<unsigned int,
+    std::list<std::pair<unsigned int, std::vector<int8_t>>>::iterator> cache_lookup_;
+};
+
+}  // namespace nav2_map_server
+
+#endif  // NAV2_MAP_SERVER__TILED_MAP_HPP_
@@ -0,0 +1,217 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_map_server/gray_image.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <png.h>
+
+#include <cctype>
+#include <cstring>
+#include <string>
+
+namespace nav2_map_server
+{
+
+namespace
+{
+
+// Largest width or height accepted from a PGM header
+constexpr unsigned long kMaxPgmSize = 1UL << 20;
+
+struct PngSource
+{
+  const uint8_t * data;
+  size_t size;
+  size_t pos;
+};
+
+void readPngData(png_structp png, png_bytep out, png_size_t length)
+{
+  auto source = static_cast<PngSource *>(png_get_io_ptr(png));
+  if (length > source->size - source->pos) {
+    png_error(png, "Truncated PNG file");
+  }
+  std::memcpy(out, source->data + source->pos, length);
+  source->pos += length;
+}
+
+}  // namespace
+
+GrayImage::~GrayImage()
+{
+  close();
+}
+
+bool GrayImage::open(const std::string & file_name)
+{
+  close();
+#ifdef _WIN32
+  (void)file_name;
+  return false;
+#else
+  int fd = ::open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+  void * mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+  madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+  data_ = static_cast<const uint8_t *>(mapping);
+  size_ = st.st_size;
+
+  if (openPgm() || openPng()) {
+    return true;
+  }
+  close();
+  return false;
+#endif
+}
+
+bool GrayImage::openPgm()
+{
+  if (size_ < 2 || data_[0] != 'P' || data_[1] != '5') {
+    return false;
+  }
+
+  // Width, height and maximum value, separated by whitespace and comments
+  size_t pos = 2;
+  unsigned long values[3];
+  for (auto & value : values) {
+    while (pos < size_) {
+      if (std::isspace(data_[pos])) {
+        ++pos;
+      } else if (data_[pos] == '#') {
+        while (pos < size_ && data_[pos] != '\n') {
+          ++pos;
+        }
+      } else {
+        break;
+      }
+    }
+    if (pos >= size_ || !std::isdigit(data_[pos])) {
+      return false;
+    }
+    value = 0;
+    while (pos < size_ && std::isdigit(data_[pos])) {
+      value = value * 10 + (data_[pos++] - '0');
+      if (value > kMaxPgmSize) {
+        return false;
+      }
+    }
+  }
+  // A single whitespace character separates the header from the pixels
+  if (pos >= size_ || !std::isspace(data_[pos])) {
+    return false;
+  }
+  ++pos;
+
+  // GraphicsMagick rescales images with another maximum value, leave those to it
+  const unsigned long width = values[0], height = values[1], max_value = values[2];
+  if (width == 0 || height == 0 || max_value != 255 || size_ - pos < width * height) {
+    return false;
+  }
+
+  width_ = width;
+  height_ = height;
+  stride_ = width;
+  pixels_ = data_ + pos;
+  return true;
+}
+
+bool GrayImage::openPng()
+{
+  if (size_ < 8 || png_sig_cmp(data_, 0, 8) != 0) {
+    return false;
+  }
+
+  png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+  if (!png) {
+    return false;
+  }
+  png_infop info = png_create_info_struct(png);
+  if (!info) {
+    png_destroy_read_struct(&png, nullptr, nullptr);
+    return false;
+  }
+  PngSource source{data_, size_, 0};
+
+  // libpng reports errors by jumping back here
+  if (setjmp(png_jmpbuf(png))) {
+    png_destroy_read_struct(&png, &info, nullptr);
+    buffer_.clear();
+    return false;
+  }
+
+  png_set_read_fn(png, &source, readPngData);
+  png_read_info(png, info);
+
+  png_uint_32 width, height;
+  int bit_depth, color_type, interlace_type;
+  png_get_IHDR(
+    png, info, &width, &height, &bit_depth, &color_type, &interlace_type, nullptr, nullptr);
+  // Transparency is averaged into the pixels by the GraphicsMagick path
+  if (bit_depth != 8 || color_type != PNG_COLOR_TYPE_GRAY ||
+    interlace_type != PNG_INTERLACE_NONE || png_get_valid(png, info, PNG_INFO_tRNS))
+  {
+    png_destroy_read_struct(&png, &info, nullptr);
+    return false;
+  }
+
+  buffer_.resize(static_cast<size_t>(width) * height);
+  for (png_uint_32 y = 0; y < height; ++y) {
+    png_read_row(png, buffer_.data() + static_cast<size_t>(y) * width, nullptr);
+  }
+  png_read_end(png, nullptr);
+  png_destroy_read_struct(&png, &info, nullptr);
+
+  width_ = width;
+  height_ = height;
+  stride_ = width;
+  pixels_ = buffer_.data();
+  return true;
+}
+
+void GrayImage::close()
+{
+#ifndef _WIN32
+  if (data_) {
+    munmap(const_cast<uint8_t *>(data_), size_);
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  buffer_.clear();
+  buffer_.shrink_to_fit();
+  pixels_ = nullptr;
+  stride_ = 0;
+  width_ = 0;
+  height_ = 0;
+}
+
+}  // namespace nav2_map_server
@@ -30,6 +30,8 @@
  */
 
 #include "nav2_map_server/map_io.hpp"
+#include "nav2_map_server/gray_image.hpp"
+#include "nav2_map_server/tiled_map.hpp"
 
 #ifndef _WIN32
 #include <libgen.h>
@@ -39,6 +41,7 @@
 #include <vector>
 #include <fstream>
 #include <stdexcept>
+#include <utility>
 
 #include "Magick++.h"
 #include "nav2_util/geometry_utils.hpp"
@@ -120,17 +123,29 @@ LoadParameters loadMapYaml(const std::string & yaml_filename)
   YAML::Node doc = YAML::LoadFile(yaml_filename);
   LoadParameters load_parameters;
 
+  // Relative file names are relative to the YAML file
+  auto resolve_file_name = [&yaml_filename](const std::string & file_name) {
+      if (file_name[0] == '/') {
+        return file_name;
+      }
+      // dirname takes a mutable char *, so we copy into a vector
+      std::vector<char> fname_copy(yaml_filename.begin(), yaml_filename.end());
+      fname_copy.push_back('\0');
+      return std::string(dirname(fname_copy.data())) + '/' + file_name;
+    };
+
   auto image_file_name = yaml_get_value<std::string>(doc, "image");
   if (image_file_name.empty()) {
     throw YAML::Exception(doc["image"].Mark(), "The image tag was empty.");
   }
-  if (image_file_name[0] != '/') {
-    // dirname takes a mutable char *, so we copy into a vector
-    std::vector<char> fname_copy(yaml_filename.begin(), yaml_filename.end());
-    fname_copy.push_back('\0');
-    image_file_name = std::string(dirname(fname_copy.data())) + '/' + image_file_name;
+  load_parameters.image_file_name = resolve_file_name(image_file_name);
+
+  if (doc["tiles"].IsDefined()) {
+    auto tiles_file_name = yaml_get_value<std::string>(doc, "tiles");
+    if (!tiles_file_name.empty()) {
+      load_parameters.tiles_file_name = resolve_file_name(tiles_file_name);
+    }
   }
-  load_parameters.image_file_name = image_file_name;
 
   load_parameters.resolution = yaml_get_value<double>(doc, "resolution");
   load_parameters.origin = yaml_get_value<std::vector<double>>(doc, "origin");
@@ -169,96 +184,147 @@ LoadParameters loadMapYaml(const std::string & yaml_filename)
   return load_parameters;
 }
 
-void loadMapFromFile(
+/**
+ * @brief Converts the lightness of a pixel into an occupancy value
+ * @param load_parameters Parameters of loading map
+ * @param shade On a scale from 0.0 to 1.0, how bright the pixel is
+ * @param opaque Whether the pixel is fully opaque
+ * @return Map cell value
+ */
+int8_t pixelToOccupancy(const LoadParameters & load_parameters, double shade, bool opaque)
+{
+  // If negate is true, we consider blacker pixels free, and whiter
+  // pixels occupied. Otherwise, it's vice versa.
+  /// on a scale from 0.0 to 1.0, how occupied is the map cell (before thresholding)?
+  double occ = (load_parameters.negate ? shade : 1.0 - shade);
+
+  int8_t map_cell;
+  switch (load_parameters.mode) {
+    case MapMode::Trinary:
+      if (load_parameters.occupied_thresh < occ) {
+        map_cell = nav2_util::OCC_GRID_OCCUPIED;
+      } else if (occ < load_parameters.free_thresh) {
+        map_cell = nav2_util::OCC_GRID_FREE;
+      } else {
+        map_cell = nav2_util::OCC_GRID_UNKNOWN;
+      }
+      break;
+    case MapMode::Scale:
+      if (!opaque) {
+        map_cell = nav2_util::OCC_GRID_UNKNOWN;
+      } else if (load_parameters.occupied_thresh < occ) {
+        map_cell = nav2_util::OCC_GRID_OCCUPIED;
+      } else if (occ < load_parameters.free_thresh) {
+        map_cell = nav2_util::OCC_GRID_FREE;
+      } else {
+        map_cell = std::rint(
+          (occ - load_parameters.free_thresh) /
+          (load_parameters.occupied_thresh - load_parameters.free_thresh) * 100.0);
+      }
+      break;
+    case MapMode::Raw: {
+        double occ_percent = std::round(shade * 255);
+        if (nav2_util::OCC_GRID_FREE <= occ_percent &&
+          occ_percent <= nav2_util::OCC_GRID_OCCUPIED)
+        {
+          map_cell = static_cast<int8_t>(occ_percent);
+        } else {
+          map_cell = nav2_util::OCC_GRID_UNKNOWN;
+        }
+        break;
+      }
+    default:
+      throw std::runtime_error("Invalid map mode");
+  }
+  return map_cell;
+}
+
+bool loadMapFromGrayImage(
   const LoadParameters & load_parameters,
   nav_msgs::msg::OccupancyGrid & map)
 {
-  Magick::InitializeMagick(nullptr);
+  GrayImage img;
+  if (!img.open(load_parameters.image_file_name)) {
+    return false;
+  }
+
+  // All pixels are opaque and have one of 256 values, so the conversion is
+  // done once per value. The shade is computed the way GraphicsMagick would
+  // report it, which keeps the result identical to the generic path.
+  int8_t lut[256];
+  for (int value = 0; value < 256; ++value) {
+    lut[value] = pixelToOccupancy(
+      load_parameters,
+      Magick::ColorGray::scaleQuantumToDouble(ScaleCharToQuantum(value)), true);
+  }
+
+  map.info.width = img.width();
+  map.info.height = img.height();
+  map.data.resize(static_cast<size_t>(map.info.width) * map.info.height);
+
+  // Image rows go top down, map rows bottom up
+  for (size_t y = 0; y < map.info.height; y++) {
+    const uint8_t * src = img.row(y);
+    int8_t * dst = map.data.data() + map.info.width * (map.info.height - y - 1);
+    for (size_t x = 0; x < map.info.width; x++) {
+      dst[x] = lut[src[x]];
+    }
+  }
+  return true;
+}
+
+void loadMapFromFile(
+  const LoadParameters & load_parameters,
+  nav_msgs::msg::OccupancyGrid & map,
+  bool fast_path)
+{
   nav_msgs::msg::OccupancyGrid msg;
 
   std::cout << "[INFO] [map_io]: Loading image_file: " <<
     load_parameters.image_file_name << std::endl;
-  Magick::Image img(load_parameters.image_file_name);
 
-  // Copy the image data into the map structure
-  msg.info.width = img.size().width();
-  msg.info.height = img.size().height();
+  if (!fast_path || !loadMapFromGrayImage(load_parameters, msg)) {
+    Magick::InitializeMagick(nullptr);
+    Magick::Image img(load_parameters.image_file_name);
 
-  msg.info.resolution = load_parameters.resolution;
-  msg.info.origin.position.x = load_parameters.origin[0];
-  msg.info.origin.position.y = load_parameters.origin[1];
-  msg.info.origin.position.z = 0.0;
-  msg.info.origin.orientation = orientationAroundZAxis(load_parameters.origin[2]);
+    // Copy the image data into the map structure
+    msg.info.width = img.size().width();
+    msg.info.height = img.size().height();
 
-  // Allocate space to hold the data
-  msg.data.resize(msg.info.width * msg.info.height);
+    // Allocate space to hold the data
+    msg.data.resize(msg.info.width * msg.info.height);
 
-  // Copy pixel data into the map structure
-  for (size_t y = 0; y < msg.info.height; y++) {
-    for (size_t x = 0; x < msg.info.width; x++) {
-      auto pixel = img.pixelColor(x, y);
+    // Copy pixel data into the map structure
+    for (size_t y = 0; y < msg.info.height; y++) {
+      for (size_t x = 0; x < msg.info.width; x++) {
+        auto pixel = img.pixelColor(x, y);
 
-      std::vector<Magick::Quantum> channels = {pixel.redQuantum(), pixel.greenQuantum(),
-        pixel.blueQuantum()};
-      if (load_parameters.mode == MapMode::Trinary && img.matte()) {
-        // To preserve existing behavior, average in alpha with color channels in Trinary mode.
-        // CAREFUL. alpha is inverted from what you might expect. High = transparent, low = opaque
-        channels.push_back(MaxRGB - pixel.alphaQuantum());
-      }
-      double sum = 0;
-      for (auto c : channels) {
-        sum += c;
-      }
-      /// on a scale from 0.0 to 1.0 how bright is the pixel?
-      double shade = Magick::ColorGray::scaleQuantumToDouble(sum / channels.size());
-
-      // If negate is true, we consider blacker pixels free, and whiter
-      // pixels occupied. Otherwise, it's vice versa.
-      /// on a scale from 0.0 to 1.0, how occupied is the map cell (before thresholding)?
-      double occ = (load_parameters.negate ? shade : 1.0 - shade);
-
-      int8_t map_cell;
-      switch (load_parameters.mode) {
-        case MapMode::Trinary:
-          if (load_parameters.occupied_thresh < occ) {
-            map_cell = nav2_util::OCC_GRID_OCCUPIED;
-          } else if (occ < load_parameters.free_thresh) {
-            map_cell = nav2_util::OCC_GRID_FREE;
-          } else {
-            map_cell = nav2_util::OCC_GRID_UNKNOWN;
-          }
-          break;
-        case MapMode::Scale:
-          if (pixel.alphaQuantum() != OpaqueOpacity) {
-            map_cell = nav2_util::OCC_GRID_UNKNOWN;
-          } else if (load_parameters.occupied_thresh < occ) {
-            map_cell = nav2_util::OCC_GRID_OCCUPIED;
-          } else if (occ < load_parameters.free_thresh) {
-            map_cell = nav2_util::OCC_GRID_FREE;
-          } else {
-            map_cell = std::rint(
-              (occ - load_parameters.free_thresh) /
-              (load_parameters.occupied_thresh - load_parameters.free_thresh) * 100.0);
-          }
-          break;
-        case MapMode::Raw: {
-            double occ_percent = std::round(shade * 255);
-            if (nav2_util::OCC_GRID_FREE <= occ_percent &&
-              occ_percent <= nav2_util::OCC_GRID_OCCUPIED)
-            {
-              map_cell = static_cast<int8_t>(occ_percent);
-            } else {
-              map_cell = nav2_util::OCC_GRID_UNKNOWN;
-            }
-            break;
-          }
-        default:
-          throw std::runtime_error("Invalid map mode");
+        std::vector<Magick::Quantum> channels = {pixel.redQuantum(), pixel.greenQuantum(),
+          pixel.blueQuantum()};
+        if (load_parameters.mode == MapMode::Trinary && img.matte()) {
+          // To preserve existing behavior, average in alpha with color channels in Trinary mode.
+          // CAREFUL. alpha is inverted from what you might expect. High = transparent, low = opaque
+          channels.push_back(MaxRGB - pixel.alphaQuantum());
+        }
+        double sum = 0;
+        for (auto c : channels) {
+          sum += c;
+        }
+        /// on a scale from 0.0 to 1.0 how bright is the pixel?
+        double shade = Magick::ColorGray::scaleQuantumToDouble(sum / channels.size());
+
+        msg.data[msg.info.width * (msg.info.height - y - 1) + x] = pixelToOccupancy(
+          load_parameters, shade, pixel.alphaQuantum() == OpaqueOpacity);
       }
-      msg.data[msg.info.width * (msg.info.height - y - 1) + x] = map_cell;
     }
   }
 
+  msg.info.resolution = load_parameters.resolution;
+  msg.info.origin.position.x = load_parameters.origin[0];
+  msg.info.origin.position.y = load_parameters.origin[1];
+  msg.info.origin.position.z = 0.0;
+  msg.info.origin.orientation = orientationAroundZAxis(load_parameters.origin[2]);
+
   // Since loadMapFromFile() does not belong to any node, publishing in a system time.
   rclcpp::Clock clock(RCL_SYSTEM_TIME);
   msg.info.map_load_time = clock.now();
@@ -269,7 +335,7 @@ void loadMapFromFile(
     "[DEBUG] [map_io]: Read map " << load_parameters.image_file_name << ": " << msg.info.width <<
     " X " << msg.info.height << " map @ " << msg.info.resolution << " m/cell" << std::endl;
 
-  map = msg;
+  map = std::move(msg);
 }
 
 LOAD_MAP_STATUS loadMapFromYaml(
@@ -496,6 +562,24 @@ void tryWriteMapToFile(
     image.write(mapdatafile);
   }
 
+  std::string maptilesfile;
+  if (save_parameters.tile_size > 0) {
+    // Tile the map as it is loaded back from the image, so that both give
+    // the same occupancy values
+    LoadParameters load_parameters;
+    load_parameters.image_file_name = mapdatafile;
+    load_parameters.free_thresh = save_parameters.free_thresh;
+    load_parameters.occupied_thresh = save_parameters.occupied_thresh;
+    load_parameters.mode = save_parameters.mode;
+    load_parameters.negate = false;
+    nav_msgs::msg::OccupancyGrid loaded_map;
+    loadMapFromFile(load_parameters, loaded_map);
+
+    maptilesfile = save_parameters.map_file_name + ".tiles";
+    std::cout << "[INFO] [map_io]: Writing tiled map to " << maptilesfile << std::endl;
+    saveTiledMap(loaded_map, maptilesfile, save_parameters.tile_size);
+  }
+
   std::string mapmetadatafile = save_parameters.map_file_name + ".yaml";
   {
     std::ofstream yaml(mapmetadatafile);
@@ -516,6 +600,9 @@ void tryWriteMapToFile(
     e << YAML::Key << "negate" << YAML::Value << 0;
     e << YAML::Key << "occupied_thresh" << YAML::Value << save_parameters.occupied_thresh;
     e << YAML::Key << "free_thresh" << YAML::Value << save_parameters.free_thresh;
+    if (!maptilesfile.empty()) {
+      e << YAML::Key << "tiles" << YAML::Value << maptilesfile;
+    }
 
     if (!e.good()) {
       std::cout <<
@@ -13,6 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -37,6 +38,7 @@ const char * USAGE_STRING{
   "  --free <threshold_free>\n"
   "  --fmt <image_format>\n"
   "  --mode trinary(default)/scale/raw\n"
+  "  --tiles <tile_size>\n"
   "\n"
   "NOTE: --ros-args should be passed at the end of command line"};
 
@@ -47,7 +49,8 @@ typedef enum
   COMMAND_IMAGE_FORMAT,
   COMMAND_OCCUPIED_THRESH,
   COMMAND_FREE_THRESH,
-  COMMAND_MODE
+  COMMAND_MODE,
+  COMMAND_TILE_SIZE
 } COMMAND_TYPE;
 
 struct cmd_struct
@@ -77,6 +80,7 @@ ARGUMENTS_STATUS parse_arguments(
     {"--free", COMMAND_FREE_THRESH},
     {"--mode", COMMAND_MODE},
     {"--fmt", COMMAND_IMAGE_FORMAT},
+    {"--tiles", COMMAND_TILE_SIZE},
   };
 
   std::vector<std::string> arguments(argv + 1, argv + argc);
@@ -116,6 +120,9 @@ ARGUMENTS_STATUS parse_arguments(
           case COMMAND_IMAGE_FORMAT:
             save_parameters.image_format = *it;
             break;
+          case COMMAND_TILE_SIZE:
+            save_parameters.tile_size = std::max(atoi(it->c_str()), 0);
+            break;
           case COMMAND_MODE:
             try {
               save_parameters.mode = map_mode_from_string(*it);
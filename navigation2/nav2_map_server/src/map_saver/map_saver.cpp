@@ -52,6 +52,7 @@ MapSaver::MapSaver()
   free_thresh_default_ = declare_parameter("free_thresh_default", 0.25),
   occupied_thresh_default_ = declare_parameter("occupied_thresh_default", 0.65);
   map_subscribe_transient_local_ = declare_parameter("map_subscribe_transient_local", true);
+  tile_size_ = declare_parameter("tile_size", 0);
 }
 
 MapSaver::~MapSaver()
@@ -124,6 +125,7 @@ void MapSaver::saveMapCallback(
   save_parameters.image_format = request->image_format;
   save_parameters.free_thresh = request->free_thresh;
   save_parameters.occupied_thresh = request->occupied_thresh;
+  save_parameters.tile_size = tile_size_;
   try {
     save_parameters.mode = map_mode_from_string(request->map_mode);
   } catch (std::invalid_argument &) {
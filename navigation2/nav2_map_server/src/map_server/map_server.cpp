@@ -46,15 +46,21 @@
 
 #include "nav2_map_server/map_server.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <string>
 #include <memory>
 #include <fstream>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include "yaml-cpp/yaml.h"
 #include "lifecycle_msgs/msg/state.hpp"
 #include "nav2_map_server/map_io.hpp"
+#include "nav2_util/geometry_utils.hpp"
+#include "tf2_ros/create_timer_ros.h"
 
 using namespace std::chrono_literals;
 using namespace std::placeholders;
@@ -71,6 +77,10 @@ MapServer::MapServer()
   declare_parameter("yaml_filename", rclcpp::PARAMETER_STRING);
   declare_parameter("topic_name", "map");
   declare_parameter("frame_id", "map");
+  declare_parameter("tile_window_size", 0.0);
+  declare_parameter("tile_plan_margin", 2.0);
+  declare_parameter("tile_update_period", 1.0);
+  declare_parameter("robot_base_frame", "base_link");
 }
 
 MapServer::~MapServer()
@@ -87,6 +97,23 @@ MapServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
 
   std::string topic_name = get_parameter("topic_name").as_string();
   frame_id_ = get_parameter("frame_id").as_string();
+  tile_window_size_ = get_parameter("tile_window_size").as_double();
+  tile_plan_margin_ = get_parameter("tile_plan_margin").as_double();
+  tile_update_period_ = get_parameter("tile_update_period").as_double();
+  robot_base_frame_ = get_parameter("robot_base_frame").as_string();
+
+  if (tile_window_size_ > 0.0) {
+    tf_buffer_ = std::make_shared<tf2_ros::Buffer>(get_clock());
+    auto timer_interface = std::make_shared<tf2_ros::CreateTimerROS>(
+      get_node_base_interface(), get_node_timers_interface());
+    tf_buffer_->setCreateTimerInterface(timer_interface);
+    tf_listener_ = std::make_shared<tf2_ros::TransformListener>(*tf_buffer_);
+
+    // Keep the tiles along the global plan loaded as well
+    plan_sub_ = create_subscription<nav_msgs::msg::Path>(
+      "plan", rclcpp::SystemDefaultsQoS(),
+      [this](const nav_msgs::msg::Path::SharedPtr msg) {plan_ = msg;});
+  }
 
   // Shared pointer to LoadMap::Response is also should be initialized
   // in order to avoid null-pointer dereference
@@ -110,6 +137,12 @@ MapServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
     topic_name,
     rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable());
 
+  if (tile_window_size_ > 0.0) {
+    // Same topic and QoS as StaticLayer subscribes to with subscribe_to_updates
+    update_pub_ = create_publisher<map_msgs::msg::OccupancyGridUpdate>(
+      topic_name + "_updates", rclcpp::SystemDefaultsQoS());
+  }
+
   // Create a service that loads the occupancy grid from a file
   load_map_service_ = create_service<nav2_msgs::srv::LoadMap>(
     service_prefix + std::string(load_map_service_name_),
@@ -127,6 +160,17 @@ MapServer::on_activate(const rclcpp_lifecycle::State & /*state*/)
   occ_pub_->on_activate();
   auto occ_grid = std::make_unique<nav_msgs::msg::OccupancyGrid>(msg_);
   occ_pub_->publish(std::move(occ_grid));
+  map_subscribers_ = occ_pub_->get_subscription_count();
+
+  if (update_pub_) {
+    update_pub_->on_activate();
+  }
+  if (tile_window_size_ > 0.0) {
+    tile_timer_ = create_wall_timer(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::duration<double>(tile_update_period_)),
+      std::bind(&MapServer::tileTimerCallback, this));
+  }
 
   // create bond connection
   createBond();
@@ -140,6 +184,10 @@ MapServer::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
   RCLCPP_INFO(get_logger(), "Deactivating");
 
   occ_pub_->on_deactivate();
+  if (update_pub_) {
+    update_pub_->on_deactivate();
+  }
+  tile_timer_.reset();
 
   // destroy bond connection
   destroyBond();
@@ -153,8 +201,15 @@ MapServer::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
   RCLCPP_INFO(get_logger(), "Cleaning up");
 
   occ_pub_.reset();
+  update_pub_.reset();
   occ_service_.reset();
   load_map_service_.reset();
+  plan_sub_.reset();
+  plan_.reset();
+  tf_listener_.reset();
+  tf_buffer_.reset();
+  tiled_map_.reset();
+  loaded_tiles_.clear();
 
   return nav2_util::CallbackReturn::SUCCESS;
 }
@@ -199,6 +254,7 @@ void MapServer::loadMapCallback(
   if (loadMapResponseFromYaml(request->map_url, response)) {
     auto occ_grid = std::make_unique<nav_msgs::msg::OccupancyGrid>(msg_);
     occ_pub_->publish(std::move(occ_grid));  // publish new map
+    map_subscribers_ = occ_pub_->get_subscription_count();
   }
 }
 
@@ -206,6 +262,12 @@ bool MapServer::loadMapResponseFromYaml(
   const std::string & yaml_file,
   std::shared_ptr<nav2_msgs::srv::LoadMap::Response> response)
 {
+  if (tile_window_size_ > 0.0 && loadTiledMapFromYaml(yaml_file, response)) {
+    return true;
+  }
+  tiled_map_.reset();
+  loaded_tiles_.clear();
+
   switch (loadMapFromYaml(yaml_file, msg_)) {
     case MAP_DOES_NOT_EXIST:
       response->result = nav2_msgs::srv::LoadMap::Response::RESULT_MAP_DOES_NOT_EXIST;
@@ -234,4 +296,200 @@ void MapServer::updateMsgHeader()
   msg_.header.stamp = now();
 }
 
+bool MapServer::loadTiledMapFromYaml(
+  const std::string & yaml_file,
+  std::shared_ptr<nav2_msgs::srv::LoadMap::Response> response)
+{
+  LoadParameters load_parameters;
+  try {
+    load_parameters = loadMapYaml(yaml_file);
+  } catch (std::exception &) {
+    // Reported when loading the map the regular way
+    return false;
+  }
+  if (load_parameters.tiles_file_name.empty()) {
+    RCLCPP_WARN(
+      get_logger(), "Map %s has no tiled map, loading the whole image", yaml_file.c_str());
+    return false;
+  }
+
+  auto tiled_map = std::make_unique<TiledMap>();
+  try {
+    tiled_map->open(load_parameters.tiles_file_name);
+  } catch (std::runtime_error & e) {
+    RCLCPP_ERROR(
+      get_logger(), "Failed to open tiled map %s: %s",
+      load_parameters.tiles_file_name.c_str(), e.what());
+    return false;
+  }
+  // Each tile is read once into msg_, there is nothing to cache
+  tiled_map->setCacheSize(1);
+
+  tiled_map_ = std::move(tiled_map);
+  msg_.info = nav_msgs::msg::MapMetaData();
+  msg_.info.width = tiled_map_->width();
+  msg_.info.height = tiled_map_->height();
+  msg_.info.resolution = load_parameters.resolution;
+  msg_.info.origin.position.x = load_parameters.origin[0];
+  msg_.info.origin.position.y = load_parameters.origin[1];
+  msg_.info.origin.orientation =
+    nav2_util::geometry_utils::orientationAroundZAxis(load_parameters.origin[2]);
+  // Cells of the tiles not read yet are unknown
+  msg_.data.assign(static_cast<size_t>(msg_.info.width) * msg_.info.height, -1);
+  loaded_tiles_.assign(static_cast<size_t>(tiled_map_->tilesX()) * tiled_map_->tilesY(), false);
+  plan_.reset();
+
+  // Start around the map frame origin if the robot pose is not known yet
+  double x = 0.0, y = 0.0;
+  getRobotPosition(x, y);
+  map_msgs::msg::OccupancyGridUpdate update;
+  updateTileWindow(true, x, y, update);
+  if (std::find(loaded_tiles_.begin(), loaded_tiles_.end(), true) == loaded_tiles_.end()) {
+    tiled_map_.reset();
+    return false;
+  }
+  updateMsgHeader();
+  RCLCPP_INFO(
+    get_logger(), "Opened %u X %u tiled map %s", msg_.info.width,
+    msg_.info.height, load_parameters.tiles_file_name.c_str());
+
+  response->map = msg_;
+  response->result = nav2_msgs::srv::LoadMap::Response::RESULT_SUCCESS;
+  return true;
+}
+
+bool MapServer::updateTileWindow(
+  bool robot_known, double x, double y, map_msgs::msg::OccupancyGridUpdate & update)
+{
+  const unsigned int tiles_x = tiled_map_->tilesX();
+  const unsigned int tiles_y = tiled_map_->tilesY();
+  const unsigned int tile_size = tiled_map_->tileSize();
+  const double tile_length = tile_size * msg_.info.resolution;
+
+  // Collect the tiles overlapping a square around a point that were not read
+  // yet. A point off the map marks the tiles on the nearest edge.
+  std::vector<bool> marked = loaded_tiles_;
+  std::vector<unsigned int> new_tiles;
+  auto mark = [&](double px, double py, double half_size) {
+      auto tile_range = [&](double p, double origin, unsigned int count, int & from, int & to) {
+          from = std::floor((p - half_size - origin) / tile_length);
+          to = std::floor((p + half_size - origin) / tile_length);
+          from = std::clamp(from, 0, static_cast<int>(count) - 1);
+          to = std::clamp(to, 0, static_cast<int>(count) - 1);
+        };
+      int tx0, tx1, ty0, ty1;
+      tile_range(px, msg_.info.origin.position.x, tiles_x, tx0, tx1);
+      tile_range(py, msg_.info.origin.position.y, tiles_y, ty0, ty1);
+      for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+          if (!marked[ty * tiles_x + tx]) {
+            marked[ty * tiles_x + tx] = true;
+            new_tiles.push_back(ty * tiles_x + tx);
+          }
+        }
+      }
+    };
+  if (robot_known) {
+    mark(x, y, tile_window_size_ / 2.0);
+  }
+  if (plan_) {
+    for (const auto & pose : plan_->poses) {
+      mark(pose.pose.position.x, pose.pose.position.y, tile_plan_margin_);
+    }
+  }
+  if (new_tiles.empty()) {
+    return false;
+  }
+
+  // Read the new tiles one at a time, so tiles along a long plan do not pull
+  // in the rest of their bounding box
+  unsigned int min_x = msg_.info.width, max_x = 0, min_y = msg_.info.height, max_y = 0;
+  std::vector<int8_t> data;
+  for (unsigned int tile : new_tiles) {
+    const unsigned int x0 = (tile % tiles_x) * tile_size;
+    const unsigned int y0 = (tile / tiles_x) * tile_size;
+    const unsigned int size_x = std::min(x0 + tile_size, msg_.info.width) - x0;
+    const unsigned int size_y = std::min(y0 + tile_size, msg_.info.height) - y0;
+    try {
+      tiled_map_->readRegion(x0, y0, size_x, size_y, data);
+    } catch (std::runtime_error & e) {
+      RCLCPP_ERROR(get_logger(), "Failed to read map tiles: %s", e.what());
+      break;
+    }
+    for (unsigned int row = 0; row < size_y; ++row) {
+      std::copy_n(
+        data.begin() + static_cast<size_t>(row) * size_x, size_x,
+        msg_.data.begin() + static_cast<size_t>(y0 + row) * msg_.info.width + x0);
+    }
+    loaded_tiles_[tile] = true;
+    min_x = std::min(min_x, x0);
+    max_x = std::max(max_x, x0 + size_x);
+    min_y = std::min(min_y, y0);
+    max_y = std::max(max_y, y0 + size_y);
+  }
+  if (min_x >= max_x) {
+    return false;
+  }
+
+  // One update per call: the cells between the new tiles come from msg_ and
+  // are either already known to subscribers or still unknown
+  update.header.frame_id = frame_id_;
+  update.header.stamp = now();
+  update.x = min_x;
+  update.y = min_y;
+  update.width = max_x - min_x;
+  update.height = max_y - min_y;
+  update.data.resize(static_cast<size_t>(update.width) * update.height);
+  for (unsigned int row = 0; row < update.height; ++row) {
+    std::copy_n(
+      msg_.data.begin() + static_cast<size_t>(min_y + row) * msg_.info.width + min_x,
+      update.width, update.data.begin() + static_cast<size_t>(row) * update.width);
+  }
+  return true;
+}
+
+bool MapServer::getRobotPosition(double & x, double & y)
+{
+  if (!tf_buffer_) {
+    return false;
+  }
+  geometry_msgs::msg::TransformStamped transform;
+  try {
+    transform = tf_buffer_->lookupTransform(frame_id_, robot_base_frame_, tf2::TimePointZero);
+  } catch (tf2::TransformException & ex) {
+    RCLCPP_DEBUG(get_logger(), "No robot pose for the tiled map: %s", ex.what());
+    return false;
+  }
+  x = transform.transform.translation.x;
+  y = transform.transform.translation.y;
+  return true;
+}
+
+void MapServer::tileTimerCallback()
+{
+  if (!tiled_map_) {
+    return;
+  }
+
+  // The tiles along the plan are read even while the robot pose is unknown
+  double x = 0.0, y = 0.0;
+  const bool robot_known = getRobotPosition(x, y);
+  map_msgs::msg::OccupancyGridUpdate update;
+  if (updateTileWindow(robot_known, x, y, update)) {
+    updateMsgHeader();
+    RCLCPP_INFO(
+      get_logger(), "Publishing %u X %u cells of the tiled map", update.width, update.height);
+    update_pub_->publish(std::make_unique<map_msgs::msg::OccupancyGridUpdate>(update));
+  }
+
+  // Subscribers that joined since the map was published whole missed the
+  // earlier updates. Publishing the map again keeps its size and origin, so
+  // the costmaps of the other subscribers are not reset by it.
+  const size_t subscribers = occ_pub_->get_subscription_count();
+  if (subscribers > map_subscribers_) {
+    occ_pub_->publish(std::make_unique<nav_msgs::msg::OccupancyGrid>(msg_));
+  }
+  map_subscribers_ = subscribers;
+}
+
 }  // namespace nav2_map_server
@@ -0,0 +1,248 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_map_server/tiled_map.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nav2_util/occ_grid_values.hpp"
+
+namespace nav2_map_server
+{
+
+namespace
+{
+
+const char kMagic[8] = {'N', 'A', 'V', '2', 'T', 'I', 'L', 'E'};
+constexpr uint32_t kVersion = 1;
+// Magic, version, width, height and tile size
+constexpr size_t kHeaderSize = 8 + 4 * 4;
+constexpr size_t kIndexEntrySize = 8 + 4;
+
+void putLittleEndian(std::vector<uint8_t> & out, uint64_t value, size_t bytes)
+{
+  for (size_t i = 0; i < bytes; ++i) {
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+uint64_t getLittleEndian(const uint8_t * in, size_t bytes)
+{
+  uint64_t value = 0;
+  for (size_t i = 0; i < bytes; ++i) {
+    value |= static_cast<uint64_t>(in[i]) << (8 * i);
+  }
+  return value;
+}
+
+}  // namespace
+
+void saveTiledMap(
+  const nav_msgs::msg::OccupancyGrid & map,
+  const std::string & file_name,
+  unsigned int tile_size)
+{
+  const unsigned int width = map.info.width;
+  const unsigned int height = map.info.height;
+  if (tile_size == 0 || width == 0 || height == 0 ||
+    map.data.size() != static_cast<size_t>(width) * height)
+  {
+    throw std::runtime_error("Invalid map or tile size for a tiled map");
+  }
+  const unsigned int tiles_x = (width + tile_size - 1) / tile_size;
+  const unsigned int tiles_y = (height + tile_size - 1) / tile_size;
+
+  std::vector<uint8_t> index;
+  std::vector<uint8_t> tiles;
+  std::vector<int8_t> cells;
+  std::vector<uint8_t> compressed;
+  const uint64_t data_offset = kHeaderSize + kIndexEntrySize * tiles_x * tiles_y;
+  for (unsigned int ty = 0; ty < tiles_y; ++ty) {
+    for (unsigned int tx = 0; tx < tiles_x; ++tx) {
+      const unsigned int x0 = tx * tile_size;
+      const unsigned int y0 = ty * tile_size;
+      const unsigned int size_x = std::min(tile_size, width - x0);
+      const unsigned int size_y = std::min(tile_size, height - y0);
+      cells.resize(static_cast<size_t>(size_x) * size_y);
+      for (unsigned int y = 0; y < size_y; ++y) {
+        std::memcpy(
+          cells.data() + static_cast<size_t>(y) * size_x,
+          map.data.data() + static_cast<size_t>(y0 + y) * width + x0, size_x);
+      }
+
+      uLongf compressed_size = compressBound(cells.size());
+      compressed.resize(compressed_size);
+      if (compress(
+          compressed.data(), &compressed_size,
+          reinterpret_cast<const Bytef *>(cells.data()), cells.size()) != Z_OK)
+      {
+        throw std::runtime_error("Failed to compress map tile");
+      }
+
+      putLittleEndian(index, data_offset + tiles.size(), 8);
+      putLittleEndian(index, compressed_size, 4);
+      tiles.insert(tiles.end(), compressed.begin(), compressed.begin() + compressed_size);
+    }
+  }
+
+  std::vector<uint8_t> header(kMagic, kMagic + sizeof(kMagic));
+  putLittleEndian(header, kVersion, 4);
+  putLittleEndian(header, width, 4);
+  putLittleEndian(header, height, 4);
+  putLittleEndian(header, tile_size, 4);
+
+  std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char *>(header.data()), header.size());
+  file.write(reinterpret_cast<const char *>(index.data()), index.size());
+  file.write(reinterpret_cast<const char *>(tiles.data()), tiles.size());
+  if (!file) {
+    throw std::runtime_error("Failed to write tiled map file " + file_name);
+  }
+}
+
+TiledMap::TiledMap(size_t cache_size)
+: cache_size_(std::max<size_t>(cache_size, 1))
+{
+}
+
+void TiledMap::setCacheSize(size_t cache_size)
+{
+  cache_size_ = std::max<size_t>(cache_size, 1);
+  while (cache_.size() > cache_size_) {
+    cache_lookup_.erase(cache_.back().first);
+    cache_.pop_back();
+  }
+}
+
+void TiledMap::open(const std::string & file_name)
+{
+  file_.close();
+  file_.clear();
+  cache_.clear();
+  cache_lookup_.clear();
+  index_.clear();
+
+  file_.open(file_name, std::ios::binary);
+  uint8_t header[kHeaderSize];
+  if (!file_.read(reinterpret_cast<char *>(header), sizeof(header)) ||
+    std::memcmp(header, kMagic, sizeof(kMagic)) != 0)
+  {
+    throw std::runtime_error("Not a tiled map file: " + file_name);
+  }
+  if (getLittleEndian(header + 8, 4) != kVersion) {
+    throw std::runtime_error("Unsupported tiled map version in " + file_name);
+  }
+  width_ = getLittleEndian(header + 12, 4);
+  height_ = getLittleEndian(header + 16, 4);
+  tile_size_ = getLittleEndian(header + 20, 4);
+  if (width_ == 0 || height_ == 0 || tile_size_ == 0) {
+    throw std::runtime_error("Invalid tiled map header in " + file_name);
+  }
+  tiles_x_ = (width_ + tile_size_ - 1) / tile_size_;
+  tiles_y_ = (height_ + tile_size_ - 1) / tile_size_;
+
+  std::vector<uint8_t> index(kIndexEntrySize * tiles_x_ * tiles_y_);
+  if (!file_.read(reinterpret_cast<char *>(index.data()), index.size())) {
+    throw std::runtime_error("Truncated tiled map index in " + file_name);
+  }
+  index_.resize(static_cast<size_t>(tiles_x_) * tiles_y_);
+  for (size_t i = 0; i < index_.size(); ++i) {
+    index_[i].offset = getLittleEndian(&index[i * kIndexEntrySize], 8);
+    index_[i].size = getLittleEndian(&index[i * kIndexEntrySize + 8], 4);
+  }
+}
+
+void TiledMap::readRegion(
+  unsigned int x0, unsigned int y0, unsigned int size_x, unsigned int size_y,
+  std::vector<int8_t> & data,
+  const std::function<bool(unsigned int, unsigned int)> & use_tile)
+{
+  if (x0 + size_x > width_ || y0 + size_y > height_) {
+    throw std::runtime_error("Region out of the tiled map");
+  }
+  data.assign(static_cast<size_t>(size_x) * size_y, nav2_util::OCC_GRID_UNKNOWN);
+  if (size_x == 0 || size_y == 0) {
+    return;
+  }
+
+  for (unsigned int ty = y0 / tile_size_; ty <= (y0 + size_y - 1) / tile_size_; ++ty) {
+    for (unsigned int tx = x0 / tile_size_; tx <= (x0 + size_x - 1) / tile_size_; ++tx) {
+      if (use_tile && !use_tile(tx, ty)) {
+        continue;
+      }
+      const std::vector<int8_t> & cells = tile(tx, ty);
+      const unsigned int tile_x0 = tx * tile_size_;
+      const unsigned int tile_y0 = ty * tile_size_;
+      const unsigned int tile_size_x = std::min(tile_size_, width_ - tile_x0);
+
+      // Part of the tile inside the region
+      const unsigned int from_x = std::max(x0, tile_x0);
+      const unsigned int to_x = std::min(x0 + size_x, tile_x0 + tile_size_x);
+      const unsigned int from_y = std::max(y0, tile_y0);
+      const unsigned int to_y = std::min(y0 + size_y, std::min(tile_y0 + tile_size_, height_));
+      for (unsigned int y = from_y; y < to_y; ++y) {
+        std::memcpy(
+          data.data() + static_cast<size_t>(y - y0) * size_x + (from_x - x0),
+          cells.data() + static_cast<size_t>(y - tile_y0) * tile_size_x + (from_x - tile_x0),
+          to_x - from_x);
+      }
+    }
+  }
+}
+
+const std::vector<int8_t> & TiledMap::tile(unsigned int tx, unsigned int ty)
+{
+  const unsigned int key = ty * tiles_x_ + tx;
+  auto cached = cache_lookup_.find(key);
+  if (cached != cache_lookup_.end()) {
+    cache_.splice(cache_.begin(), cache_, cached->second);
+    return cached->second->second;
+  }
+
+  const TileIndex & entry = index_[key];
+  std::vector<uint8_t> compressed(entry.size);
+  file_.clear();
+  file_.seekg(entry.offset);
+  if (!file_.read(reinterpret_cast<char *>(compressed.data()), compressed.size())) {
+    throw std::runtime_error("Failed to read map tile");
+  }
+
+  const size_t size_x = std::min(tile_size_, width_ - tx * tile_size_);
+  const size_t size_y = std::min(tile_size_, height_ - ty * tile_size_);
+  std::vector<int8_t> cells(size_x * size_y);
+  uLongf cells_size = cells.size();
+  if (uncompress(
+      reinterpret_cast<Bytef *>(cells.data()), &cells_size,
+      compressed.data(), compressed.size()) != Z_OK || cells_size != cells.size())
+  {
+    throw std::runtime_error("Failed to decompress map tile");
+  }
+
+  if (cache_.size() >= cache_size_) {
+    cache_lookup_.erase(cache_.back().first);
+    cache_.pop_back();
+  }
+  cache_.emplace_front(key, std::move(cells));
+  cache_lookup_[key] = cache_.begin();
+  return cache_.front().second;
+}
+
+}  // namespace nav2_map_server
@@ -32,6 +32,7 @@
 /* Author: Brian Gerkey */
 
 #include <gtest/gtest.h>
+#include <chrono>
 #include <experimental/filesystem>
 #include <stdexcept>
 #include <string>
@@ -43,6 +44,7 @@
 #include "yaml-cpp/yaml.h"
 #include "nav2_map_server/map_io.hpp"
 #include "nav2_map_server/map_server.hpp"
+#include "nav2_map_server/tiled_map.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "test_constants/test_constants.h"
 
@@ -232,6 +234,151 @@ TEST_F(MapIOTester, loadSaveMapModes)
   verifyMapMsg(map_msg);
 }
 
+// Save a large map as PGM and PNG, then load both with and without the fast path for
+// 8 bit grayscale images in all map modes.
+// Succeeds if the fast path gives the same maps as GraphicsMagick.
+TEST_F(MapIOTester, fastPathMatchesMagick)
+{
+  // 1. Build a large map with free, occupied, unknown and intermediate cells
+  nav_msgs::msg::OccupancyGrid map_msg;
+  map_msg.info.width = 2000;
+  map_msg.info.height = 1500;
+  map_msg.info.resolution = g_valid_image_res;
+  map_msg.data.resize(map_msg.info.width * map_msg.info.height);
+  for (size_t i = 0; i < map_msg.data.size(); i++) {
+    map_msg.data[i] = static_cast<int8_t>(static_cast<int>((i * 7919) % 102) - 1);
+  }
+
+  for (const std::string format : {"pgm", "png"}) {
+    // 2. Save it in Raw mode, which writes each occupancy value as its own gray level
+    SaveParameters saveParameters;
+    fillSaveParameters(path(g_tmp_dir) / path(g_valid_map_name), format, saveParameters);
+    saveParameters.mode = MapMode::Raw;
+    ASSERT_TRUE(saveMapToFile(map_msg, saveParameters));
+
+    LoadParameters loadParameters;
+    fillLoadParameters(
+      std::string(path(g_tmp_dir) / path(g_valid_map_name)) + "." + format, loadParameters);
+
+    nav_msgs::msg::OccupancyGrid direct_msg;
+    ASSERT_TRUE(loadMapFromGrayImage(loadParameters, direct_msg));
+
+    // 3. Compare both paths in each mode
+    for (auto mode : {MapMode::Trinary, MapMode::Scale, MapMode::Raw}) {
+      loadParameters.mode = mode;
+      for (int negate : {0, 1}) {
+        loadParameters.negate = negate;
+
+        nav_msgs::msg::OccupancyGrid magick_msg, fast_msg;
+        ASSERT_NO_THROW(loadMapFromFile(loadParameters, magick_msg, false));
+        ASSERT_NO_THROW(loadMapFromFile(loadParameters, fast_msg, true));
+
+        ASSERT_EQ(fast_msg.info.width, magick_msg.info.width);
+        ASSERT_EQ(fast_msg.info.height, magick_msg.info.height);
+        ASSERT_EQ(fast_msg.data, magick_msg.data) <<
+          format << " " << map_mode_to_string(mode) << " negate " << negate;
+      }
+    }
+
+    // 4. Raw mode keeps the saved values
+    loadParameters.mode = MapMode::Raw;
+    loadParameters.negate = 0;
+    nav_msgs::msg::OccupancyGrid raw_msg;
+    ASSERT_NO_THROW(loadMapFromFile(loadParameters, raw_msg));
+    ASSERT_EQ(raw_msg.data, map_msg.data);
+  }
+}
+
+// Benchmark of the 8 bit grayscale fast path against GraphicsMagick, not run
+// by default. Run it with --gtest_also_run_disabled_tests.
+// Loads a 4000 x 4000 map laid out like a real one: free rooms bounded by
+// occupied walls, surrounded by unknown space.
+TEST_F(MapIOTester, DISABLED_benchmarkFastPathAgainstMagick)
+{
+  const unsigned int size = 4000;
+  nav_msgs::msg::OccupancyGrid map_msg;
+  map_msg.info.width = size;
+  map_msg.info.height = size;
+  map_msg.info.resolution = 0.05;
+  map_msg.data.assign(size * size, -1);
+  for (unsigned int y = 500; y < 3500; y++) {
+    for (unsigned int x = 500; x < 3500; x++) {
+      const bool wall = x % 400 < 4 || y % 400 < 4 || x < 504 || y < 504 ||
+        x >= 3496 || y >= 3496;
+      map_msg.data[y * size + x] = wall ? 100 : 0;
+    }
+  }
+
+  const int runs = 5;
+  for (const std::string format : {"pgm", "png"}) {
+    SaveParameters saveParameters;
+    fillSaveParameters(path(g_tmp_dir) / path(g_valid_map_name), format, saveParameters);
+    ASSERT_TRUE(saveMapToFile(map_msg, saveParameters));
+
+    LoadParameters loadParameters;
+    fillLoadParameters(
+      std::string(path(g_tmp_dir) / path(g_valid_map_name)) + "." + format, loadParameters);
+
+    for (bool fast : {false, true}) {
+      nav_msgs::msg::OccupancyGrid loaded_msg;
+      const auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < runs; i++) {
+        ASSERT_NO_THROW(loadMapFromFile(loadParameters, loaded_msg, fast));
+      }
+      const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+      ASSERT_EQ(loaded_msg.data, map_msg.data);
+      std::cout << format << " " << (fast ? "fast path" : "GraphicsMagick") << ": " <<
+        elapsed.count() / runs << " ms per load" << std::endl;
+    }
+  }
+}
+
+// Save a map with a tiled copy. Read the whole tiled map and parts of it.
+// Succeeds if the tiles give the same cells as the image.
+TEST_F(MapIOTester, saveLoadTiledMap)
+{
+  // 1. Load map from YAML file
+  nav_msgs::msg::OccupancyGrid map_msg;
+  LOAD_MAP_STATUS status = loadMapFromYaml(path(TEST_DIR) / path(g_valid_yaml_file), map_msg);
+  ASSERT_EQ(status, LOAD_MAP_SUCCESS);
+
+  // 2. Save it with 4 x 4 tiles, so that the last row and column of tiles are cut
+  SaveParameters saveParameters;
+  fillSaveParameters(path(g_tmp_dir) / path(g_valid_map_name), "pgm", saveParameters);
+  saveParameters.tile_size = 4;
+  ASSERT_TRUE(saveMapToFile(map_msg, saveParameters));
+
+  LoadParameters loadParameters = loadMapYaml(path(g_tmp_dir) / path(g_valid_yaml_file));
+  ASSERT_FALSE(loadParameters.tiles_file_name.empty());
+
+  // 3. Whole map
+  TiledMap tiled_map(2);
+  ASSERT_NO_THROW(tiled_map.open(loadParameters.tiles_file_name));
+  ASSERT_EQ(tiled_map.width(), g_valid_image_width);
+  ASSERT_EQ(tiled_map.height(), g_valid_image_height);
+  ASSERT_EQ(tiled_map.tilesX(), 3u);
+  std::vector<int8_t> data;
+  tiled_map.readRegion(0, 0, g_valid_image_width, g_valid_image_height, data);
+  for (unsigned int i = 0; i < g_valid_image_width * g_valid_image_height; i++) {
+    ASSERT_EQ(g_valid_image_content[i], data[i]);
+  }
+
+  // 4. A region across tiles, skipping the middle column of tiles
+  tiled_map.readRegion(
+    3, 2, 6, 7, data, [](unsigned int tx, unsigned int) {return tx != 1;});
+  for (unsigned int y = 0; y < 7; y++) {
+    for (unsigned int x = 0; x < 6; x++) {
+      int8_t expected = (x + 3) / 4 == 1 ?
+        -1 : g_valid_image_content[(y + 2) * g_valid_image_width + x + 3];
+      ASSERT_EQ(expected, data[y * 6 + x]);
+    }
+  }
+
+  // 5. Regions out of the map are rejected
+  ASSERT_ANY_THROW(tiled_map.readRegion(5, 5, 6, 1, data));
+}
+
 // Try to load an invalid file with different ways.
 // Succeeds if all cases are got expected fail behaviours.
 TEST_F(MapIOTester, loadInvalidFile)
@@ -0,0 +1,219 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <experimental/filesystem>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_map_server/map_io.hpp"
+#include "nav2_map_server/map_server.hpp"
+#include "test_constants/test_constants.h"
+
+using std::experimental::filesystem::path;
+using Tiles = std::set<std::pair<unsigned int, unsigned int>>;
+
+// 100 x 80 cells of 0.1 m in 16 x 16 tiles: 7 x 5 tiles, the last ones cut.
+// The map frame origin is at cell (50, 40), in tile (3, 2).
+static const unsigned int WIDTH = 100;
+static const unsigned int HEIGHT = 80;
+static const unsigned int TILE_SIZE = 16;
+static const double RESOLUTION = 0.1;
+static const double ORIGIN_X = -5.0;
+static const double ORIGIN_Y = -4.0;
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+class TiledMapServerWrapper : public nav2_map_server::MapServer
+{
+public:
+  TiledMapServerWrapper()
+  {
+    frame_id_ = "map";
+    tile_window_size_ = 2.0;
+    tile_plan_margin_ = 0.5;
+  }
+
+  bool load(const std::string & yaml_file)
+  {
+    auto response = std::make_shared<nav2_msgs::srv::LoadMap::Response>();
+    return loadTiledMapFromYaml(yaml_file, response);
+  }
+
+  void setPlan(double x0, double x1, double y)
+  {
+    plan_ = std::make_shared<nav_msgs::msg::Path>();
+    for (double x = x0; x <= x1; x += RESOLUTION) {
+      geometry_msgs::msg::PoseStamped pose;
+      pose.pose.position.x = x;
+      pose.pose.position.y = y;
+      plan_->poses.push_back(pose);
+    }
+  }
+
+  const nav_msgs::msg::OccupancyGrid & map() const {return msg_;}
+
+  using nav2_map_server::MapServer::updateTileWindow;
+};
+
+class TiledMapServerTester : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    nav_msgs::msg::OccupancyGrid map;
+    map.info.width = WIDTH;
+    map.info.height = HEIGHT;
+    map.info.resolution = RESOLUTION;
+    map.info.origin.position.x = ORIGIN_X;
+    map.info.origin.position.y = ORIGIN_Y;
+    map.info.origin.orientation.w = 1.0;
+    const int8_t values[] = {0, 100, -1};
+    for (unsigned int i = 0; i < WIDTH * HEIGHT; i++) {
+      map.data.push_back(values[(i % WIDTH + i / WIDTH) % 3]);
+    }
+
+    nav2_map_server::SaveParameters save_parameters;
+    save_parameters.map_file_name = path(g_tmp_dir) / path("tiled_map_server");
+    save_parameters.image_format = "pgm";
+    save_parameters.free_thresh = g_default_free_thresh;
+    save_parameters.occupied_thresh = g_default_occupied_thresh;
+    save_parameters.tile_size = TILE_SIZE;
+    ASSERT_TRUE(nav2_map_server::saveMapToFile(map, save_parameters));
+
+    yaml_file_ = save_parameters.map_file_name + ".yaml";
+    ASSERT_EQ(
+      nav2_map_server::loadMapFromYaml(yaml_file_, reference_),
+      nav2_map_server::LOAD_MAP_SUCCESS);
+    server_ = std::make_shared<TiledMapServerWrapper>();
+  }
+
+  // The published map keeps the size and origin of the whole map
+  void checkInfo()
+  {
+    const auto & info = server_->map().info;
+    ASSERT_EQ(info.width, WIDTH);
+    ASSERT_EQ(info.height, HEIGHT);
+    ASSERT_EQ(server_->map().data.size(), WIDTH * HEIGHT);
+    EXPECT_DOUBLE_EQ(info.origin.position.x, ORIGIN_X);
+    EXPECT_DOUBLE_EQ(info.origin.position.y, ORIGIN_Y);
+  }
+
+  // Cells of the loaded tiles match the map, the others are unknown
+  void checkTiles(const Tiles & loaded)
+  {
+    const auto & data = server_->map().data;
+    for (unsigned int y = 0; y < HEIGHT; y++) {
+      for (unsigned int x = 0; x < WIDTH; x++) {
+        const bool is_loaded = loaded.count({x / TILE_SIZE, y / TILE_SIZE}) > 0;
+        const int8_t expected = is_loaded ? reference_.data[y * WIDTH + x] : -1;
+        ASSERT_EQ(data[y * WIDTH + x], expected) << "cell " << x << ", " << y;
+      }
+    }
+  }
+
+  // The update covers a rectangle of cells, with the values of the map
+  void checkUpdate(
+    const map_msgs::msg::OccupancyGridUpdate & update,
+    unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+  {
+    ASSERT_EQ(update.header.frame_id, "map");
+    ASSERT_EQ(update.x, static_cast<int>(x));
+    ASSERT_EQ(update.y, static_cast<int>(y));
+    ASSERT_EQ(update.width, width);
+    ASSERT_EQ(update.height, height);
+    ASSERT_EQ(update.data.size(), width * height);
+    for (unsigned int row = 0; row < height; row++) {
+      for (unsigned int col = 0; col < width; col++) {
+        ASSERT_EQ(
+          update.data[row * width + col],
+          server_->map().data[(y + row) * WIDTH + x + col]);
+      }
+    }
+  }
+
+  std::string yaml_file_;
+  nav_msgs::msg::OccupancyGrid reference_;
+  std::shared_ptr<TiledMapServerWrapper> server_;
+};
+
+// Open a tiled map, move the robot and set a plan.
+// Succeeds if only the tiles around the robot and the plan are read, and the
+// map keeps its size and origin.
+TEST_F(TiledMapServerTester, windowAndPlanTiles)
+{
+  // 1. Without a robot pose, the window is around the map frame origin
+  ASSERT_TRUE(server_->load(yaml_file_));
+  checkInfo();
+  Tiles loaded = {{2, 1}, {3, 1}, {2, 2}, {3, 2}, {2, 3}, {3, 3}};
+  checkTiles(loaded);
+
+  // 2. Nothing new to read in the same place
+  map_msgs::msg::OccupancyGridUpdate update;
+  ASSERT_FALSE(server_->updateTileWindow(true, 0.0, 0.0, update));
+
+  // 3. Moving right reads the next column of tiles only
+  ASSERT_TRUE(server_->updateTileWindow(true, 1.5, 0.0, update));
+  checkInfo();
+  loaded.insert({{4, 1}, {4, 2}, {4, 3}});
+  checkTiles(loaded);
+  checkUpdate(update, 64, 16, 16, 48);
+
+  // 4. A plan to the right edge reads the tiles along it, up to the cut last column
+  server_->setPlan(1.5, 4.5, 0.0);
+  update = map_msgs::msg::OccupancyGridUpdate();
+  ASSERT_TRUE(server_->updateTileWindow(true, 1.5, 0.0, update));
+  checkInfo();
+  loaded.insert({{5, 2}, {6, 2}});
+  checkTiles(loaded);
+  checkUpdate(update, 80, 32, 20, 16);
+
+  // 5. Going back reads nothing, tiles stay loaded
+  ASSERT_FALSE(server_->updateTileWindow(true, 0.0, 0.0, update));
+  checkTiles(loaded);
+}
+
+// Tiles are read around the nearest edge for a robot off the map
+TEST_F(TiledMapServerTester, robotOffTheMap)
+{
+  ASSERT_TRUE(server_->load(yaml_file_));
+  map_msgs::msg::OccupancyGridUpdate update;
+  ASSERT_TRUE(server_->updateTileWindow(true, 20.0, 0.0, update));
+  checkInfo();
+  checkTiles({{2, 1}, {3, 1}, {2, 2}, {3, 2}, {2, 3}, {3, 3}, {6, 1}, {6, 2}, {6, 3}});
+  checkUpdate(update, 96, 16, 4, 48);
+}
+
+// The tiles along the plan are read while the robot pose is unknown
+TEST_F(TiledMapServerTester, planWithoutRobot)
+{
+  ASSERT_TRUE(server_->load(yaml_file_));
+  map_msgs::msg::OccupancyGridUpdate update;
+  ASSERT_FALSE(server_->updateTileWindow(false, 0.0, 0.0, update));
+
+  server_->setPlan(1.5, 4.5, 0.0);
+  ASSERT_TRUE(server_->updateTileWindow(false, 0.0, 0.0, update));
+  checkInfo();
+  checkTiles({{2, 1}, {3, 1}, {2, 2}, {3, 2}, {2, 3}, {3, 3}, {4, 2}, {5, 2}, {6, 2}});
+  checkUpdate(update, 64, 32, 36, 16);
+}
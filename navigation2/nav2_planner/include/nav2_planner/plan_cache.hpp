@@ -0,0 +1,141 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_PLANNER__PLAN_CACHE_HPP_
+#define NAV2_PLANNER__PLAN_CACHE_HPP_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "nav_msgs/msg/path.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+
+namespace nav2_planner
+{
+
+/**
+ * @class nav2_planner::PlanCache
+ * @brief Small LRU cache of global plans
+ *
+ * Entries are keyed on the planner id, the start and goal positions quantized
+ * to costmap cells, the start orientation quantized to yaw bins and the exact
+ * goal orientation. Each entry remembers the costmap cells in a
+ * corridor around its path and a checksum of their costs, and is only
+ * returned while that checksum is unchanged and no path cell became lethal.
+ * Changes elsewhere in the costmap do not invalidate an entry.
+ */
+class PlanCache
+{
+public:
+  /**
+   * @brief Constructor
+   * @param capacity Maximum number of plans kept
+   * @param corridor_radius Half width of the corridor around a path that is
+   * checked for changes, in meters
+   */
+  PlanCache(size_t capacity, double corridor_radius);
+
+  /**
+   * @brief Look up a plan for a request
+   * @param planner_id Planner the request is for
+   * @param start Start pose, in the costmap frame
+   * @param goal Goal pose, in the costmap frame
+   * @param costmap Costmap the plan would be computed on
+   * @param path Cached plan, if found
+   * @return true if a still valid plan was found
+   */
+  bool lookup(
+    const std::string & planner_id,
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal,
+    nav2_costmap_2d::Costmap2D * costmap,
+    nav_msgs::msg::Path & path);
+
+  /**
+   * @brief Store a freshly computed plan
+   * @param planner_id Planner the plan was computed with
+   * @param start Start pose, in the costmap frame
+   * @param goal Goal pose, in the costmap frame
+   * @param costmap Costmap the plan was computed on
+   * @param path The plan
+   */
+  void insert(
+    const std::string & planner_id,
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal,
+    nav2_costmap_2d::Costmap2D * costmap,
+    const nav_msgs::msg::Path & path);
+
+  /**
+   * @brief Drop all cached plans
+   */
+  void clear();
+
+protected:
+  struct Key
+  {
+    std::string planner_id;
+    unsigned int start_x, start_y, goal_x, goal_y;
+    int start_yaw;
+    geometry_msgs::msg::Quaternion goal_orientation;
+    // Geometry of the costmap the cells refer to
+    unsigned int size_x, size_y;
+    double resolution, origin_x, origin_y;
+
+    bool operator==(const Key & other) const;
+  };
+
+  // Cells [index, index + length) of one costmap row
+  struct Run
+  {
+    unsigned int index;
+    unsigned int length;
+  };
+
+  struct Entry
+  {
+    Key key;
+    // Costmap cells around the path, each cell in exactly one run
+    std::vector<Run> corridor;
+    uint64_t checksum;
+    nav_msgs::msg::Path path;
+  };
+
+  bool makeKey(
+    const std::string & planner_id,
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal,
+    nav2_costmap_2d::Costmap2D * costmap,
+    Key & key) const;
+
+  uint64_t checksum(
+    const std::vector<Run> & runs,
+    const nav2_costmap_2d::Costmap2D * costmap) const;
+
+  bool isPathFree(const nav_msgs::msg::Path & path, nav2_costmap_2d::Costmap2D * costmap) const;
+
+  size_t capacity_;
+  double corridor_radius_;
+  // Most recently used first
+  std::list<Entry> entries_;
+  std::mutex mutex_;
+};
+
+}  // namespace nav2_planner
+
+#endif  // NAV2_PLANNER__PLAN_CACHE_HPP_
@@ -38,6 +38,7 @@
 #include "pluginlib/class_loader.hpp"
 #include "pluginlib/class_list_macros.hpp"
 #include "nav2_core/global_planner.hpp"
+#include "nav2_planner/plan_cache.hpp"
 
 namespace nav2_planner
 {
@@ -75,6 +76,21 @@ public:
     const std::string & planner_id);
 
 protected:
+  /**
+   * @brief Plan one leg with the given planner instance, going through the
+   * plan cache when it is enabled
+   * @param planner Instance to plan with
+   * @param planner_id Name of the planner, used for logging and as cache key
+   * @param start starting pose
+   * @param goal goal request
+   * @return Path
+   */
+  nav_msgs::msg::Path planLeg(
+    const nav2_core::GlobalPlanner::Ptr & planner,
+    const std::string & planner_id,
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal);
+
   /**
    * @brief Configure member variables and initializes planner
    * @param state Reference to LifeCycle node state
@@ -214,6 +230,8 @@ protected:
 
   // Planner
   PlannerMap planners_;
+  // Recently computed plans, null when plan_cache_size is 0
+  std::unique_ptr<PlanCache> plan_cache_;
   pluginlib::ClassLoader<nav2_core::GlobalPlanner> gp_loader_;
   std::vector<std::string> default_ids_;
   std::vector<std::string> default_types_;
@@ -0,0 +1,232 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nav2_planner/plan_cache.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include "tf2/utils.h"
+#pragma GCC diagnostic pop
+
+namespace nav2_planner
+{
+
+namespace
+{
+
+// Start orientations within the same bin are considered equal
+constexpr int kYawBins = 16;
+
+int yawBin(const geometry_msgs::msg::Quaternion & orientation)
+{
+  const double yaw = tf2::getYaw(orientation);
+  const int bin = static_cast<int>(std::floor((yaw + M_PI) / (2.0 * M_PI) * kYawBins));
+  return std::clamp(bin, 0, kYawBins - 1);
+}
+
+}  // namespace
+
+bool PlanCache::Key::operator==(const Key & other) const
+{
+  return planner_id == other.planner_id &&
+         start_x == other.start_x && start_y == other.start_y &&
+         goal_x == other.goal_x && goal_y == other.goal_y &&
+         start_yaw == other.start_yaw && goal_orientation == other.goal_orientation &&
+         size_x == other.size_x && size_y == other.size_y &&
+         resolution == other.resolution &&
+         origin_x == other.origin_x && origin_y == other.origin_y;
+}
+
+PlanCache::PlanCache(size_t capacity, double corridor_radius)
+: capacity_(capacity),
+  corridor_radius_(corridor_radius)
+{
+}
+
+bool PlanCache::lookup(
+  const std::string & planner_id,
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal,
+  nav2_costmap_2d::Costmap2D * costmap,
+  nav_msgs::msg::Path & path)
+{
+  Key key;
+  if (!makeKey(planner_id, start, goal, costmap, key)) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto entry = std::find_if(
+    entries_.begin(), entries_.end(),
+    [&key](const Entry & e) {return e.key == key;});
+  if (entry == entries_.end()) {
+    return false;
+  }
+
+  {
+    std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> costmap_lock(*(costmap->getMutex()));
+    if (checksum(entry->corridor, costmap) != entry->checksum ||
+      !isPathFree(entry->path, costmap))
+    {
+      entries_.erase(entry);
+      return false;
+    }
+  }
+
+  // Move to the front as most recently used
+  entries_.splice(entries_.begin(), entries_, entry);
+  path = entry->path;
+  return true;
+}
+
+void PlanCache::insert(
+  const std::string & planner_id,
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal,
+  nav2_costmap_2d::Costmap2D * costmap,
+  const nav_msgs::msg::Path & path)
+{
+  if (capacity_ == 0 || path.poses.empty()) {
+    return;
+  }
+
+  Entry entry;
+  if (!makeKey(planner_id, start, goal, costmap, entry.key)) {
+    return;
+  }
+  entry.path = path;
+
+  // Cells within corridor_radius_ of any path pose, as runs along the rows.
+  // Consecutive poses mostly overlap, so their windows are merged into the
+  // last run of each row while walking the path.
+  const int radius = static_cast<int>(std::ceil(corridor_radius_ / costmap->getResolution()));
+  const int size_x = static_cast<int>(costmap->getSizeInCellsX());
+  const int size_y = static_cast<int>(costmap->getSizeInCellsY());
+  std::vector<std::vector<std::pair<int, int>>> rows(size_y);
+  for (const auto & pose : path.poses) {
+    int mx, my;
+    costmap->worldToMapEnforceBounds(pose.pose.position.x, pose.pose.position.y, mx, my);
+    const int x0 = std::max(0, mx - radius);
+    const int x1 = std::min(size_x - 1, mx + radius);
+    for (int y = std::max(0, my - radius); y <= std::min(size_y - 1, my + radius); ++y) {
+      auto & row = rows[y];
+      if (!row.empty() && x0 <= row.back().second + 1 && x1 >= row.back().first - 1) {
+        row.back().first = std::min(row.back().first, x0);
+        row.back().second = std::max(row.back().second, x1);
+      } else {
+        row.emplace_back(x0, x1);
+      }
+    }
+  }
+  for (int y = 0; y < size_y; ++y) {
+    auto & row = rows[y];
+    if (row.size() > 1) {
+      std::sort(row.begin(), row.end());
+    }
+    for (size_t i = 0; i < row.size(); ) {
+      int x0 = row[i].first;
+      int x1 = row[i].second;
+      for (++i; i < row.size() && row[i].first <= x1 + 1; ++i) {
+        x1 = std::max(x1, row[i].second);
+      }
+      entry.corridor.push_back(
+        {costmap->getIndex(x0, y), static_cast<unsigned int>(x1 - x0 + 1)});
+    }
+  }
+
+  {
+    std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> costmap_lock(*(costmap->getMutex()));
+    entry.checksum = checksum(entry.corridor, costmap);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.remove_if([&entry](const Entry & e) {return e.key == entry.key;});
+  entries_.push_front(std::move(entry));
+  while (entries_.size() > capacity_) {
+    entries_.pop_back();
+  }
+}
+
+void PlanCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+}
+
+bool PlanCache::makeKey(
+  const std::string & planner_id,
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal,
+  nav2_costmap_2d::Costmap2D * costmap,
+  Key & key) const
+{
+  if (!costmap->worldToMap(
+      start.pose.position.x, start.pose.position.y, key.start_x, key.start_y) ||
+    !costmap->worldToMap(goal.pose.position.x, goal.pose.position.y, key.goal_x, key.goal_y))
+  {
+    return false;
+  }
+
+  key.planner_id = planner_id;
+  key.start_yaw = yawBin(start.pose.orientation);
+  // The planners end the path with the goal orientation, or derive the last
+  // orientation from it, so a hit must be for exactly the same one
+  key.goal_orientation = goal.pose.orientation;
+  key.size_x = costmap->getSizeInCellsX();
+  key.size_y = costmap->getSizeInCellsY();
+  key.resolution = costmap->getResolution();
+  key.origin_x = costmap->getOriginX();
+  key.origin_y = costmap->getOriginY();
+  return true;
+}
+
+uint64_t PlanCache::checksum(
+  const std::vector<Run> & runs,
+  const nav2_costmap_2d::Costmap2D * costmap) const
+{
+  // FNV-1a over the costs of the cells
+  const unsigned char * charmap = costmap->getCharMap();
+  uint64_t hash = 14695981039346656037ULL;
+  for (const Run & run : runs) {
+    const unsigned char * cost = charmap + run.index;
+    for (unsigned int i = 0; i < run.length; ++i) {
+      hash ^= cost[i];
+      hash *= 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+bool PlanCache::isPathFree(
+  const nav_msgs::msg::Path & path,
+  nav2_costmap_2d::Costmap2D * costmap) const
+{
+  unsigned int mx, my;
+  for (const auto & pose : path.poses) {
+    if (!costmap->worldToMap(pose.pose.position.x, pose.pose.position.y, mx, my) ||
+      costmap->getCost(mx, my) == nav2_costmap_2d::LETHAL_OBSTACLE)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace nav2_planner
@@ -48,6 +48,8 @@ PlannerServer::PlannerServer()
   // Declare this node's parameters
   declare_parameter("planner_plugins", default_ids_);
   declare_parameter("expected_planner_frequency", 1.0);
+  declare_parameter("plan_cache_size", 0);
+  declare_parameter("plan_cache_corridor", 0.5);
 
   get_parameter("planner_plugins", planner_ids_);
   if (planner_ids_ == default_ids_) {
@@ -86,6 +88,14 @@ PlannerServer::on_configure(const rclcpp_lifecycle::State & state)
 
   planner_types_.resize(planner_ids_.size());
 
+  int plan_cache_size;
+  double plan_cache_corridor;
+  get_parameter("plan_cache_size", plan_cache_size);
+  get_parameter("plan_cache_corridor", plan_cache_corridor);
+  if (plan_cache_size > 0) {
+    plan_cache_ = std::make_unique<PlanCache>(plan_cache_size, plan_cache_corridor);
+  }
+
   auto node = shared_from_this();
 
   for (size_t i = 0; i != planner_ids_.size(); i++) {
@@ -210,6 +220,7 @@ PlannerServer::on_cleanup(const rclcpp_lifecycle::State & state)
     it->second->cleanup();
   }
   planners_.clear();
+  plan_cache_.reset();
   costmap_ = nullptr;
 
   return nav2_util::CallbackReturn::SUCCESS;
@@ -540,20 +551,15 @@ PlannerServer::getPlan(
   const geometry_msgs::msg::PoseStamped & goal,
   const std::string & planner_id)
 {
-  RCLCPP_DEBUG(
-    get_logger(), "%s attempting to a find path from (%.2f, %.2f) to "
-    "(%.2f, %.2f).", planner_id.c_str(), start.pose.position.x, start.pose.position.y,
-    goal.pose.position.x, goal.pose.position.y);
-
   if (planners_.find(planner_id) != planners_.end()) {
-    return planners_[planner_id]->createPlan(start, goal);
+    return planLeg(planners_[planner_id], planner_id, start, goal);
   } else {
     if (planners_.size() == 1 && planner_id.empty()) {
       RCLCPP_WARN_ONCE(
         get_logger(), "No planners specified in action call. "
         "Server will use only plugin %s in server."
         " This warning will appear once.", planner_ids_concat_.c_str());
-      return planners_[planners_.begin()->first]->createPlan(start, goal);
+      return planLeg(planners_.begin()->second, planners_.begin()->first, start, goal);
     } else {
       RCLCPP_ERROR(
         get_logger(), "planner %s is not a valid planner. "
@@ -565,6 +571,37 @@ PlannerServer::getPlan(
   return nav_msgs::msg::Path();
 }
 
+nav_msgs::msg::Path
+PlannerServer::planLeg(
+  const nav2_core::GlobalPlanner::Ptr & planner,
+  const std::string & planner_id,
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal)
+{
+  RCLCPP_DEBUG(
+    get_logger(), "%s attempting to a find path from (%.2f, %.2f) to "
+    "(%.2f, %.2f).", planner_id.c_str(), start.pose.position.x, start.pose.position.y,
+    goal.pose.position.x, goal.pose.position.y);
+
+  // Reuse a cached plan between the same cells while the costmap around it
+  // is unchanged
+  nav_msgs::msg::Path path;
+  if (plan_cache_ && plan_cache_->lookup(planner_id, start, goal, costmap_, path)) {
+    path.header.stamp = now();
+    for (auto & pose : path.poses) {
+      pose.header.stamp = path.header.stamp;
+    }
+    RCLCPP_DEBUG(get_logger(), "Using cached plan");
+    return path;
+  }
+
+  path = planner->createPlan(start, goal);
+  if (plan_cache_) {
+    plan_cache_->insert(planner_id, start, goal, costmap_, path);
+  }
+  return path;
+}
+
 nav_msgs::msg::Path
 PlannerServer::getPlan(
   const std::vector<geometry_msgs::msg::PoseStamped> & poses,
@@ -12,10 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <chrono>
 #include <ctime>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "back_up.hpp"
 #include "nav2_util/node_utils.hpp"
@@ -129,6 +131,8 @@ bool BackUp::isCollisionFree(
   const double diff_dist = abs(command_x_) - distance;
   const int max_cycle_count = static_cast<int>(cycle_frequency_ * simulate_ahead_time_);
   geometry_msgs::msg::Pose2D init_pose = pose2d;
+  std::vector<geometry_msgs::msg::Pose2D> sim_poses;
+  sim_poses.reserve(std::max(max_cycle_count, 0));
 
   while (cycle_count < max_cycle_count) {
     sim_position_change = cmd_vel->linear.x * (cycle_count / cycle_frequency_);
@@ -140,11 +144,11 @@ bool BackUp::isCollisionFree(
       break;
     }
 
-    if (!collision_checker_->isCollisionFree(pose2d)) {
-      return false;
-    }
+    sim_poses.push_back(pose2d);
   }
-  return true;
+
+  // Checked as one swept volume, the area covered by the motion is scanned once
+  return collision_checker_->isCollisionFree(sim_poses);
 }
 
 }  // namespace nav2_recoveries
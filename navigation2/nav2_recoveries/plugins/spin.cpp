@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "spin.hpp"
 #pragma GCC diagnostic push
@@ -158,6 +159,8 @@ bool Spin::isCollisionFree(
   double sim_position_change;
   const int max_cycle_count = static_cast<int>(cycle_frequency_ * simulate_ahead_time_);
   geometry_msgs::msg::Pose2D init_pose = pose2d;
+  std::vector<geometry_msgs::msg::Pose2D> sim_poses;
+  sim_poses.reserve(std::max(max_cycle_count, 0));
 
   while (cycle_count < max_cycle_count) {
     sim_position_change = cmd_vel->angular.z * (cycle_count / cycle_frequency_);
@@ -168,11 +171,11 @@ bool Spin::isCollisionFree(
       break;
     }
 
-    if (!collision_checker_->isCollisionFree(pose2d)) {
-      return false;
-    }
+    sim_poses.push_back(pose2d);
   }
-  return true;
+
+  // Checked as one swept volume, the area covered by the motion is scanned once
+  return collision_checker_->isCollisionFree(sim_poses);
 }
 
 }  // namespace nav2_recoveries
@@ -111,6 +111,12 @@ public:
 protected:
   /**
    * @brief Transforms global plan into same frame as pose, clips far away poses and possibly prunes passed poses
+   *
+   * The closest pose is searched forward from the one found on the previous
+   * cycle, over at most max_robot_pose_search_dist of path. The plan to robot
+   * transform is looked up once and applied to the cached plan arrays, so the
+   * cost of a cycle does not depend on the length of the plan.
+   *
    * @param pose pose to transform
    * @return Path in new frame
    */
@@ -259,8 +265,18 @@ protected:
   double rotate_to_heading_min_angle_;
   double goal_dist_tol_;
   bool allow_reversing_;
+  double max_robot_pose_search_dist_;
 
   nav_msgs::msg::Path global_plan_;
+  // Global plan as contiguous arrays, filled once in setPlan
+  std::vector<double> plan_x_;
+  std::vector<double> plan_y_;
+  std::vector<double> plan_yaw_;
+  // Indices of the cusps of the global plan, in increasing order
+  std::vector<size_t> plan_cusps_;
+  // Index of the plan pose closest to the robot on the last cycle, poses
+  // before it have been passed
+  size_t plan_index_{0};
   std::shared_ptr<rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::Path>> global_path_pub_;
   std::shared_ptr<rclcpp_lifecycle::LifecyclePublisher<geometry_msgs::msg::PointStamped>>
   carrot_pub_;
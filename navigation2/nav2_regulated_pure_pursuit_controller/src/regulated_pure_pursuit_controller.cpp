@@ -18,6 +18,7 @@
 #include <limits>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "nav2_regulated_pure_pursuit_controller/regulated_pure_pursuit_controller.hpp"
 #include "nav2_core/exceptions.hpp"
@@ -103,6 +104,8 @@ void RegulatedPurePursuitController::configure(
     node, plugin_name_ + ".max_angular_accel", rclcpp::ParameterValue(3.2));
   declare_parameter_if_not_declared(
     node, plugin_name_ + ".allow_reversing", rclcpp::ParameterValue(false));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".max_robot_pose_search_dist", rclcpp::ParameterValue(-1.0));
 
   node->get_parameter(plugin_name_ + ".desired_linear_vel", desired_linear_vel_);
   base_desired_linear_vel_ = desired_linear_vel_;
@@ -147,6 +150,7 @@ void RegulatedPurePursuitController::configure(
   node->get_parameter(plugin_name_ + ".rotate_to_heading_min_angle", rotate_to_heading_min_angle_);
   node->get_parameter(plugin_name_ + ".max_angular_accel", max_angular_accel_);
   node->get_parameter(plugin_name_ + ".allow_reversing", allow_reversing_);
+  node->get_parameter(plugin_name_ + ".max_robot_pose_search_dist", max_robot_pose_search_dist_);
   node->get_parameter("controller_frequency", control_frequency);
 
   transform_tolerance_ = tf2::durationFromSec(transform_tolerance);
@@ -528,6 +532,31 @@ void RegulatedPurePursuitController::applyConstraints(
 void RegulatedPurePursuitController::setPlan(const nav_msgs::msg::Path & path)
 {
   global_plan_ = path;
+
+  const size_t num_poses = global_plan_.poses.size();
+  plan_x_.resize(num_poses);
+  plan_y_.resize(num_poses);
+  plan_yaw_.resize(num_poses);
+  for (size_t i = 0; i < num_poses; ++i) {
+    plan_x_[i] = global_plan_.poses[i].pose.position.x;
+    plan_y_[i] = global_plan_.poses[i].pose.position.y;
+    plan_yaw_[i] = tf2::getYaw(global_plan_.poses[i].pose.orientation);
+  }
+
+  // A cusp is where the path doubles back, i.e. the dot product of the
+  // segments before and after a pose is negative
+  plan_cusps_.clear();
+  for (size_t i = 1; i + 1 < num_poses; ++i) {
+    double oa_x = plan_x_[i] - plan_x_[i - 1];
+    double oa_y = plan_y_[i] - plan_y_[i - 1];
+    double ab_x = plan_x_[i + 1] - plan_x_[i];
+    double ab_y = plan_y_[i + 1] - plan_y_[i];
+    if ((oa_x * ab_x) + (oa_y * ab_y) < 0.0) {
+      plan_cusps_.push_back(i);
+    }
+  }
+
+  plan_index_ = 0;
 }
 
 void RegulatedPurePursuitController::setSpeedLimit(
@@ -565,44 +594,75 @@ nav_msgs::msg::Path RegulatedPurePursuitController::transformGlobalPlan(
   nav2_costmap_2d::Costmap2D * costmap = costmap_ros_->getCostmap();
   const double max_costmap_dim = std::max(costmap->getSizeInCellsX(), costmap->getSizeInCellsY());
   const double max_transform_dist = max_costmap_dim * costmap->getResolution() / 2.0;
+  const double max_search_dist =
+    max_robot_pose_search_dist_ > 0.0 ? max_robot_pose_search_dist_ : max_transform_dist;
 
-  // First find the closest pose on the path to the robot
-  auto transformation_begin =
-    nav2_util::geometry_utils::min_by(
-    global_plan_.poses.begin(), global_plan_.poses.end(),
-    [&robot_pose](const geometry_msgs::msg::PoseStamped & ps) {
-      return euclidean_distance(robot_pose, ps);
-    });
+  const double robot_x = robot_pose.pose.position.x;
+  const double robot_y = robot_pose.pose.position.y;
+  auto distanceToRobot = [&](size_t i) {
+      return hypot(plan_x_[i] - robot_x, plan_y_[i] - robot_y);
+    };
+
+  // First find the closest pose on the path to the robot, searching forward
+  // from the last closest pose over a bounded length of path
+  size_t closest_index = plan_index_;
+  double closest_dist = distanceToRobot(closest_index);
+  double integrated_dist = 0.0;
+  for (size_t i = plan_index_ + 1; i < plan_x_.size(); ++i) {
+    integrated_dist += hypot(plan_x_[i] - plan_x_[i - 1], plan_y_[i] - plan_y_[i - 1]);
+    if (integrated_dist > max_search_dist) {
+      break;
+    }
+    const double dist = distanceToRobot(i);
+    if (dist < closest_dist) {
+      closest_dist = dist;
+      closest_index = i;
+    }
+  }
 
   // Find points definitely outside of the costmap so we won't transform them.
-  auto transformation_end = std::find_if(
-    transformation_begin, end(global_plan_.poses),
-    [&](const auto & global_plan_pose) {
-      return euclidean_distance(robot_pose, global_plan_pose) > max_transform_dist;
-    });
+  size_t end_index = closest_index;
+  while (end_index < plan_x_.size() && distanceToRobot(end_index) <= max_transform_dist) {
+    ++end_index;
+  }
 
-  // Lambda to transform a PoseStamped from global frame to local
-  auto transformGlobalPoseToLocal = [&](const auto & global_plan_pose) {
-      geometry_msgs::msg::PoseStamped stamped_pose, transformed_pose;
-      stamped_pose.header.frame_id = global_plan_.header.frame_id;
-      stamped_pose.header.stamp = robot_pose.header.stamp;
-      stamped_pose.pose = global_plan_pose.pose;
-      transformPose(costmap_ros_->getBaseFrameID(), stamped_pose, transformed_pose);
-      return transformed_pose;
-    };
+  // Look up the plan to robot transform once and apply it to every pose
+  const std::string & base_frame = costmap_ros_->getBaseFrameID();
+  double tf_x = 0.0, tf_y = 0.0, tf_yaw = 0.0;
+  if (global_plan_.header.frame_id != base_frame) {
+    try {
+      geometry_msgs::msg::TransformStamped transform = tf_->lookupTransform(
+        base_frame, global_plan_.header.frame_id,
+        tf2_ros::fromMsg(robot_pose.header.stamp), transform_tolerance_);
+      tf_x = transform.transform.translation.x;
+      tf_y = transform.transform.translation.y;
+      tf_yaw = tf2::getYaw(transform.transform.rotation);
+    } catch (tf2::TransformException & ex) {
+      RCLCPP_ERROR(logger_, "Exception in transformGlobalPlan: %s", ex.what());
+      throw nav2_core::PlannerException("Unable to transform global plan into robot's frame");
+    }
+  }
+  const double cos_yaw = cos(tf_yaw);
+  const double sin_yaw = sin(tf_yaw);
 
   // Transform the near part of the global plan into the robot's frame of reference.
   nav_msgs::msg::Path transformed_plan;
-  std::transform(
-    transformation_begin, transformation_end,
-    std::back_inserter(transformed_plan.poses),
-    transformGlobalPoseToLocal);
-  transformed_plan.header.frame_id = costmap_ros_->getBaseFrameID();
+  transformed_plan.header.frame_id = base_frame;
   transformed_plan.header.stamp = robot_pose.header.stamp;
+  transformed_plan.poses.resize(end_index - closest_index);
+  for (size_t i = closest_index; i < end_index; ++i) {
+    geometry_msgs::msg::PoseStamped & transformed_pose =
+      transformed_plan.poses[i - closest_index];
+    transformed_pose.header = transformed_plan.header;
+    transformed_pose.pose.position.x = tf_x + cos_yaw * plan_x_[i] - sin_yaw * plan_y_[i];
+    transformed_pose.pose.position.y = tf_y + sin_yaw * plan_x_[i] + cos_yaw * plan_y_[i];
+    transformed_pose.pose.orientation =
+      nav2_util::geometry_utils::orientationAroundZAxis(plan_yaw_[i] + tf_yaw);
+  }
 
-  // Remove the portion of the global plan that we've already passed so we don't
-  // process it on the next iteration (this is called path pruning)
-  global_plan_.poses.erase(begin(global_plan_.poses), transformation_begin);
+  // Remember how far along the plan we are so passed poses are not searched
+  // on the next iteration (this is called path pruning)
+  plan_index_ = closest_index;
   global_path_pub_->publish(transformed_plan);
 
   if (transformed_plan.poses.empty()) {
@@ -615,26 +675,14 @@ nav_msgs::msg::Path RegulatedPurePursuitController::transformGlobalPlan(
 double RegulatedPurePursuitController::findDirectionChange(
   const geometry_msgs::msg::PoseStamped & pose)
 {
-  // Iterating through the global path to determine the position of the cusp
-  for (unsigned int pose_id = 1; pose_id < global_plan_.poses.size() - 1; ++pose_id) {
-    // We have two vectors for the dot product OA and AB. Determining the vectors.
-    double oa_x = global_plan_.poses[pose_id].pose.position.x -
-      global_plan_.poses[pose_id - 1].pose.position.x;
-    double oa_y = global_plan_.poses[pose_id].pose.position.y -
-      global_plan_.poses[pose_id - 1].pose.position.y;
-    double ab_x = global_plan_.poses[pose_id + 1].pose.position.x -
-      global_plan_.poses[pose_id].pose.position.x;
-    double ab_y = global_plan_.poses[pose_id + 1].pose.position.y -
-      global_plan_.poses[pose_id].pose.position.y;
-
-    /* Checking for the existance of cusp, in the path, using the dot product
-    and determine it's distance from the robot. If there is no cusp in the path,
-    then just determine the distance to the goal location. */
-    if ( (oa_x * ab_x) + (oa_y * ab_y) < 0.0) {
-      auto x = global_plan_.poses[pose_id].pose.position.x - pose.pose.position.x;
-      auto y = global_plan_.poses[pose_id].pose.position.y - pose.pose.position.y;
-      return hypot(x, y);  // returning the distance if there is a cusp
-    }
+  /* The cusps were found in setPlan, take the first one past the pose the
+  robot is at and determine it's distance from the robot. If there is no cusp
+  left in the path, then there is no direction change. */
+  auto cusp = std::upper_bound(plan_cusps_.begin(), plan_cusps_.end(), plan_index_);
+  if (cusp != plan_cusps_.end()) {
+    auto x = plan_x_[*cusp] - pose.pose.position.x;
+    auto y = plan_y_[*cusp] - pose.pose.position.y;
+    return hypot(x, y);  // returning the distance if there is a cusp
   }
 
   return std::numeric_limits<double>::max();
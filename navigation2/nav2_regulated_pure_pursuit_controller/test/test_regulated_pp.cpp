@@ -98,6 +98,8 @@ public:
   {
     return findDirectionChange(pose);
   }
+
+  void setPlanIndex(size_t index) {plan_index_ = index;}
 };
 
 TEST(RegulatedPurePursuitTest, basicAPI)
@@ -170,6 +172,11 @@ TEST(RegulatedPurePursuitTest, findDirectionChange)
   auto rtn = ctrl->findDirectionChangeWrapper(pose);
   EXPECT_EQ(rtn, sqrt(5.0));
 
+  // The cusp has been passed
+  ctrl->setPlanIndex(1);
+  rtn = ctrl->findDirectionChangeWrapper(pose);
+  EXPECT_EQ(rtn, std::numeric_limits<double>::max());
+
   path.poses[2].pose.position.x = 3.0;
   path.poses[2].pose.position.y = 3.0;
   ctrl->setPlan(path);
@@ -0,0 +1,99 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_UTIL__PATH_PROGRESS_HPP_
+#define NAV2_UTIL__PATH_PROGRESS_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "builtin_interfaces/msg/time.hpp"
+#include "geometry_msgs/msg/pose.hpp"
+#include "nav_msgs/msg/path.hpp"
+
+namespace nav2_util
+{
+
+/**
+ * @class PathProgress
+ * Tracks the progress of the robot along a path.
+ * setPath() indexes the path once with its cumulative arc length; update()
+ * then only searches forward from the last closest segment, within a window
+ * of arc length, so the per-call cost does not grow with the path length.
+ */
+class PathProgress
+{
+public:
+  /**
+   * @brief Constructor
+   * @param search_window Arc length (m) past the last closest segment that
+   * update() searches, on top of the current distance to the path
+   */
+  explicit PathProgress(double search_window = 2.0);
+
+  /**
+   * @brief Index a new path and restart tracking
+   * @param path The path
+   */
+  void setPath(const nav_msgs::msg::Path & path);
+
+  /**
+   * @brief Whether a path with this stamp and number of poses is the indexed one
+   */
+  bool isSamePath(const builtin_interfaces::msg::Time & stamp, size_t size) const;
+
+  /**
+   * @brief Move the tracker to the segment closest to a pose
+   *
+   * The first call after setPath() searches the whole path, later calls only
+   * move forward.
+   * @param pose Robot pose, in the frame of the path
+   * @return Length of the path left after the projection of the pose
+   */
+  double update(const geometry_msgs::msg::Pose & pose);
+
+  /**
+   * @brief Index of the first pose of the closest segment
+   */
+  size_t getClosestIndex() const {return index_;}
+
+  /**
+   * @brief Total length of the path
+   */
+  double getLength() const {return cumulative_.empty() ? 0.0 : cumulative_.back();}
+
+  /**
+   * @brief Length of the path left after the last update()
+   */
+  double getRemainingLength() const {return getLength() - travelled_;}
+
+  /**
+   * @brief Whether a path with at least one pose is indexed
+   */
+  bool empty() const {return x_.empty();}
+
+protected:
+  double search_window_;
+  builtin_interfaces::msg::Time stamp_;
+  std::vector<double> x_, y_;
+  // cumulative_[i] is the arc length from the first pose to pose i
+  std::vector<double> cumulative_;
+  size_t index_{0};
+  double travelled_{0.0};
+  bool tracking_{false};
+};
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__PATH_PROGRESS_HPP_
@@ -0,0 +1,92 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "nav2_util/path_progress.hpp"
+
+namespace nav2_util
+{
+
+PathProgress::PathProgress(double search_window)
+: search_window_(search_window)
+{
+}
+
+void PathProgress::setPath(const nav_msgs::msg::Path & path)
+{
+  const size_t size = path.poses.size();
+  stamp_ = path.header.stamp;
+  x_.resize(size);
+  y_.resize(size);
+  cumulative_.resize(size);
+  for (size_t i = 0; i < size; ++i) {
+    x_[i] = path.poses[i].pose.position.x;
+    y_[i] = path.poses[i].pose.position.y;
+    cumulative_[i] = i == 0 ? 0.0 :
+      cumulative_[i - 1] + std::hypot(x_[i] - x_[i - 1], y_[i] - y_[i - 1]);
+  }
+  index_ = 0;
+  travelled_ = 0.0;
+  tracking_ = false;
+}
+
+bool PathProgress::isSamePath(const builtin_interfaces::msg::Time & stamp, size_t size) const
+{
+  return stamp == stamp_ && size == x_.size();
+}
+
+double PathProgress::update(const geometry_msgs::msg::Pose & pose)
+{
+  if (x_.size() < 2) {
+    return 0.0;
+  }
+
+  const double px = pose.position.x;
+  const double py = pose.position.y;
+  const size_t last_segment = x_.size() - 2;
+  double best_dist = std::numeric_limits<double>::max();
+  size_t best_segment = index_;
+  double best_along = travelled_;
+
+  for (size_t k = tracking_ ? index_ : 0; k <= last_segment; ++k) {
+    // The path may come back towards the robot, so keep looking a bit past
+    // the point where the segments start getting further away
+    if (tracking_ && cumulative_[k] > cumulative_[index_] + search_window_ + best_dist) {
+      break;
+    }
+    const double dx = x_[k + 1] - x_[k];
+    const double dy = y_[k + 1] - y_[k];
+    const double length_sq = dx * dx + dy * dy;
+    double t = 0.0;
+    if (length_sq > 0.0) {
+      t = std::clamp(((px - x_[k]) * dx + (py - y_[k]) * dy) / length_sq, 0.0, 1.0);
+    }
+    const double dist = std::hypot(px - (x_[k] + t * dx), py - (y_[k] + t * dy));
+    if (dist < best_dist) {
+      best_dist = dist;
+      best_segment = k;
+      best_along = cumulative_[k] + t * (cumulative_[k + 1] - cumulative_[k]);
+    }
+  }
+
+  tracking_ = true;
+  index_ = best_segment;
+  travelled_ = best_along;
+  return getRemainingLength();
+}
+
+}  // namespace nav2_util
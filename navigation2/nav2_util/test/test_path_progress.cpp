@@ -0,0 +1,122 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_util/path_progress.hpp"
+#include "nav2_util/geometry_utils.hpp"
+#include "geometry_msgs/msg/pose.hpp"
+#include "nav_msgs/msg/path.hpp"
+#include "gtest/gtest.h"
+
+using nav2_util::PathProgress;
+
+namespace
+{
+
+nav_msgs::msg::Path makePath(const std::vector<std::pair<double, double>> & points)
+{
+  nav_msgs::msg::Path path;
+  for (auto & point : points) {
+    geometry_msgs::msg::PoseStamped pose;
+    pose.pose.position.x = point.first;
+    pose.pose.position.y = point.second;
+    path.poses.push_back(pose);
+  }
+  return path;
+}
+
+geometry_msgs::msg::Pose makePose(double x, double y)
+{
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = x;
+  pose.position.y = y;
+  return pose;
+}
+
+}  // namespace
+
+TEST(PathProgress, straight_line)
+{
+  std::vector<std::pair<double, double>> points;
+  for (int i = 0; i <= 100; ++i) {
+    points.emplace_back(0.1 * i, 0.0);
+  }
+  auto path = makePath(points);
+
+  PathProgress progress;
+  progress.setPath(path);
+  EXPECT_NEAR(progress.getLength(), 10.0, 1e-9);
+  EXPECT_NEAR(progress.update(makePose(0.0, 0.0)), 10.0, 1e-9);
+  EXPECT_NEAR(progress.update(makePose(1.5, 0.3)), 8.5, 1e-9);
+  EXPECT_NEAR(progress.update(makePose(2.55, 0.3)), 7.45, 1e-9);
+  EXPECT_EQ(progress.getClosestIndex(), 25u);
+  // Matches the pose based length up to the projection on the segment
+  EXPECT_NEAR(
+    progress.getRemainingLength(),
+    nav2_util::geometry_utils::calculate_path_length(path, 25) - 0.05, 1e-9);
+
+  // Jumps further than the search window are followed over several updates
+  progress.update(makePose(11.0, 0.0));
+  progress.update(makePose(11.0, 0.0));
+  progress.update(makePose(11.0, 0.0));
+  EXPECT_NEAR(progress.update(makePose(11.0, 0.0)), 0.0, 1e-9);
+}
+
+TEST(PathProgress, only_moves_forward)
+{
+  // Out along y = 0 and back along y = 0.2
+  std::vector<std::pair<double, double>> points;
+  for (int i = 0; i <= 50; ++i) {
+    points.emplace_back(0.1 * i, 0.0);
+  }
+  for (int i = 50; i >= 0; --i) {
+    points.emplace_back(0.1 * i, 0.2);
+  }
+  PathProgress progress;
+  progress.setPath(makePath(points));
+  const double length = progress.getLength();
+
+  // On the way out the tracker stays on the first leg even though the
+  // returning leg is as close
+  for (int i = 0; i <= 40; ++i) {
+    progress.update(makePose(0.1 * i, 0.1));
+  }
+  EXPECT_NEAR(progress.getRemainingLength(), length - 4.0, 1e-9);
+  // Once on the returning leg it does not go back to the first one
+  for (int i = 41; i <= 50; ++i) {
+    progress.update(makePose(0.1 * i, 0.1));
+  }
+  for (int i = 50; i >= 10; --i) {
+    progress.update(makePose(0.1 * i, 0.1));
+  }
+  EXPECT_NEAR(progress.getRemainingLength(), 1.0, 1e-9);
+}
+
+TEST(PathProgress, new_path_restarts_tracking)
+{
+  PathProgress progress;
+  auto path = makePath({{0.0, 0.0}, {1.0, 0.0}, {2.0, 0.0}});
+  path.header.stamp.sec = 1;
+  progress.setPath(path);
+  EXPECT_NEAR(progress.update(makePose(1.8, 0.0)), 0.2, 1e-9);
+  EXPECT_TRUE(progress.isSamePath(path.header.stamp, 3));
+
+  path = makePath({{2.0, 0.0}, {1.0, 0.0}, {0.0, 0.0}});
+  path.header.stamp.sec = 2;
+  EXPECT_FALSE(progress.isSamePath(path.header.stamp, 3));
+  progress.setPath(path);
+  EXPECT_NEAR(progress.update(makePose(1.8, 0.0)), 1.8, 1e-9);
+
+  progress.setPath(makePath({{1.0, 1.0}}));
+  EXPECT_NEAR(progress.update(makePose(0.0, 0.0)), 0.0, 1e-9);
+}
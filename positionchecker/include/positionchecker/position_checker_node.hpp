@@ -25,6 +25,7 @@
 #include "rclcpp/rclcpp.hpp"
 #include "std_srvs/srv/set_bool.hpp"
 #include "std_msgs/msg/bool.hpp"
+#include "tf2_msgs/msg/tf_message.hpp"
 #include "tf2_ros/buffer.h"
 #include "tf2_ros/create_timer_ros.h"
 #include "tf2_ros/transform_listener.h"
@@ -44,6 +45,12 @@ private:
   std::shared_ptr<tf2_ros::Buffer> tf_buffer_;
   std::shared_ptr<tf2_ros::TransformListener> tf_listener_;
   void loop();
+  /**
+   * @brief Event driven mode: publish the pose when a transform that it is
+   * composed of is received, at most max_publish_rate and only if it moved
+   */
+  void HandleTransformCallback(const tf2_msgs::msg::TFMessage::SharedPtr msg);
+  bool PoseChanged(const geometry_msgs::msg::PoseStamped & pose) const;
   bool looping_;
   std::shared_ptr<std::thread> loop_thread_;
   rclcpp::Service<SetBool>::SharedPtr enable_service;
@@ -53,6 +60,19 @@ private:
     std::shared_ptr<SetBool::Response> response);
   rclcpp::Publisher<geometry_msgs::msg::PoseStamped>::SharedPtr pos_pub_;
   rclcpp::Subscription<std_msgs::msg::Bool>::SharedPtr enable_sub_ {nullptr};
+  rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr tf_sub_ {nullptr};
+
+  // Parameters
+  bool event_driven_;
+  std::string global_frame_;
+  std::string robot_base_frame_;
+  rclcpp::Duration min_publish_period_ {0, 0};
+  double min_translation_;
+  double min_rotation_;
+
+  geometry_msgs::msg::PoseStamped last_pose_;
+  rclcpp::Time last_publish_time_;
+  bool pose_published_ {false};
 };
 }  // namespace CYBERDOG_NAV
 
@@ -23,6 +23,8 @@
 
 #include "positionchecker/position_checker_node.hpp"
 #include "cyberdog_common/cyberdog_log.hpp"
+#include "tf2/LinearMath/Quaternion.h"
+#include "tf2_ros/qos.hpp"
 
 using namespace std::chrono_literals;
 namespace CYBERDOG_NAV
@@ -38,6 +40,15 @@ PositionChecker::PositionChecker()
   tf_buffer_->setUsingDedicatedThread(true);
   tf_listener_ = std::make_shared<tf2_ros::TransformListener>(*tf_buffer_);
 
+  event_driven_ = declare_parameter("event_driven", false);
+  global_frame_ = declare_parameter("global_frame", std::string("map"));
+  robot_base_frame_ = declare_parameter("robot_base_frame", std::string("base_link"));
+  double max_publish_rate = declare_parameter("max_publish_rate", 20.0);
+  min_translation_ = declare_parameter("min_translation", 0.01);
+  min_rotation_ = declare_parameter("min_rotation", 0.01);
+  min_publish_period_ = rclcpp::Duration::from_seconds(
+    max_publish_rate > 0.0 ? 1.0 / max_publish_rate : 0.0);
+
   enable_service = create_service<SetBool>(
     "PoseEnable",
     std::bind(
@@ -50,6 +61,14 @@ PositionChecker::PositionChecker()
 
   pos_pub_ = create_publisher<geometry_msgs::msg::PoseStamped>(
     "dog_pose", rclcpp::SystemDefaultsQoS());
+
+  if (event_driven_) {
+    // The listener fills the buffer from the same topic, this subscription
+    // only tells when the composed pose may have changed
+    tf_sub_ = create_subscription<tf2_msgs::msg::TFMessage>(
+      "tf", tf2_ros::DynamicListenerQoS(),
+      std::bind(&PositionChecker::HandleTransformCallback, this, std::placeholders::_1));
+  }
 }
 
 PositionChecker::~PositionChecker() {}
@@ -57,7 +76,6 @@ PositionChecker::~PositionChecker() {}
 void PositionChecker::loop()
 {
   geometry_msgs::msg::PoseStamped pose_based_on_global_frame;
-  std::string global_frame_, robot_base_frame_;
 
   while (true) {
     if (!looping_) {
@@ -66,7 +84,7 @@ void PositionChecker::loop()
 
     if (!nav2_util::getCurrentPose(
         pose_based_on_global_frame, *tf_buffer_,
-        "map", "base_link", 2.0))
+        global_frame_, robot_base_frame_, 2.0))
     {
       WARN("Failed to obtain current pose based on map coordinate system.");
       std::this_thread::sleep_for(std::chrono::seconds(5));
@@ -86,19 +104,91 @@ void PositionChecker::serviceCallback(
   INFO("PositionChecker receive service call.");
   if (request->data == true && !looping_) {
     looping_ = true;
+    pose_published_ = false;
     INFO("Request start report robot's realtime pose.");
-    loop_thread_ = std::make_shared<std::thread>(&PositionChecker::loop, this);
+    if (!event_driven_) {
+      loop_thread_ = std::make_shared<std::thread>(&PositionChecker::loop, this);
+    }
   } else if (request->data == false) {
     INFO("Request stop report robot's realtime pose.");
     looping_ = false;
-    loop_thread_->join();
+    if (loop_thread_ && loop_thread_->joinable()) {
+      loop_thread_->join();
+    }
   }
   response->success = true;
 }
 
 void PositionChecker::HandleTriggerCallback(const std_msgs::msg::Bool::SharedPtr msg)
 {
+  if (msg->data && !looping_) {
+    pose_published_ = false;
+  }
   looping_ = msg->data;
 }
 
+void PositionChecker::HandleTransformCallback(const tf2_msgs::msg::TFMessage::SharedPtr msg)
+{
+  if (!looping_) {
+    return;
+  }
+
+  // Only global_frame -> X -> robot_base_frame chains, such as map -> odom
+  // -> base_link, are watched
+  bool pose_input = false;
+  for (const auto & transform : msg->transforms) {
+    if (transform.child_frame_id == robot_base_frame_ ||
+      transform.header.frame_id == global_frame_)
+    {
+      pose_input = true;
+      break;
+    }
+  }
+  if (!pose_input) {
+    return;
+  }
+
+  auto current_time = now();
+  if (pose_published_ && current_time - last_publish_time_ < min_publish_period_) {
+    return;
+  }
+
+  geometry_msgs::msg::TransformStamped transform;
+  try {
+    transform = tf_buffer_->lookupTransform(
+      global_frame_, robot_base_frame_, tf2::TimePointZero);
+  } catch (tf2::TransformException &) {
+    return;
+  }
+
+  geometry_msgs::msg::PoseStamped pose;
+  pose.header = transform.header;
+  pose.pose.position.x = transform.transform.translation.x;
+  pose.pose.position.y = transform.transform.translation.y;
+  pose.pose.position.z = transform.transform.translation.z;
+  pose.pose.orientation = transform.transform.rotation;
+  if (pose_published_ && !PoseChanged(pose)) {
+    return;
+  }
+
+  pos_pub_->publish(pose);
+  last_pose_ = pose;
+  last_publish_time_ = current_time;
+  pose_published_ = true;
+}
+
+bool PositionChecker::PoseChanged(const geometry_msgs::msg::PoseStamped & pose) const
+{
+  const double dx = pose.pose.position.x - last_pose_.pose.position.x;
+  const double dy = pose.pose.position.y - last_pose_.pose.position.y;
+  const double dz = pose.pose.position.z - last_pose_.pose.position.z;
+  if (dx * dx + dy * dy + dz * dz >= min_translation_ * min_translation_) {
+    return true;
+  }
+  const auto & q = pose.pose.orientation;
+  const auto & last_q = last_pose_.pose.orientation;
+  return tf2::Quaternion(q.x, q.y, q.z, q.w).angleShortestPath(
+    tf2::Quaternion(last_q.x, last_q.y, last_q.z, last_q.w)) >= min_rotation_;
+}
+
 }  // namespace CYBERDOG_NAV
@@ -0,0 +1,124 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VELOCITY_ADAPTOR__TWIST_RING_FILTER_HPP_
+#define VELOCITY_ADAPTOR__TWIST_RING_FILTER_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cyberdog
+{
+
+namespace navigation
+{
+
+/**
+ * @brief Moving average of planar velocities over a time window, kept in a
+ * fixed capacity ring buffer so that no memory is allocated per sample
+ */
+class TwistRingFilter
+{
+public:
+  /**
+   * @brief Construct a new Twist Ring Filter object
+   *
+   * @param capacity Maximum number of samples, the oldest one is dropped when full
+   * @param window_ns Samples older than this, relative to the newest one, are dropped
+   */
+  TwistRingFilter(size_t capacity, int64_t window_ns)
+  : samples_(std::max<size_t>(capacity, 1)), window_ns_(window_ns)
+  {
+  }
+
+  /**
+   * @brief Add a sample and drop the ones that fell out of the window
+   *
+   * @param stamp_ns Time of the sample in nanoseconds
+   */
+  void Add(int64_t stamp_ns, double vx, double vy, double wz)
+  {
+    while (size_ > 0 && stamp_ns - samples_[head_].stamp_ns > window_ns_) {
+      PopOldest();
+    }
+    if (size_ == samples_.size()) {
+      PopOldest();
+    }
+    Sample & sample = samples_[(head_ + size_) % samples_.size()];
+    sample = Sample{stamp_ns, vx, vy, wz};
+    ++size_;
+    sum_vx_ += vx;
+    sum_vy_ += vy;
+    sum_wz_ += wz;
+  }
+
+  /**
+   * @brief Average of the samples in the window, zero if there is none
+   */
+  void Average(double & vx, double & vy, double & wz) const
+  {
+    if (size_ == 0) {
+      vx = vy = wz = 0.0;
+      return;
+    }
+    vx = sum_vx_ / size_;
+    vy = sum_vy_ / size_;
+    wz = sum_wz_ / size_;
+  }
+
+  size_t Size() const
+  {
+    return size_;
+  }
+
+  void Clear()
+  {
+    head_ = size_ = 0;
+    sum_vx_ = sum_vy_ = sum_wz_ = 0.0;
+  }
+
+private:
+  struct Sample
+  {
+    int64_t stamp_ns;
+    double vx;
+    double vy;
+    double wz;
+  };
+
+  void PopOldest()
+  {
+    const Sample & oldest = samples_[head_];
+    sum_vx_ -= oldest.vx;
+    sum_vy_ -= oldest.vy;
+    sum_wz_ -= oldest.wz;
+    head_ = (head_ + 1) % samples_.size();
+    --size_;
+  }
+
+  std::vector<Sample> samples_;
+  int64_t window_ns_;
+  size_t head_{0};
+  size_t size_{0};
+  double sum_vx_{0.0};
+  double sum_vy_{0.0};
+  double sum_wz_{0.0};
+};
+
+}  // namespace navigation
+}  // namespace cyberdog
+
+#endif  // VELOCITY_ADAPTOR__TWIST_RING_FILTER_HPP_
@@ -19,7 +19,6 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include <deque>
 #include "rclcpp/rclcpp.hpp"
 #include "std_msgs/msg/bool.hpp"
 #include "std_msgs/msg/int32.hpp"
@@ -30,6 +29,7 @@
 #include "protocol/msg/motion_servo_response.hpp"
 #include "protocol/srv/motion_result_cmd.hpp"
 #include "cyberdog_common/cyberdog_log.hpp"
+#include "velocity_adaptor/twist_ring_filter.hpp"
 
 namespace cyberdog
 {
@@ -54,11 +54,32 @@ private:
   void HandleNavCommandVelocity(geometry_msgs::msg::Twist::SharedPtr msg);
 
   /**
-   * @brief
+   * @brief Republish the latest cmd_vel at publish_rate, so that the motion
+   * controller gets evenly spaced commands whatever the cmd_vel jitter is
+   */
+  void HandlePublishTimer();
+
+  /**
+   * @brief Smooth a velocity command and publish it as a servo command
    *
-   * @param msg
+   * @param twist Velocity command
+   * @param stamp Time of the command
    */
-  void PublishCommandVelocity(geometry_msgs::msg::Twist::SharedPtr msg);
+  void PublishCommandVelocity(
+    const geometry_msgs::msg::Twist & twist,
+    const rclcpp::Time & stamp);
+
+  /**
+   * @brief Fill a servo command with a velocity and the current gait
+   *
+   * @param command
+   * @param vx
+   * @param vy
+   * @param wz
+   */
+  void FillCommand(
+    ::protocol::msg::MotionServoCmd & command,
+    double vx, double vy, double wz);
 
   /**
    * @brief
@@ -73,6 +94,7 @@ private:
   rclcpp::Subscription<geometry_msgs::msg::Twist>::SharedPtr nav_cmd_vel_sub_ {nullptr};
   rclcpp::Publisher<::protocol::msg::MotionServoCmd>::SharedPtr motion_vel_cmd_pub_ {nullptr};
   rclcpp::Service<MotionResultSrv>::SharedPtr change_gait_srv_ {nullptr};
+  rclcpp::TimerBase::SharedPtr publish_timer_ {nullptr};
 
   int32_t gait_motion_id;
   int32_t gait_shape_value;
@@ -80,9 +102,17 @@ private:
   std::vector<float> gait_step_height;
 
   bool stop_vel_occur_;
-  geometry_msgs::msg::Twist twist_cumulate_;
   rclcpp::Duration twist_history_duration_;
-  std::deque<geometry_msgs::msg::TwistStamped> twist_history_;
+  TwistRingFilter twist_filter_;
+  // Reused for every command published without a loaned message
+  ::protocol::msg::MotionServoCmd command_;
+
+  // Publishing at a fixed rate, disabled if not positive
+  double publish_rate_ {0.0};
+  rclcpp::Duration cmd_vel_timeout_ {0, 0};
+  geometry_msgs::msg::Twist latest_cmd_vel_;
+  rclcpp::Time latest_cmd_vel_time_;
+  bool cmd_vel_received_ {false};
 };
 
 }  // namespace navigation
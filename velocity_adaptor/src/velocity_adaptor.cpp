@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
+#include <cmath>
+#include <utility>
 #include <vector>
 
 #include "velocity_adaptor/velocity_adaptor.hpp"
@@ -22,11 +25,35 @@ namespace cyberdog
 namespace navigation
 {
 
+namespace
+{
+// Samples kept by the moving average when cmd_vel drives the publishing
+constexpr size_t kEventFilterCapacity = 64;
+}  // namespace
+
 VelocityAdaptor::VelocityAdaptor()
 : Node("velocity_adaptor"), gait_motion_id(309),
   gait_shape_value(0), gait_step_height({0.06, 0.06}),
-  twist_history_duration_(rclcpp::Duration::from_seconds(0.25))
+  twist_history_duration_(rclcpp::Duration::from_seconds(0.25)),
+  twist_filter_(kEventFilterCapacity, twist_history_duration_.nanoseconds())
 {
+  publish_rate_ = this->declare_parameter("publish_rate", 0.0);
+  double smoothing_duration = this->declare_parameter(
+    "smoothing_duration", twist_history_duration_.seconds());
+  double cmd_vel_timeout = this->declare_parameter("cmd_vel_timeout", 0.5);
+  twist_history_duration_ = rclcpp::Duration::from_seconds(smoothing_duration);
+  cmd_vel_timeout_ = rclcpp::Duration::from_seconds(cmd_vel_timeout);
+
+  size_t filter_capacity = kEventFilterCapacity;
+  if (publish_rate_ > 0.0) {
+    // One sample per tick, the window bounds the number of samples
+    filter_capacity = static_cast<size_t>(std::ceil(smoothing_duration * publish_rate_)) + 1;
+  }
+  twist_filter_ = TwistRingFilter(filter_capacity, twist_history_duration_.nanoseconds());
+
+  command_.cmd_source = 4;
+  command_.vel_des.resize(3, 0.0f);
+
   motion_vel_cmd_pub_ = this->create_publisher<::protocol::msg::MotionServoCmd>(
     "motion_servo_cmd", rclcpp::SystemDefaultsQoS());
 
@@ -39,12 +66,14 @@ VelocityAdaptor::VelocityAdaptor()
     std::bind(
       &VelocityAdaptor::VelocityAdaptorGaitCallback, this, std::placeholders::_1,
       std::placeholders::_2));
-  twist_cumulate_.linear.x = 0;
-  twist_cumulate_.linear.y = 0;
-  twist_cumulate_.linear.z = 0;
-  twist_cumulate_.angular.x = 0;
-  twist_cumulate_.angular.y = 0;
-  twist_cumulate_.angular.z = 0;
+
+  if (publish_rate_ > 0.0) {
+    INFO("VelocityAdaptor publishes servo commands at %f Hz.", publish_rate_);
+    publish_timer_ = this->create_wall_timer(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(1.0 / publish_rate_)),
+      std::bind(&VelocityAdaptor::HandlePublishTimer, this));
+  }
   stop_vel_occur_ = false;
 }
 
@@ -58,7 +87,27 @@ void VelocityAdaptor::HandleNavCommandVelocity(geometry_msgs::msg::Twist::Shared
     INFO("VelocityAdaptor cmd vel == nullptr.");
     return;
   }
-  PublishCommandVelocity(msg);
+  if (publish_timer_) {
+    // Resampled by HandlePublishTimer
+    latest_cmd_vel_ = *msg;
+    latest_cmd_vel_time_ = now();
+    cmd_vel_received_ = true;
+    return;
+  }
+  PublishCommandVelocity(*msg, now());
+}
+
+void VelocityAdaptor::HandlePublishTimer()
+{
+  if (!cmd_vel_received_) {
+    return;
+  }
+  auto current_time = now();
+  if (current_time - latest_cmd_vel_time_ > cmd_vel_timeout_) {
+    // cmd_vel stopped, stop the robot instead of holding the last command
+    latest_cmd_vel_ = geometry_msgs::msg::Twist();
+  }
+  PublishCommandVelocity(latest_cmd_vel_, current_time);
 }
 
 void VelocityAdaptor::VelocityAdaptorGaitCallback(
@@ -74,70 +123,47 @@ void VelocityAdaptor::VelocityAdaptorGaitCallback(
   response->motion_id = request->motion_id;
 }
 
-void VelocityAdaptor::PublishCommandVelocity(geometry_msgs::msg::Twist::SharedPtr msg)
+void VelocityAdaptor::PublishCommandVelocity(
+  const geometry_msgs::msg::Twist & twist,
+  const rclcpp::Time & stamp)
 {
-  std::vector<float> vel_des;
-  if (fabs(msg->linear.x) < 5e-3 &&
-    fabs(msg->linear.y) < 5e-3 &&
-    fabs(msg->angular.z) < 5e-3)
+  double vx = 0.0, vy = 0.0, wz = 0.0;
+  if (fabs(twist.linear.x) < 5e-3 &&
+    fabs(twist.linear.y) < 5e-3 &&
+    fabs(twist.angular.z) < 5e-3)
   {
-    if (!stop_vel_occur_) {
-      stop_vel_occur_ = true;
-      vel_des = std::vector<float> {
-        static_cast<float>(0.0),
-        static_cast<float>(0.0),
-        static_cast<float>(0.0)
-      };
-    } else {
+    if (stop_vel_occur_) {
       return;
     }
+    stop_vel_occur_ = true;
   } else {
     stop_vel_occur_ = false;
-    geometry_msgs::msg::TwistStamped twist_stamp;
-    auto current_time = now();
-    twist_stamp.header.stamp = current_time;
-    if (!twist_history_.empty()) {
-      auto front_time = rclcpp::Time(twist_history_.front().header.stamp);
-
-      while (current_time - front_time > twist_history_duration_) {
-        const auto & front_twist = twist_history_.front();
-        twist_cumulate_.linear.x -= front_twist.twist.linear.x;
-        twist_cumulate_.linear.y -= front_twist.twist.linear.y;
-        twist_cumulate_.angular.z -= front_twist.twist.angular.z;
-        twist_history_.pop_front();
-
-        if (twist_history_.empty()) {
-          break;
-        }
-
-        front_time = rclcpp::Time(twist_history_.front().header.stamp);
-      }
-    }
-    twist_stamp.twist.linear.x = msg->linear.x;
-    twist_stamp.twist.linear.y = msg->linear.y;
-    twist_stamp.twist.angular.z = msg->angular.z;
-
-    twist_history_.push_back(twist_stamp);
-
-    const auto & back_twist = twist_history_.back();
-    twist_cumulate_.linear.x += back_twist.twist.linear.x;
-    twist_cumulate_.linear.y += back_twist.twist.linear.y;
-    twist_cumulate_.angular.z += back_twist.twist.angular.z;
-
-    vel_des = std::vector<float> {
-      static_cast<float>(twist_cumulate_.linear.x / twist_history_.size()),
-      static_cast<float>(twist_cumulate_.linear.y / twist_history_.size()),
-      static_cast<float>(twist_cumulate_.angular.z / twist_history_.size())
-    };
+    twist_filter_.Add(stamp.nanoseconds(), twist.linear.x, twist.linear.y, twist.angular.z);
+    twist_filter_.Average(vx, vy, wz);
   }
 
-  ::protocol::msg::MotionServoCmd command;
+  if (motion_vel_cmd_pub_->can_loan_messages()) {
+    auto loaned = motion_vel_cmd_pub_->borrow_loaned_message();
+    FillCommand(loaned.get(), vx, vy, wz);
+    motion_vel_cmd_pub_->publish(std::move(loaned));
+  } else {
+    FillCommand(command_, vx, vy, wz);
+    motion_vel_cmd_pub_->publish(command_);
+  }
+}
+
+void VelocityAdaptor::FillCommand(
+  ::protocol::msg::MotionServoCmd & command,
+  double vx, double vy, double wz)
+{
   command.cmd_source = 4;
   command.motion_id = gait_motion_id;
-  command.vel_des = vel_des;
+  command.vel_des.resize(3);
+  command.vel_des[0] = static_cast<float>(vx);
+  command.vel_des[1] = static_cast<float>(vy);
+  command.vel_des[2] = static_cast<float>(wz);
   command.value = gait_shape_value;
   command.step_height = gait_step_height;
-  motion_vel_cmd_pub_->publish(command);
 }
 
 }  // namespace navigation
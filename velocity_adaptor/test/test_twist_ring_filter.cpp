@@ -0,0 +1,141 @@
+// Copyright (c) 2023 Beijing Xiaomi Mobile Software Co., Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <random>
+
+#include "velocity_adaptor/twist_ring_filter.hpp"
+
+using cyberdog::navigation::TwistRingFilter;
+
+namespace
+{
+constexpr int64_t kMs = 1000000;
+
+struct Twist
+{
+  int64_t stamp_ns;
+  double vx;
+  double vy;
+  double wz;
+};
+
+void ExpectAverage(const TwistRingFilter & filter, double vx, double vy, double wz)
+{
+  double average_vx, average_vy, average_wz;
+  filter.Average(average_vx, average_vy, average_wz);
+  EXPECT_NEAR(average_vx, vx, 1e-9);
+  EXPECT_NEAR(average_vy, vy, 1e-9);
+  EXPECT_NEAR(average_wz, wz, 1e-9);
+}
+}  // namespace
+
+TEST(TwistRingFilter, EmptyIsZero)
+{
+  TwistRingFilter filter(4, 100 * kMs);
+  EXPECT_EQ(filter.Size(), 0u);
+  ExpectAverage(filter, 0.0, 0.0, 0.0);
+}
+
+TEST(TwistRingFilter, WrapsAroundWhenFull)
+{
+  // The window is long enough that only the capacity drops samples
+  TwistRingFilter filter(3, 1000 * kMs);
+  filter.Add(0, 1.0, 10.0, -1.0);
+  filter.Add(1 * kMs, 2.0, 20.0, -2.0);
+  ExpectAverage(filter, 1.5, 15.0, -1.5);
+
+  // The ring goes around twice, the average is the one of the last 3 samples
+  for (int i = 3; i <= 8; ++i) {
+    filter.Add(i * kMs, i, 10.0 * i, -i);
+    EXPECT_EQ(filter.Size(), 3u);
+    ExpectAverage(filter, i - 1.0, 10.0 * (i - 1), 1.0 - i);
+  }
+}
+
+TEST(TwistRingFilter, DropsSamplesOutOfWindow)
+{
+  TwistRingFilter filter(10, 100 * kMs);
+  filter.Add(0, 1.0, 0.0, 0.0);
+  filter.Add(50 * kMs, 3.0, 0.0, 0.0);
+  // Exactly one window after the first sample, which is kept
+  filter.Add(100 * kMs, 5.0, 0.0, 0.0);
+  EXPECT_EQ(filter.Size(), 3u);
+  ExpectAverage(filter, 3.0, 0.0, 0.0);
+
+  filter.Add(120 * kMs, 7.0, 0.0, 0.0);
+  EXPECT_EQ(filter.Size(), 3u);
+  ExpectAverage(filter, 5.0, 0.0, 0.0);
+
+  // A gap longer than the window leaves only the new sample
+  filter.Add(500 * kMs, 0.5, -0.5, 0.25);
+  EXPECT_EQ(filter.Size(), 1u);
+  ExpectAverage(filter, 0.5, -0.5, 0.25);
+}
+
+TEST(TwistRingFilter, MatchesBruteForce)
+{
+  std::mt19937 generator(7);
+  std::uniform_int_distribution<int64_t> step(0, 40 * kMs);
+  std::uniform_real_distribution<double> velocity(-1.0, 1.0);
+  for (size_t capacity : {1, 2, 5, 16}) {
+    TwistRingFilter filter(capacity, 100 * kMs);
+    std::deque<Twist> window;
+    int64_t stamp_ns = 0;
+    for (int i = 0; i < 1000; ++i) {
+      stamp_ns += step(generator);
+      const Twist twist{stamp_ns, velocity(generator), velocity(generator), velocity(generator)};
+      filter.Add(twist.stamp_ns, twist.vx, twist.vy, twist.wz);
+      window.push_back(twist);
+      while (stamp_ns - window.front().stamp_ns > 100 * kMs || window.size() > capacity) {
+        window.pop_front();
+      }
+
+      ASSERT_EQ(filter.Size(), window.size()) << "capacity " << capacity << ", sample " << i;
+      double vx = 0.0, vy = 0.0, wz = 0.0;
+      for (const auto & sample : window) {
+        vx += sample.vx;
+        vy += sample.vy;
+        wz += sample.wz;
+      }
+      ExpectAverage(filter, vx / window.size(), vy / window.size(), wz / window.size());
+    }
+  }
+}
+
+TEST(TwistRingFilter, CapacityEdges)
+{
+  // A capacity of 0 holds one sample
+  TwistRingFilter filter(0, 100 * kMs);
+  filter.Add(0, 1.0, 2.0, 3.0);
+  filter.Add(1 * kMs, 4.0, 5.0, 6.0);
+  EXPECT_EQ(filter.Size(), 1u);
+  ExpectAverage(filter, 4.0, 5.0, 6.0);
+
+  // Clear in the middle of a wrapped ring starts over
+  TwistRingFilter ring(2, 100 * kMs);
+  for (int i = 0; i < 5; ++i) {
+    ring.Add(i * kMs, i, 0.0, 0.0);
+  }
+  ring.Clear();
+  EXPECT_EQ(ring.Size(), 0u);
+  ExpectAverage(ring, 0.0, 0.0, 0.0);
+  ring.Add(10 * kMs, 2.0, 0.0, 0.0);
+  ring.Add(11 * kMs, 4.0, 0.0, 0.0);
+  ring.Add(12 * kMs, 6.0, 0.0, 0.0);
+  EXPECT_EQ(ring.Size(), 2u);
+  ExpectAverage(ring, 5.0, 0.0, 0.0);
+}